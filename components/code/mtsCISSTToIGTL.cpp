@@ -18,6 +18,25 @@ http://www.cisst.org/cisst/license.txt.
 
 #include <sawOpenIGTLink/mtsCISSTToIGTL.h>
 
+#include <cisstVector/vctQuaternionRotation3.h>
+
+#include <algorithm>
+#include <limits>
+
+bool mtsIGTLEncodingFromString(const std::string & name,
+                               mtsIGTLEncoding & encoding)
+{
+    if (name == "float64") {
+        encoding = MTS_IGTL_FLOAT64;
+        return true;
+    }
+    if (name == "float32") {
+        encoding = MTS_IGTL_FLOAT32;
+        return true;
+    }
+    return false;
+}
+
 bool mtsCISSTToIGTL(const std::string & cisstData,
                     igtl::StringMessage::Pointer igtlData)
 {
@@ -81,6 +100,27 @@ bool mtsCISSTToIGTL(const prmPositionCartesianGet & cisstData,
     return false;
 }
 
+bool mtsCISSTToIGTL(const prmPositionCartesianGet & cisstData,
+                    igtl::PositionMessage::Pointer igtlData)
+{
+    if (!cisstData.Valid()) {
+        return false;
+    }
+    // rotation is assumed to be normalized
+    vctQuatRot3 quaternion;
+    quaternion.FromRaw(cisstData.Position().Rotation());
+    igtlData->SetPackType(igtl::PositionMessage::ALL);
+    igtlData->SetPosition(cisstData.Position().Translation().Element(0),
+                          cisstData.Position().Translation().Element(1),
+                          cisstData.Position().Translation().Element(2));
+    igtlData->SetQuaternion(quaternion.X(), quaternion.Y(), quaternion.Z(), quaternion.R());
+    igtl::TimeStamp::Pointer timeStamp;
+    timeStamp = igtl::TimeStamp::New();
+    timeStamp->SetTime(cisstData.Timestamp());
+    igtlData->SetTimeStamp(timeStamp);
+    return true;
+}
+
 bool mtsCISSTToIGTL(const prmVelocityCartesianGet & cisstData,
                     igtl::SensorMessage::Pointer igtlData)
 {
@@ -131,51 +171,65 @@ bool mtsCISSTToIGTL(const prmStateJoint & cisstData,
     return true;
 }
 
+// fill 6 rows for pos_flag/pos/vel_flag/vel/effort_flag/effort,
+// rows are contiguous in the igtl array (row major)
+template <typename _elementType>
+static void mtsCISSTToIGTLStateJointRows(const prmStateJoint & cisstData,
+                                         const size_t nbJoints,
+                                         _elementType * rows)
+{
+    const vctDoubleVec * vectors[3] = {&(cisstData.Position()),
+                                       &(cisstData.Velocity()),
+                                       &(cisstData.Effort())};
+    for (size_t index = 0; index < 3; ++index) {
+        _elementType * flag = rows + (2 * index) * nbJoints;
+        _elementType * values = flag + nbJoints;
+        const vctDoubleVec & vector = *(vectors[index]);
+        if (vector.size() != nbJoints) {
+            std::fill(flag, flag + nbJoints, static_cast<_elementType>(0.0));
+            std::fill(values, values + nbJoints, static_cast<_elementType>(0.0));
+        } else {
+            std::fill(flag, flag + nbJoints, static_cast<_elementType>(1.0));
+            for (size_t joint = 0; joint < nbJoints; ++joint) {
+                values[joint] = static_cast<_elementType>(vector.Element(joint));
+            }
+        }
+    }
+}
+
 bool mtsCISSTToIGTL(const prmStateJoint & cisstData,
                     igtl::NDArrayMessage::Pointer igtlData)
+{
+    return mtsCISSTToIGTL(cisstData, igtlData, MTS_IGTL_FLOAT64);
+}
+
+bool mtsCISSTToIGTL(const prmStateJoint & cisstData,
+                    igtl::NDArrayMessage::Pointer igtlData,
+                    const mtsIGTLEncoding encoding)
 {
     if (!cisstData.Valid()) {
         return false;
     }
     // determine number of joints for igtl
     igtlUint16 nbJoints = cisstData.Name().size();
-    // create 6 rows for pos_flag/pos/vel_flag/vel/effort_flag/effort
-    vctDoubleMat matrix(6, nbJoints);
-    if (nbJoints != 0) {
-        // position
-        if (cisstData.Position().size() == 0) {
-            matrix.Row(0).SetAll(0.0);
-            matrix.Row(1).SetAll(0.0);
-        } else {
-            matrix.Row(0).SetAll(1.0);
-            matrix.Row(1).Assign(cisstData.Position());
-        }
-        // velocity
-        if (cisstData.Velocity().size() == 0) {
-            matrix.Row(2).SetAll(0.0);
-            matrix.Row(3).SetAll(0.0);
-        } else {
-            matrix.Row(2).SetAll(1.0);
-            matrix.Row(3).Assign(cisstData.Velocity());
-        }
-        // effort
-        if (cisstData.Effort().size() == 0) {
-            matrix.Row(4).SetAll(0.0);
-            matrix.Row(5).SetAll(0.0);
-        } else {
-            matrix.Row(4).SetAll(1.0);
-            matrix.Row(5).Assign(cisstData.Effort());
-        }
-    }
-    // copy all matrix to array
+    // 6 rows for pos_flag/pos/vel_flag/vel/effort_flag/effort
     std::vector<igtlUint16> size(2);
     size[0] = 6;
     size[1] = nbJoints;
-    igtl::Array<igtl_float64> * array = new igtl::Array<igtl_float64>;
-    array->SetSize(size);
-    array->SetArray((void*) matrix.Pointer()); // this perform a deep copy
-    // assign array to message, message will delete array when done
-    igtlData->SetArray(igtl::NDArrayMessage::TYPE_FLOAT64, array);
+    // fill the igtl array directly, message will delete array when done
+    if (encoding == MTS_IGTL_FLOAT32) {
+        igtl::Array<igtl_float32> * array = new igtl::Array<igtl_float32>;
+        array->SetSize(size);
+        mtsCISSTToIGTLStateJointRows(cisstData, nbJoints,
+                                     static_cast<igtl_float32 *>(array->GetRawArray()));
+        igtlData->SetArray(igtl::NDArrayMessage::TYPE_FLOAT32, array);
+    } else {
+        igtl::Array<igtl_float64> * array = new igtl::Array<igtl_float64>;
+        array->SetSize(size);
+        mtsCISSTToIGTLStateJointRows(cisstData, nbJoints,
+                                     static_cast<igtl_float64 *>(array->GetRawArray()));
+        igtlData->SetArray(igtl::NDArrayMessage::TYPE_FLOAT64, array);
+    }
     igtl::TimeStamp::Pointer timeStamp;
     timeStamp = igtl::TimeStamp::New();
     timeStamp->SetTime(cisstData.Timestamp());
@@ -183,6 +237,127 @@ bool mtsCISSTToIGTL(const prmStateJoint & cisstData,
     return true;
 }
 
+// write count times the same value in network byte order
+static unsigned char * mtsIGTLWriteFill(unsigned char * body, const double value,
+                                        const size_t count, const bool float32)
+{
+    if (count == 0) {
+        return body;
+    }
+    unsigned char * first = body;
+    body = float32 ?
+        mtsIGTLPackedMessage::WriteFloat32(body, static_cast<float>(value))
+        : mtsIGTLPackedMessage::WriteFloat64(body, value);
+    const size_t elementSize = body - first;
+    for (size_t index = 1; index < count; ++index, body += elementSize) {
+        memcpy(body, first, elementSize);
+    }
+    return body;
+}
+
+bool mtsCISSTToIGTL(const prmStateJoint & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding encoding)
+{
+    if (!cisstData.Valid()) {
+        return false;
+    }
+    const size_t nbJoints = cisstData.Name().size();
+    if (nbJoints > 0xFFFF) {
+        return false;
+    }
+    const bool float32 = (encoding == MTS_IGTL_FLOAT32);
+    const size_t elementSize = float32 ? 4 : 8;
+    // same layout as igtl::NDArrayMessage version, 6 rows for
+    // pos_flag/pos/vel_flag/vel/effort_flag/effort
+    unsigned char * body = igtlData.AllocateBody(1 + 1 + 2 * 2
+                                                 + 6 * nbJoints * elementSize);
+    body = mtsIGTLPackedMessage::WriteUint8(body, float32 ?
+                                            igtl::NDArrayMessage::TYPE_FLOAT32
+                                            : igtl::NDArrayMessage::TYPE_FLOAT64);
+    body = mtsIGTLPackedMessage::WriteUint8(body, 2);
+    body = mtsIGTLPackedMessage::WriteUint16(body, 6);
+    body = mtsIGTLPackedMessage::WriteUint16(body, nbJoints);
+    const vctDoubleVec * vectors[3] = {&(cisstData.Position()),
+                                       &(cisstData.Velocity()),
+                                       &(cisstData.Effort())};
+    for (size_t index = 0; index < 3; ++index) {
+        const vctDoubleVec & vector = *(vectors[index]);
+        if (vector.size() != nbJoints) {
+            body = mtsIGTLWriteFill(body, 0.0, 2 * nbJoints, float32);
+        } else {
+            body = mtsIGTLWriteFill(body, 1.0, nbJoints, float32);
+            body = float32 ?
+                mtsIGTLPackedMessage::WriteFloat32Array(body, vector.Pointer(), nbJoints)
+                : mtsIGTLPackedMessage::WriteFloat64Array(body, vector.Pointer(), nbJoints);
+        }
+    }
+    igtlData.SetDeviceType("NDARRAY");
+    igtlData.SetTimeStamp(cisstData.Timestamp());
+    return true;
+}
+
+template <typename _matrixType>
+static bool mtsCISSTToIGTLMatrix(const _matrixType & cisstData,
+                                 mtsIGTLPackedMessage & igtlData,
+                                 const mtsIGTLEncoding encoding)
+{
+    const size_t rows = cisstData.rows();
+    const size_t cols = cisstData.cols();
+    // NDARRAY sizes are 16 bits
+    if ((rows > 0xFFFF) || (cols > 0xFFFF)) {
+        return false;
+    }
+    const bool float32 = (encoding == MTS_IGTL_FLOAT32);
+    const size_t elementSize = float32 ? 4 : 8;
+    // type, dimension, 2 sizes and data
+    unsigned char * body = igtlData.AllocateBody(1 + 1 + 2 * 2
+                                                 + rows * cols * elementSize);
+    body = mtsIGTLPackedMessage::WriteUint8(body, float32 ?
+                                            igtl::NDArrayMessage::TYPE_FLOAT32
+                                            : igtl::NDArrayMessage::TYPE_FLOAT64);
+    body = mtsIGTLPackedMessage::WriteUint8(body, 2);
+    body = mtsIGTLPackedMessage::WriteUint16(body, rows);
+    body = mtsIGTLPackedMessage::WriteUint16(body, cols);
+    // use strides so we support both row and column major
+    const double * data = cisstData.Pointer();
+    const ptrdiff_t rowStride = cisstData.row_stride();
+    const ptrdiff_t colStride = cisstData.col_stride();
+    for (size_t row = 0; row < rows; ++row) {
+        const double * element = data + row * rowStride;
+        if (colStride == 1) {
+            // row major, whole row is contiguous
+            body = float32 ?
+                mtsIGTLPackedMessage::WriteFloat32Array(body, element, cols)
+                : mtsIGTLPackedMessage::WriteFloat64Array(body, element, cols);
+        } else if (float32) {
+            for (size_t col = 0; col < cols; ++col, element += colStride) {
+                body = mtsIGTLPackedMessage::WriteFloat32(body, static_cast<float>(*element));
+            }
+        } else {
+            for (size_t col = 0; col < cols; ++col, element += colStride) {
+                body = mtsIGTLPackedMessage::WriteFloat64(body, *element);
+            }
+        }
+    }
+    igtlData.SetDeviceType("NDARRAY");
+    return true;
+}
+
+bool mtsCISSTToIGTL(const vctDoubleMat & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding encoding)
+{
+    return mtsCISSTToIGTLMatrix(cisstData, igtlData, encoding);
+}
+
+bool mtsCISSTToIGTL(const vctDynamicConstMatrixRef<double> & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding encoding)
+{
+    return mtsCISSTToIGTLMatrix(cisstData, igtlData, encoding);
+}
+
 bool mtsCISSTToIGTL(const prmEventButton & cisstData,
                     igtl::SensorMessage::Pointer igtlData)
 {
@@ -204,11 +379,171 @@ bool mtsCISSTToIGTL(const prmEventButton & cisstData,
     return true;
 }
 
+// senders re-use the same message, point elements are only created
+// when the number of points changes
+static bool mtsCISSTToIGTLPointElements(const size_t nbPoints,
+                                        igtl::PointMessage::Pointer igtlData)
+{
+    if (igtlData->GetNumberOfPointElement() == static_cast<int>(nbPoints)) {
+        return true;
+    }
+    igtlData->ClearPointElement();
+    igtl::PointElement::Pointer p;
+    for (size_t index = 0; index < nbPoints; ++index) {
+        p = igtl::PointElement::New();
+        p->SetRGBA(0xFF, 0xFF, 0xFF, 0xFF);
+        igtlData->AddPointElement(p);
+    }
+    return true;
+}
+
 bool mtsCISSTToIGTL(const vct3 &cisstData, igtl::PointMessage::Pointer igtlData)
 {
+    mtsCISSTToIGTLPointElements(1, igtlData);
+    igtl::PointElement::Pointer p;
+    igtlData->GetPointElement(0, p);
+    p->SetPosition(cisstData.X(), cisstData.Y(), cisstData.Z());
+    return true;
+}
+
+bool mtsCISSTToIGTL(const vctDoubleMat & cisstData,
+                    igtl::PointMessage::Pointer igtlData)
+{
+    // one point per row
+    if (cisstData.cols() != 3) {
+        return false;
+    }
+    const size_t nbPoints = cisstData.rows();
+    mtsCISSTToIGTLPointElements(nbPoints, igtlData);
     igtl::PointElement::Pointer p;
-    p = igtl::PointElement::New();
-    p->SetPosition(cisstData.X(),cisstData.Y(),cisstData.Z());
-    igtlData->AddPointElement(p);
+    for (size_t index = 0; index < nbPoints; ++index) {
+        igtlData->GetPointElement(static_cast<int>(index), p);
+        p->SetPosition(cisstData.Element(index, 0),
+                       cisstData.Element(index, 1),
+                       cisstData.Element(index, 2));
+    }
+    return true;
+}
+
+// layout of each POINT element: name[64], group[32], rgba[4],
+// position[3] float32, radius float32, owner[20]
+static const size_t mtsIGTLPointElementSize = 136;
+static const size_t mtsIGTLPointRGBAOffset = 96;
+static const size_t mtsIGTLPointPositionOffset = 100;
+
+template <typename _pointsType>
+static bool mtsCISSTToIGTLPoints(const _pointsType & cisstData,
+                                 mtsIGTLPackedMessage & igtlData)
+{
+    const size_t nbPoints = cisstData.size();
+    const size_t bodySize = nbPoints * mtsIGTLPointElementSize;
+    const bool reuseElements = ((igtlData.GetDeviceType() == "POINT")
+                                && (igtlData.GetPackBodySize() == bodySize));
+    unsigned char * body = igtlData.AllocateBody(bodySize);
+    if (!reuseElements) {
+        // unnamed, white points with radius 0
+        memset(body, 0, bodySize);
+        for (size_t index = 0; index < nbPoints; ++index) {
+            memset(body + index * mtsIGTLPointElementSize + mtsIGTLPointRGBAOffset,
+                   0xFF, 4);
+        }
+        igtlData.SetDeviceType("POINT");
+    }
+    // only update positions
+    for (size_t index = 0; index < nbPoints; ++index) {
+        unsigned char * position = body + index * mtsIGTLPointElementSize
+            + mtsIGTLPointPositionOffset;
+        const vct3 & point = cisstData[index];
+        position = mtsIGTLPackedMessage::WriteFloat32(position, static_cast<float>(point.X()));
+        position = mtsIGTLPackedMessage::WriteFloat32(position, static_cast<float>(point.Y()));
+        mtsIGTLPackedMessage::WriteFloat32(position, static_cast<float>(point.Z()));
+    }
+    return true;
+}
+
+bool mtsCISSTToIGTL(const std::vector<vct3> & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding)
+{
+    return mtsCISSTToIGTLPoints(cisstData, igtlData);
+}
+
+bool mtsCISSTToIGTL(const vctDynamicVector<vct3> & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding)
+{
+    return mtsCISSTToIGTLPoints(cisstData, igtlData);
+}
+
+static void mtsCISSTToIGTLSampleAppend(const vctDoubleVec & vector,
+                                       const size_t nbJoints,
+                                       std::vector<double> & values)
+{
+    const size_t size = std::min(vector.size(), nbJoints);
+    values.insert(values.end(), vector.Pointer(), vector.Pointer() + size);
+    values.insert(values.end(), nbJoints - size,
+                  std::numeric_limits<double>::quiet_NaN());
+}
+
+bool mtsCISSTToIGTLSample(const prmStateJoint & cisstData,
+                          std::vector<double> & values)
+{
+    if (!cisstData.Valid()) {
+        return false;
+    }
+    // fixed number of columns so rows of a history block line up
+    size_t nbJoints = cisstData.Name().size();
+    if (nbJoints == 0) {
+        nbJoints = std::max(cisstData.Position().size(),
+                            std::max(cisstData.Velocity().size(),
+                                     cisstData.Effort().size()));
+    }
+    values.clear();
+    mtsCISSTToIGTLSampleAppend(cisstData.Position(), nbJoints, values);
+    mtsCISSTToIGTLSampleAppend(cisstData.Velocity(), nbJoints, values);
+    mtsCISSTToIGTLSampleAppend(cisstData.Effort(), nbJoints, values);
+    return true;
+}
+
+bool mtsCISSTToIGTLSample(const prmPositionCartesianGet & cisstData,
+                          std::vector<double> & values)
+{
+    if (!cisstData.Valid()) {
+        return false;
+    }
+    values.resize(12);
+    for (size_t index = 0; index < 3; ++index) {
+        values[index] = cisstData.Position().Translation().Element(index);
+    }
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t col = 0; col < 3; ++col) {
+            values[3 + row * 3 + col] = cisstData.Position().Rotation().Element(row, col);
+        }
+    }
+    return true;
+}
+
+bool mtsCISSTToIGTLSample(const prmVelocityCartesianGet & cisstData,
+                          std::vector<double> & values)
+{
+    if (!cisstData.Valid()) {
+        return false;
+    }
+    values.resize(6);
+    for (size_t index = 0; index < 3; ++index) {
+        values[index] = cisstData.VelocityLinear().Element(index);
+        values[index + 3] = cisstData.VelocityAngular().Element(index);
+    }
+    return true;
+}
+
+bool mtsCISSTToIGTLSample(const prmForceCartesianGet & cisstData,
+                          std::vector<double> & values)
+{
+    if (!cisstData.Valid()) {
+        return false;
+    }
+    values.assign(cisstData.Force().Pointer(),
+                  cisstData.Force().Pointer() + 6);
     return true;
 }
@@ -19,36 +19,628 @@ http://www.cisst.org/cisst/license.txt.
 #include <sawOpenIGTLink/mtsIGTLBridge.h>
 #include <sawOpenIGTLink/mtsCISSTToIGTL.h>
 #include <sawOpenIGTLink/mtsIGTLToCISST.h>
+#include <sawOpenIGTLink/mtsIGTLReceiveBuffer.h>
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
 
 #include <cisstMultiTask/mtsManagerLocal.h>
+#include <cisstMultiTask/mtsInterfaceProvided.h>
 
-#include <igtlServerSocket.h>
 #include <igtlTimeStamp.h>
 #include <igtlMessageBase.h>
 
+#if SAW_OPENIGTLINK_HAS_IO_URING
+#include "mtsIGTLUring.h"
+#endif
+
+#if (CISST_OS == CISST_WINDOWS)
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#include <sawOpenIGTLink/mtsIGTLSharedMemory.h>
+#endif
+
 CMN_IMPLEMENT_SERVICES_DERIVED_ONEARG(mtsIGTLBridge, mtsTaskPeriodic, mtsTaskPeriodicConstructorArg);
 
+// messages larger than this are considered corrupted
+static const size_t mtsIGTLMaximumBodySize = 256 * 1024 * 1024;
+
+// messages parsed per client in each pass of the receive loop, clients
+// take turns even without budget
+static const size_t mtsIGTLReceivePassMessages = 16;
+
+// STRING messages sent by clients to select a profile by name
+static const std::string mtsIGTLClientProfileDevice = "CLIENT";
+
+// packed messages marked as state by the sender can be replaced by a
+// newer one while queued, STRING messages are events and never are
+static bool mtsIGTLIsState(const unsigned char * data, const bool state)
+{
+    static const char stringType[mtsIGTLPackedMessage::TYPE_SIZE] = "STRING";
+    return state
+        && (memcmp(data + mtsIGTLPackedMessage::TYPE_OFFSET, stringType,
+                   mtsIGTLPackedMessage::TYPE_SIZE) != 0);
+}
+
 class mtsIGTLBridgeData {
 public:
-    igtl::ServerSocket::Pointer mServerSocket;
-    typedef std::list<igtl::ClientSocket::Pointer> SocketsType;
-    SocketsType mSockets;
+    class Client {
+    public:
+        //! Owned by the bridge, deleted when the client is removed
+        mtsIGTLConnection * Connection = nullptr;
+        //! Connection name, used for logs and traces
+        std::string Name;
+        //! Unique id, starts at 1
+        unsigned int Id = 0;
+        //! All sends are queued, used by the io_uring backend
+        bool QueueOnly = false;
+        //! Can't wake up the bridge, the receive loop doesn't wait
+        bool Polled = false;
+        //! Set by the send worker, the client is removed by the bridge thread
+        bool Lost = false;
+        //! Send worker is writing to this client, see mtsIGTLBridgeData::SendLock
+        bool Sending = false;
+
+        //! Data received and not yet parsed, partial messages
+        mtsIGTLReceiveBuffer Buffer;
+
+        /*! Messages not fully sent yet, Offset is the number of bytes
+          already sent.  Frames for state not started can be replaced
+          by a newer message for the same device, see
+          mtsIGTLBridge::SendBytes. */
+        class Frame {
+        public:
+            std::vector<unsigned char> Data;
+            size_t Offset = 0;
+            std::string DeviceName;
+            bool State = false;
+        };
+        typedef std::list<Frame> FramesType;
+        FramesType SendQueue;
+        size_t SendQueueSize = 0;
+        size_t SendDropped = 0;
+
+        /*! Frames sent, shared by all clients so buffers are reused
+          instead of allocated for each message queued.  The memory
+          kept is bounded by MaxCapacity, frames past it are freed.
+          The send worker and the bridge thread can use the pool for
+          different clients at the same time. */
+        class FramePool {
+        public:
+            FramesType Frames;
+            size_t Capacity = 0;
+            size_t MaxCapacity = 0;
+            std::mutex Mutex;
+
+            //! Move frame from queue to pool
+            void Recycle(FramesType & queue, FramesType::iterator frame) {
+                std::lock_guard<std::mutex> lock(Mutex);
+                const size_t capacity = frame->Data.capacity();
+                if (Capacity + capacity > MaxCapacity) {
+                    queue.erase(frame);
+                    return;
+                }
+                frame->Offset = 0;
+                Capacity += capacity;
+                Frames.splice(Frames.end(), queue, frame);
+            }
+
+            //! Move frame from pool to queue, new frame if pool is empty
+            FramesType::iterator Take(FramesType & queue, FramesType::iterator position) {
+                std::lock_guard<std::mutex> lock(Mutex);
+                if (Frames.empty()) {
+                    return queue.insert(position, Frame());
+                }
+                FramesType::iterator frame = Frames.begin();
+                Capacity -= frame->Data.capacity();
+                queue.splice(position, Frames, frame);
+                return frame;
+            }
+
+            //! Pre-allocate frames, buffers grow on first use
+            void Reserve(const size_t nbFrames) {
+                while (Frames.size() < nbFrames) {
+                    Frames.emplace_back();
+                }
+            }
+        };
+        //! Set by mtsIGTLBridge::AddClient
+        FramePool * Pool = nullptr;
+
+        //! Remove first frame of the queue, fully sent
+        void PopFrame(void) {
+            SendQueueSize -= SendQueue.front().Data.size();
+            Pool->Recycle(SendQueue, SendQueue.begin());
+        }
+
+        //! See mtsIGTLBridge::AddClientProfile, all devices are sent if null
+        const mtsIGTLBridge::ClientProfile * Profile = nullptr;
+        //! Filter result for each device name, cleared when the profile changes
+        std::map<std::string, bool> Accepted;
+
+        void SetProfile(const mtsIGTLBridge::ClientProfile * profile) {
+            Profile = profile;
+            Accepted.clear();
+        }
+
+        //! True if the device matches the profile, patterns are matched once per device
+        bool Accepts(const std::string & deviceName) {
+            if (!Profile) {
+                return true;
+            }
+            auto accepted = Accepted.find(deviceName);
+            if (accepted == Accepted.end()) {
+                bool match = false;
+                for (auto & pattern : Profile->Devices) {
+                    if (mtsIGTLBridge::MatchPattern(pattern, deviceName)) {
+                        match = true;
+                        break;
+                    }
+                }
+                accepted = Accepted.insert(std::make_pair(deviceName, match)).first;
+            }
+            return accepted->second;
+        }
+
+        /*! Send now if possible, queue otherwise (see mtsIGTLBridge::Send).
+          Messages filtered by the client profile are ignored.  Returns
+          false if the connection is lost. */
+        bool Send(const unsigned char * data, const size_t size,
+                  const std::string & deviceName, const bool state,
+                  const size_t chunkSize, const size_t maxQueueSize) {
+            if (!Accepts(deviceName)) {
+                return true;
+            }
+            // previous messages pending, queue to preserve order
+            if (!SendQueue.empty() || QueueOnly) {
+                if (SendQueueSize + size > maxQueueSize) {
+                    ++SendDropped;
+                } else {
+                    Enqueue(data, size, 0, deviceName, state, chunkSize);
+                }
+                return true;
+            }
+            // try to send now, at most one chunk
+            const long long sent = Connection->Send(data, std::min(size, chunkSize));
+            if (sent < 0) {
+                return false;
+            }
+            // remaining will be sent by mtsIGTLBridge::SendQueued
+            if (static_cast<size_t>(sent) < size) {
+                Enqueue(data, size, static_cast<size_t>(sent), deviceName, state, chunkSize);
+            }
+            return true;
+        }
+
+        //! Add frame to send queue
+        void Enqueue(const unsigned char * data, const size_t size, const size_t offset,
+                     const std::string & deviceName, const bool state,
+                     const size_t chunkSize) {
+            // replace older state for the same device not yet started,
+            // other messages (e.g. events) are all sent
+            if (state) {
+                for (auto & frame : SendQueue) {
+                    if (frame.State && (frame.Offset == 0) && (frame.DeviceName == deviceName)) {
+                        SendQueueSize -= frame.Data.size();
+                        frame.Data.assign(data, data + size);
+                        SendQueueSize += size;
+                        return;
+                    }
+                }
+            }
+            // small messages go before large messages not yet started
+            auto position = SendQueue.end();
+            if (size <= chunkSize) {
+                for (auto iter = SendQueue.begin(); iter != SendQueue.end(); ++iter) {
+                    if ((iter->Offset == 0) && (iter->Data.size() > chunkSize)) {
+                        position = iter;
+                        break;
+                    }
+                }
+            }
+            auto frame = Pool->Take(SendQueue, position);
+            frame->Data.assign(data, data + size);
+            frame->Offset = offset;
+            frame->DeviceName = deviceName;
+            frame->State = state;
+            SendQueueSize += size;
+        }
+
+        //! Messages and bytes received during current cycle
+        size_t CycleMessages = 0;
+        size_t CycleBytes = 0;
+
+        //! Inbound quota state per device, see mtsIGTLBridge::AddReceiveQuota
+        class Quota {
+        public:
+            //! Messages per second, 0 if no quota applies
+            double Rate = 0.0;
+            double WindowStart = 0.0;
+            size_t Count = 0;
+            size_t Dropped = 0;
+        };
+        std::map<std::string, Quota> Quotas;
+        size_t Dropped = 0;
+
+        /*! Check quota for device and count message, returns false if
+          the message should be dropped.  Quota rule is found on first
+          message for each device. */
+        bool QuotaAllows(const std::string & deviceName, const double & now,
+                         const mtsIGTLBridge::ReceiveQuotasType & rules) {
+            auto quota = Quotas.find(deviceName);
+            if (quota == Quotas.end()) {
+                Quota newQuota;
+                for (auto & rule : rules) {
+                    if (mtsIGTLBridge::MatchPattern(rule.Client, Name)
+                        && mtsIGTLBridge::MatchPattern(rule.Device, deviceName)) {
+                        newQuota.Rate = rule.Rate;
+                        break;
+                    }
+                }
+                newQuota.WindowStart = now;
+                quota = Quotas.insert(std::make_pair(deviceName, newQuota)).first;
+            }
+            Quota & q = quota->second;
+            if (q.Rate <= 0.0) {
+                return true;
+            }
+            // one second window
+            if (now - q.WindowStart >= 1.0) {
+                q.WindowStart = now;
+                q.Count = 0;
+            }
+            ++q.Count;
+            if (static_cast<double>(q.Count) > q.Rate) {
+                ++q.Dropped;
+                ++Dropped;
+                return false;
+            }
+            return true;
+        }
+    };
+
+    //! All listeners, TCP and Unix domain socket are also kept to be replaced
+    std::list<mtsIGTLListener *> mListeners;
+    mtsIGTLListener * mTCPListener = nullptr;
+    mtsIGTLListener * mUnixListener = nullptr;
+
+    //! Replace current listener (can be null) by new one
+    void ReplaceListener(mtsIGTLListener * & current, mtsIGTLListener * listener) {
+        if (current) {
+            mListeners.remove(current);
+            delete current;
+        }
+        current = listener;
+        mListeners.push_back(listener);
+    }
+
+    typedef std::list<Client> ClientsType;
+    ClientsType mClients;
+    Client::FramePool mFramePool;
+
+    //! Signaled by triggers, see mtsIGTLTrigger
+    mtsIGTLWakeup mWakeup;
+
+    //! First client parsed in next receive pass, rotates
+    size_t mReceiveNext = 0;
+
+    /*! Clients written to by SendToClients and SendChunks.  Updated
+      by the bridge thread when clients are added or removed, by the
+      send worker for each pass when it runs, see SendLock. */
+    std::vector<Client *> mSendClients;
+    void UpdateSendClients(void) {
+        mSendClients.clear();
+        for (auto & client : mClients) {
+            if (!client.Lost) {
+                mSendClients.push_back(&client);
+            }
+        }
+    }
+
+    //! First client served by next SendChunks, resumes after the
+    //! client interrupted by the time slice
+    size_t mSendNext = 0;
+
+    //! Header of messages received, re-used for all messages
+    igtl::MessageHeader::Pointer mReceiveHeader = igtl::MessageHeader::New();
+
+    //! Last message sent for each device and type, see
+    //! mtsIGTLBridge::SetCache.  A device can send more than one
+    //! type (e.g. STRING and SENSOR).
+    typedef std::pair<std::string, std::string> CacheKey; // type, device
+    typedef std::map<CacheKey, std::vector<unsigned char> > CacheType;
+    CacheType mCache;
+
+    void UpdateCache(const unsigned char * data, const size_t size,
+                     const std::string & deviceName) {
+        if (size < mtsIGTLPackedMessage::HEADER_SIZE) {
+            return;
+        }
+        // type is in the header, after the version (2 bytes)
+        const char * type = reinterpret_cast<const char *>(data + 2);
+        std::vector<unsigned char> & entry
+            = mCache[CacheKey(std::string(type, strnlen(type, mtsIGTLPackedMessage::TYPE_SIZE)),
+                              deviceName)];
+        entry.assign(data, data + size);
+    }
+
+    /*! Send cached messages matching type and name to client, empty
+      type or name means all.  Returns false if the connection is
+      lost, found is set if at least one message matched. */
+    bool SendCached(Client & client,
+                    const std::string & deviceType,
+                    const std::string & deviceName,
+                    const size_t chunkSize, const size_t maxQueueSize,
+                    bool & found) {
+        found = false;
+        for (auto & entry : mCache) {
+            if ((deviceType.empty() || (entry.first.first == deviceType))
+                && (deviceName.empty() || (entry.first.second == deviceName))) {
+                found = true;
+                if (!client.Send(entry.second.data(), entry.second.size(),
+                                 entry.first.second, mtsIGTLIsState(entry.second.data(), true),
+                                 chunkSize, maxQueueSize)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    typedef std::list<mtsIGTLConnection *> RemovedType;
+    /*! Remove and delete clients.  With the send worker, waits until
+      it is done writing to them. */
+    void RemoveClients(const RemovedType & toBeRemoved) {
+        if (toBeRemoved.empty()) {
+            return;
+        }
+        auto lock = SendLock();
+        for (auto & connection : toBeRemoved) {
+            // a connection can be listed more than once
+            auto client = std::find_if(mClients.begin(), mClients.end(),
+                                       [connection](const Client & client) {
+                                           return client.Connection == connection;
+                                       });
+            if (client == mClients.end()) {
+                continue;
+            }
+            if (lock.owns_lock()) {
+                mSendIdle.wait(lock, [&client] { return !client->Sending; });
+            }
+#if SAW_OPENIGTLINK_HAS_IO_URING
+            // requests in flight complete once the socket is shut down
+            if (client->QueueOnly) {
+                connection->Shutdown();
+                mUring->Release(client->Id);
+            }
+#endif
+            while (!client->SendQueue.empty()) {
+                client->PopFrame();
+            }
+            mClients.erase(client);
+            delete connection;
+        }
+        // the worker updates its own list
+        if (!lock.owns_lock()) {
+            UpdateSendClients();
+        }
+    }
+
+    unsigned int mNextClientId = 1;
+
+    /*! Messages packed by the bridge thread during a cycle, sent by
+      the send worker (see mtsIGTLBridge::SetSendWorker).  If the
+      worker is still busy with the previous frame, a newer state
+      message replaces the older one for the same device if they have
+      the same size.  Events and STRING messages are all kept. */
+    class SendFrame {
+    public:
+        class Message {
+        public:
+            size_t Offset;
+            size_t Size;
+            std::string DeviceName;
+            bool State;
+        };
+        std::vector<unsigned char> Data;
+        std::vector<Message> Messages;
+
+        void Add(const unsigned char * data, const size_t size,
+                 const std::string & deviceName, const bool state) {
+            if (state) {
+                for (auto & message : Messages) {
+                    if (message.State && (message.DeviceName == deviceName)
+                        && (message.Size == size)) {
+                        memcpy(Data.data() + message.Offset, data, size);
+                        return;
+                    }
+                }
+            }
+            Messages.push_back({Data.size(), size, deviceName, state});
+            Data.insert(Data.end(), data, data + size);
+        }
+
+        //! Keeps allocated memory for next cycle
+        void Clear(void) {
+            Data.clear();
+            Messages.clear();
+        }
+    };
+
+    /*! Double buffering, the bridge thread fills one frame while the
+      worker sends the other one.  Frames are handed over using atomic
+      exchanges only, the condition variable is only used to let the
+      worker sleep when there is nothing to send. */
+    SendFrame mSendFrames[2];
+    SendFrame * mSendFilling = &(mSendFrames[0]);
+    //! Frame ready to be sent, bridge thread to worker
+    std::atomic<SendFrame *> mSendReady{nullptr};
+    //! Frame sent and cleared, worker to bridge thread
+    std::atomic<SendFrame *> mSendDone{&(mSendFrames[1])};
+    std::thread mSendWorker;
+    std::atomic<bool> mSendWorkerStop{false};
+    std::mutex mSendWakeMutex;
+    std::condition_variable mSendWake;
+
+    /*! Protects the list of clients while the send worker runs.  The
+      worker only holds the lock to copy the list and mark the
+      clients it writes to (Client::Sending), not while it writes.
+      Clients are only added and removed by the bridge thread. */
+    std::mutex mSendMutex;
+    //! Signaled by the worker when it is done writing to its clients
+    std::condition_variable mSendIdle;
+    //! If client is not null, also wait until the worker is done writing to it
+    inline std::unique_lock<std::mutex> SendLock(const Client * client = nullptr) {
+        if (!mSendWorker.joinable()) {
+            return std::unique_lock<std::mutex>();
+        }
+        std::unique_lock<std::mutex> lock(mSendMutex);
+        if (client) {
+            mSendIdle.wait(lock, [client] { return !client->Sending; });
+        }
+        return lock;
+    }
+
+    void WakeSendWorker(void) {
+        // lock so the worker can't miss the notification
+        { std::lock_guard<std::mutex> lock(mSendWakeMutex); }
+        mSendWake.notify_one();
+    }
+
+#if (CISST_OS != CISST_WINDOWS)
+    //! Messages are also published here for clients on the same host
+    mtsIGTLSharedMemoryWriter * mSharedMemory = nullptr;
+#endif
+
+#if SAW_OPENIGTLINK_HAS_IO_URING
+    mtsIGTLUring * mUring = nullptr;
+    std::vector<mtsIGTLUring::Completion> mCompletions;
+
+    /*! Queue receives for all clients and sends for clients without
+      send in flight, submit and process completions.  Data received
+      is copied in the client receive buffer.  Returns 0 or the
+      negative errno from mtsIGTLUring::SubmitAndWait. */
+    int ProcessUring(const int timeout, RemovedType & toBeRemoved) {
+        for (auto & client : mClients) {
+            // connections without descriptor are polled
+            if (!client.QueueOnly) {
+                continue;
+            }
+            const int descriptor = client.Connection->GetDescriptor();
+            mUring->Receive(client.Id, descriptor);
+            if (!client.SendQueue.empty() && !mUring->SendInFlight(client.Id)) {
+                // io_uring owns the data, the frame gets its previous buffer
+                Client::Frame & frame = client.SendQueue.front();
+                client.SendQueueSize -= frame.Data.size();
+                mUring->Send(client.Id, descriptor, frame.Data);
+                client.Pool->Recycle(client.SendQueue, client.SendQueue.begin());
+            }
+        }
+        if (mWakeup.GetDescriptor() >= 0) {
+            mUring->Poll(mWakeup.GetDescriptor());
+        }
+        const int result = mUring->SubmitAndWait(timeout, mCompletions);
+        if (result < 0) {
+            CMN_LOG_RUN_ERROR << "mtsIGTLBridge: io_uring submit failed: "
+                              << strerror(-result) << std::endl;
+        }
+        for (auto & completion : mCompletions) {
+            for (auto & client : mClients) {
+                if (client.Id != completion.Id) {
+                    continue;
+                }
+                if (completion.Result <= 0) {
+                    CMN_LOG_RUN_VERBOSE << "mtsIGTLBridge: lost connection with client at "
+                                        << client.Name << std::endl;
+                    toBeRemoved.push_back(client.Connection);
+                } else if (completion.Operation == mtsIGTLUring::RECEIVE) {
+                    client.Buffer.Write(completion.Data, static_cast<size_t>(completion.Result));
+                }
+                break;
+            }
+        }
+        return result;
+    }
+
+    //! True if some data is queued or in flight
+    bool UringSendPending(void) const {
+        for (auto & client : mClients) {
+            if (client.QueueOnly
+                && (!client.SendQueue.empty() || mUring->SendInFlight(client.Id))) {
+                return true;
+            }
+        }
+        return false;
+    }
+#endif
 };
 
+bool mtsIGTLCRCPolicyFromString(const std::string & name,
+                                mtsIGTLCRCPolicy & policy)
+{
+    if (name == "verify") {
+        policy = MTS_IGTL_CRC_VERIFY;
+        return true;
+    }
+    if (name == "verify-on-control-only") {
+        policy = MTS_IGTL_CRC_VERIFY_CONTROL;
+        return true;
+    }
+    if (name == "skip") {
+        policy = MTS_IGTL_CRC_SKIP;
+        return true;
+    }
+    return false;
+}
+
+bool mtsIGTLPriorityFromString(const std::string & name,
+                               mtsIGTLPriority & priority)
+{
+    if (name == "high") {
+        priority = MTS_IGTL_PRIORITY_HIGH;
+        return true;
+    }
+    if (name == "normal") {
+        priority = MTS_IGTL_PRIORITY_NORMAL;
+        return true;
+    }
+    if (name == "low") {
+        priority = MTS_IGTL_PRIORITY_LOW;
+        return true;
+    }
+    return false;
+}
+
 void mtsIGTLBridge::Init(void)
 {
     CMN_ASSERT(mData == nullptr);
     mData = new mtsIGTLBridgeData();
+
+    // interface to save traces on demand
+    mtsInterfaceProvided * interfaceProvided = AddInterfaceProvided("Trace");
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandWrite(&mtsIGTLBridge::SaveTrace, this, "save");
+    }
 }
 
 void mtsIGTLBridge::InitServer(void)
 {
-    mData->mServerSocket = igtl::ServerSocket::New();
-    const int result = mData->mServerSocket->CreateServer(mPort);
-    if (result < 0) {
+    mtsIGTLTCPListener * listener = new mtsIGTLTCPListener;
+    if (!listener->Create(mPort)) {
         CMN_LOG_CLASS_INIT_ERROR << "InitServer: can't create server socket on port "
                                  << mPort << std::endl;
     }
+    mData->ReplaceListener(mData->mTCPListener, listener);
+}
+
+void mtsIGTLBridge::AddListener(mtsIGTLListener * listener)
+{
+    mData->mListeners.push_back(listener);
 }
 
 void mtsIGTLBridge::Configure(const std::string & jsonFile)
@@ -68,7 +660,9 @@ void mtsIGTLBridge::Configure(const std::string & jsonFile)
     mtsComponent::ConfigureJSON(jsonConfig);
     ConfigureJSON(jsonConfig);
 
-    InitServer();
+    if (mServer) {
+        InitServer();
+    }
 }
 
 void mtsIGTLBridge::ConfigureJSON(const Json::Value & jsonConfig)
@@ -81,186 +675,1221 @@ void mtsIGTLBridge::ConfigureJSON(const Json::Value & jsonConfig)
     } else {
         CMN_LOG_CLASS_INIT_VERBOSE << "Configure: OpenIGTLink port is not defined, using default: " << mPort << std::endl;
     }
+
+    // optional tracing, "size" is the number of events kept
+    const Json::Value jsonTrace = jsonConfig["trace"];
+    if (!jsonTrace.empty()) {
+        jsonValue = jsonTrace["size"];
+        if (!jsonValue.empty()) {
+            mTrace.SetSize(jsonValue.asUInt());
+        } else {
+            mTrace.SetSize(100000);
+        }
+        jsonValue = jsonTrace["file"];
+        if (!jsonValue.empty()) {
+            mTraceFile = jsonValue.asString();
+        }
+        CMN_LOG_CLASS_INIT_VERBOSE << "Configure: tracing enabled" << std::endl;
+    }
+
+    // default encoding for floating point arrays, float32 halves the payload
+    jsonValue = jsonConfig["encoding"];
+    if (!jsonValue.empty()) {
+        if (!mtsIGTLEncodingFromString(jsonValue.asString(), mEncoding)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: \"encoding\" must be \"float64\" or \"float32\", found \""
+                                     << jsonValue.asString() << "\"" << std::endl;
+        }
+    }
+
+    // CRC verification for messages received
+    jsonValue = jsonConfig["crc"];
+    if (!jsonValue.empty()) {
+        if (!mtsIGTLCRCPolicyFromString(jsonValue.asString(), mCRCPolicy)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: \"crc\" must be \"verify\", \"verify-on-control-only\" or \"skip\", found \""
+                                     << jsonValue.asString() << "\"" << std::endl;
+        }
+    }
+
+    // optional time budget per cycle, in seconds
+    jsonValue = jsonConfig["budget"];
+    if (!jsonValue.empty()) {
+        SetCycleBudget(jsonValue.asDouble());
+    }
+
+    // receive budget per client and cycle, and inbound quotas
+    const Json::Value jsonReceive = jsonConfig["receive"];
+    if (!jsonReceive.empty()) {
+        jsonValue = jsonReceive["max-messages"];
+        if (!jsonValue.empty()) {
+            mReceiveMaxMessages = jsonValue.asUInt();
+        }
+        jsonValue = jsonReceive["max-bytes"];
+        if (!jsonValue.empty()) {
+            mReceiveMaxBytes = jsonValue.asUInt();
+        }
+        const Json::Value jsonQuotas = jsonReceive["quotas"];
+        for (unsigned int index = 0; index < jsonQuotas.size(); ++index) {
+            jsonValue = jsonQuotas[index]["rate"];
+            if (jsonValue.empty()) {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure: all \"quotas\" must define \"rate\"" << std::endl;
+                continue;
+            }
+            AddReceiveQuota(jsonQuotas[index].get("client", "*").asString(),
+                            jsonQuotas[index].get("device", "*").asString(),
+                            jsonValue.asDouble());
+        }
+    }
+
+    // last value cache, used for GET_ queries and new clients
+    const Json::Value jsonCache = jsonConfig["cache"];
+    if (!jsonCache.empty()) {
+        jsonValue = jsonCache["enabled"];
+        mCache = jsonValue.empty() ? true : jsonValue.asBool();
+        jsonValue = jsonCache["snapshot"];
+        if (!jsonValue.empty()) {
+            mCacheSnapshot = jsonValue.asBool();
+        }
+    }
+
+    // I/O backend, "socket" (default) or "io_uring" on Linux
+    const Json::Value jsonIO = jsonConfig["io"];
+    if (!jsonIO.empty()) {
+        const std::string backend = jsonIO.get("backend", "socket").asString();
+        if (backend == "io_uring") {
+#if SAW_OPENIGTLINK_HAS_IO_URING
+            mtsIGTLUring * uring = new mtsIGTLUring;
+            if (uring->Init(jsonIO.get("entries", 256).asUInt(),
+                            jsonIO.get("buffers", 32).asUInt(),
+                            jsonIO.get("buffer-size", 64 * 1024).asUInt(),
+                            jsonIO.get("zero-copy-threshold", 16 * 1024).asUInt())) {
+                mData->mUring = uring;
+                CMN_LOG_CLASS_INIT_VERBOSE << "Configure: using io_uring backend" << std::endl;
+            } else {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to initialize io_uring, using sockets" << std::endl;
+                delete uring;
+            }
+#else
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: io_uring backend not available, compile with sawOpenIGTLink_USE_IO_URING, using sockets" << std::endl;
+#endif
+        } else if (backend != "socket") {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: \"backend\" must be \"socket\" or \"io_uring\", found \""
+                                     << backend << "\"" << std::endl;
+        }
+    }
+
+    // client mode, "host:port" or "[IPv6]:port", no server unless a
+    // port is defined
+    jsonValue = jsonConfig["connect"];
+    if (!jsonValue.empty()) {
+        const std::string server = jsonValue.asString();
+        std::string host;
+        int port;
+        if (!mtsIGTLTCPConnector::ParseAddress(server, host, port)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: \"connect\" must be \"host:port\", found \""
+                                     << server << "\"" << std::endl;
+        } else {
+            ConnectToServer(host, port);
+            mServer = !jsonConfig["port"].empty();
+        }
+    }
+
+    // Unix domain socket for clients on the same host
+    jsonValue = jsonConfig["unix-socket"];
+    if (!jsonValue.empty()) {
+        SetUnixSocket(jsonValue.asString());
+    }
+
+    // client profiles, device name patterns sent to each client
+    const Json::Value jsonClients = jsonConfig["clients"];
+    for (unsigned int index = 0; index < jsonClients.size(); ++index) {
+        jsonValue = jsonClients[index]["name"];
+        if (jsonValue.empty()) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: all \"clients\" must define \"name\"" << std::endl;
+            continue;
+        }
+        std::list<std::string> devices;
+        const Json::Value jsonDevices = jsonClients[index]["devices"];
+        for (unsigned int device = 0; device < jsonDevices.size(); ++device) {
+            devices.push_back(jsonDevices[device].asString());
+        }
+        AddClientProfile(jsonValue.asString(),
+                         jsonClients[index].get("address", "").asString(),
+                         devices);
+    }
+
+    // shared memory for clients on the same host
+    const Json::Value jsonSharedMemory = jsonConfig["shared-memory"];
+    if (!jsonSharedMemory.empty()) {
+        // permissions as an octal string, e.g. "0660"
+        const std::string mode = jsonSharedMemory.get("mode", "0600").asString();
+        char * end = nullptr;
+        const unsigned long modeValue = strtoul(mode.c_str(), &end, 8);
+        if (mode.empty() || (*end != '\0') || (modeValue > 0777)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: \"shared-memory\" \"mode\" must be octal (e.g. \"0660\"), found \""
+                                     << mode << "\", shared memory not created" << std::endl;
+        } else {
+            SetSharedMemory(jsonSharedMemory.get("name", "/sawIGTL-" + this->GetName()).asString(),
+                            jsonSharedMemory.get("size", 4 * 1024 * 1024).asUInt(),
+                            static_cast<unsigned int>(modeValue));
+        }
+    }
+
+    // large messages are sent in chunks across cycles
+    const Json::Value jsonSend = jsonConfig["send"];
+    if (!jsonSend.empty()) {
+        jsonValue = jsonSend["chunk-size"];
+        if (!jsonValue.empty()) {
+            mSendChunkSize = jsonValue.asUInt();
+        }
+        jsonValue = jsonSend["time-slice"];
+        if (!jsonValue.empty()) {
+            mSendTimeSlice = jsonValue.asDouble();
+        }
+        jsonValue = jsonSend["max-queue-size"];
+        if (!jsonValue.empty()) {
+            mSendMaxQueueSize = jsonValue.asUInt();
+        }
+        jsonValue = jsonSend["worker"];
+        if (!jsonValue.empty()) {
+            SetSendWorker(jsonValue.asBool());
+        }
+    }
+
+    // priorities, device name patterns and priority, applied on
+    // Startup since senders and receivers are not yet created
+    const Json::Value jsonPriorities = jsonConfig["priorities"];
+    for (auto iter = jsonPriorities.begin(); iter != jsonPriorities.end(); ++iter) {
+        mtsIGTLPriority priority;
+        if (!mtsIGTLPriorityFromString((*iter).asString(), priority)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: priority must be \"high\", \"normal\" or \"low\", found \""
+                                     << (*iter).asString() << "\" for \"" << iter.name() << "\"" << std::endl;
+            continue;
+        }
+        mPriorities.push_back(std::make_pair(iter.name(), priority));
+    }
+
+    // receivers for state that can be coalesced, device name patterns
+    const Json::Value jsonCoalesce = jsonConfig["coalesce"];
+    for (Json::ArrayIndex index = 0; index < jsonCoalesce.size(); ++index) {
+        mCoalesced.push_back(jsonCoalesce[index].asString());
+    }
 }
 
 void mtsIGTLBridge::Startup(void)
 {
-    if (mPort == 0) {
+    if (mServer && (mPort == 0)) {
         SetPort(18944);
     }
+    for (auto & priority : mPriorities) {
+        if (!SetPriority(priority.first, priority.second)) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup: no sender nor receiver found for priority \""
+                                       << priority.first << "\"" << std::endl;
+        }
+    }
+    for (auto & pattern : mCoalesced) {
+        if (!SetCoalesced(pattern)) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup: no receiver found for coalesce \""
+                                       << pattern << "\"" << std::endl;
+        }
+    }
+#if SAW_OPENIGTLINK_HAS_IO_URING
+    // io_uring already sends asynchronously
+    if (mSendWorker && mData->mUring) {
+        CMN_LOG_CLASS_INIT_ERROR << "Startup: send worker can't be used with io_uring backend, ignored" << std::endl;
+        mSendWorker = false;
+    }
+#endif
+    // queued frames, about one per device per client once buffers grew
+    mData->mFramePool.MaxCapacity = mSendMaxQueueSize;
+    mData->mFramePool.Reserve(mSenders.size());
+
+    if (mSendWorker) {
+        mData->mSendWorkerStop = false;
+        mData->mSendWorker = std::thread(&mtsIGTLBridge::SendWorker, this);
+        CMN_LOG_CLASS_INIT_VERBOSE << "Startup: started send worker" << std::endl;
+    }
+}
+
+bool mtsIGTLBridge::SetPriority(const std::string & igtlDevicePattern,
+                                const mtsIGTLPriority priority)
+{
+    bool found = false;
+    for (auto & sender : mSenders) {
+        if (MatchPattern(igtlDevicePattern, sender->GetName())) {
+            sender->SetPriority(priority);
+            found = true;
+        }
+    }
+    for (auto & receiver : mReceivers) {
+        if (MatchPattern(igtlDevicePattern, receiver.first)) {
+            receiver.second->SetPriority(priority);
+            found = true;
+        }
+    }
+    mSendersByPriorityValid = false;
+    return found;
+}
+
+bool mtsIGTLBridge::SetCoalesced(const std::string & igtlDevicePattern,
+                                 const bool coalesced)
+{
+    bool found = false;
+    for (auto & receiver : mReceivers) {
+        if (MatchPattern(igtlDevicePattern, receiver.first)) {
+            receiver.second->SetCoalesced(coalesced);
+            found = true;
+        }
+    }
+    return found;
 }
 
 void mtsIGTLBridge::Cleanup(void)
 {
+    // stop send worker first, messages not sent yet are dropped
+    if (mData->mSendWorker.joinable()) {
+        mData->mSendWorkerStop = true;
+        mData->WakeSendWorker();
+        mData->mSendWorker.join();
+    }
+
     CMN_LOG_CLASS_INIT_VERBOSE << "Cleanup: closing hanging connections" << std::endl;
-    mData->mServerSocket->CloseSocket();
-    // iterate on all sockets
-    for (auto & socket : mData->mSockets) {
-        socket->CloseSocket();
-        socket->Delete();
+    mtsIGTLBridgeData::RemovedType toBeRemoved;
+    for (auto & client : mData->mClients) {
+        toBeRemoved.push_back(client.Connection);
+    }
+    mData->RemoveClients(toBeRemoved);
+    // also removes the Unix domain socket file
+    for (auto & listener : mData->mListeners) {
+        delete listener;
+    }
+    mData->mListeners.clear();
+    mData->mTCPListener = nullptr;
+    mData->mUnixListener = nullptr;
+
+#if (CISST_OS != CISST_WINDOWS)
+    // removes the shared memory segment
+    delete mData->mSharedMemory;
+    mData->mSharedMemory = nullptr;
+#endif
+
+    if (mTrace.Enabled() && !mTraceFile.empty()) {
+        SaveTrace(mTraceFile);
+    }
+}
+
+bool mtsIGTLBridge::ConnectToServer(const std::string & host, const int port)
+{
+    mtsIGTLTCPConnector * connector = new mtsIGTLTCPConnector;
+    // resolved again before each attempt
+    const bool resolved = connector->Create(host, port);
+    if (!resolved) {
+        CMN_LOG_CLASS_INIT_WARNING << "ConnectToServer: can't resolve \"" << host
+                                   << "\" yet, will keep trying" << std::endl;
+    }
+    AddListener(connector);
+    CMN_LOG_CLASS_INIT_VERBOSE << "ConnectToServer: connecting to " << host
+                               << ":" << port << std::endl;
+    return resolved;
+}
+
+bool mtsIGTLBridge::SetUnixSocket(const std::string & path)
+{
+#if (CISST_OS != CISST_WINDOWS)
+    mtsIGTLUnixListener * listener = new mtsIGTLUnixListener;
+    if (!listener->Create(path)) {
+        CMN_LOG_CLASS_INIT_ERROR << "SetUnixSocket: can't create Unix domain socket \""
+                                 << path << "\" (" << strerror(errno) << ")" << std::endl;
+        delete listener;
+        return false;
+    }
+    mData->ReplaceListener(mData->mUnixListener, listener);
+    CMN_LOG_CLASS_INIT_VERBOSE << "SetUnixSocket: listening on \"" << path << "\"" << std::endl;
+    return true;
+#else
+    CMN_LOG_CLASS_INIT_ERROR << "SetUnixSocket: Unix domain sockets are not supported on Windows, \""
+                             << path << "\" ignored" << std::endl;
+    return false;
+#endif
+}
+
+bool mtsIGTLBridge::SetSharedMemory(const std::string & name, const size_t size,
+                                    const unsigned int mode)
+{
+#if (CISST_OS != CISST_WINDOWS)
+    if (!mData->mSharedMemory) {
+        mData->mSharedMemory = new mtsIGTLSharedMemoryWriter;
+    }
+    if (!mData->mSharedMemory->Open(name, size, static_cast<mode_t>(mode))) {
+        CMN_LOG_CLASS_INIT_ERROR << "SetSharedMemory: failed to create shared memory \""
+                                 << name << "\" (" << size << " bytes)" << std::endl;
+        delete mData->mSharedMemory;
+        mData->mSharedMemory = nullptr;
+        return false;
+    }
+    CMN_LOG_CLASS_INIT_VERBOSE << "SetSharedMemory: publishing messages in \""
+                               << name << "\" (" << size << " bytes)" << std::endl;
+    return true;
+#else
+    CMN_LOG_CLASS_INIT_ERROR << "SetSharedMemory: shared memory is not supported on Windows, \""
+                             << name << "\" ignored (" << size << " bytes)" << std::endl;
+    return false;
+#endif
+}
+
+void mtsIGTLBridge::SaveTrace(const std::string & fileName)
+{
+    if (!mTrace.Enabled()) {
+        CMN_LOG_CLASS_RUN_WARNING << "SaveTrace: tracing is not enabled, see \"trace\" in configuration" << std::endl;
+        return;
+    }
+    if (mTrace.SaveChromeTrace(fileName, this->GetName())) {
+        CMN_LOG_CLASS_RUN_VERBOSE << "SaveTrace: saved trace in \"" << fileName << "\"" << std::endl;
+    } else {
+        CMN_LOG_CLASS_RUN_ERROR << "SaveTrace: failed to save trace in \"" << fileName << "\"" << std::endl;
+    }
+}
+
+void mtsIGTLBridge::AddClient(mtsIGTLConnection * connection)
+{
+    CMN_LOG_CLASS_RUN_VERBOSE << "AddClient: found new client from "
+                              << connection->GetName() << std::endl;
+    mtsIGTLBridgeData::Client client;
+    client.Connection = connection;
+    client.Name = connection->GetName();
+    client.Id = mData->mNextClientId++;
+    client.Pool = &(mData->mFramePool);
+    // profile based on address, can be changed by client
+    for (auto & profile : mClientProfiles) {
+        if (!profile.Address.empty() && MatchPattern(profile.Address, client.Name)) {
+            CMN_LOG_CLASS_RUN_VERBOSE << "AddClient: using profile \"" << profile.Name
+                                      << "\" for client at " << client.Name << std::endl;
+            client.SetProfile(&profile);
+            break;
+        }
+    }
+#if SAW_OPENIGTLINK_HAS_IO_URING
+    // connections without descriptor are polled
+    client.QueueOnly = (mData->mUring != nullptr) && (connection->GetDescriptor() >= 0);
+#endif
+    // connections without descriptor (e.g. memory) can signal the
+    // wakeup the receive loop already waits on
+    client.Polled = !client.QueueOnly
+        && !mtsIGTLConnection::Selectable(connection->GetDescriptor())
+        && !((mData->mWakeup.GetDescriptor() >= 0)
+             && connection->SetWakeup(&(mData->mWakeup)));
+    auto lock = mData->SendLock();
+    mData->mClients.push_back(client);
+    if (!lock.owns_lock()) {
+        mData->UpdateSendClients();
+    }
+    // new client gets the latest messages without waiting for senders,
+    // the worker doesn't see it until the lock is released
+    if (mCache && mCacheSnapshot) {
+        bool found;
+        if (!mData->SendCached(mData->mClients.back(), "", "",
+                               mSendChunkSize, mSendMaxQueueSize, found)) {
+            if (lock.owns_lock()) {
+                lock.unlock();
+            }
+            mData->RemoveClients(mtsIGTLBridgeData::RemovedType(1, connection));
+        }
     }
-    mData->mServerSocket->Delete();
 }
 
 void mtsIGTLBridge::Run(void)
 {
     // keep track of when we start to make sure we stop receive loop
     const double start = mtsComponentManager::GetInstance()->GetTimeServer().GetRelativeTime();
+    mCycleStart = osaGetTime();
+    const double traceStart = mTrace.Time();
+    double traceTime = traceStart;
 
     ProcessQueuedCommands();
+    traceTime = mTrace.Add("ProcessQueuedCommands", traceTime);
     ProcessQueuedEvents();
+    traceTime = mTrace.Add("ProcessQueuedEvents", traceTime);
 
-    // first see if we have any new client
-    igtl::ClientSocket::Pointer newSocket = mData->mServerSocket->WaitForConnection(1);
-    if (newSocket.IsNotNull()) {
-        // log some information and add to list
-        std::string address;
-        int port;
-        newSocket->GetSocketAddressAndPort(address, port);
-        CMN_LOG_CLASS_RUN_VERBOSE << "Run: found new client from "
-                                  << address << ":" << port << std::endl;
-        // set socket time out
-        newSocket->SetTimeout(10);
-        newSocket->SetSendBlocking(10);
-        // add new socket to the list
-        mData->mSockets.push_back(newSocket);
+    // new receive budget for all clients
+    for (auto & client : mData->mClients) {
+        client.CycleMessages = 0;
+        client.CycleBytes = 0;
     }
 
-    // update all senders
+    // clients lost by the send worker
+    if (mSendWorker) {
+        mtsIGTLBridgeData::RemovedType toBeRemoved;
+        {
+            auto lock = mData->SendLock();
+            for (auto & client : mData->mClients) {
+                if (client.Lost) {
+                    toBeRemoved.push_back(client.Connection);
+                }
+            }
+        }
+        mData->RemoveClients(toBeRemoved);
+    }
+
+    // commands deferred during last cycle since budget was used
+    for (auto & receiver : mReceivers) {
+        receiver.second->ExecutePending();
+    }
+
+    // first see if we have any new client, at most one per listener
+    for (auto & listener : mData->mListeners) {
+        mtsIGTLConnection * connection = listener->Accept();
+        if (connection) {
+            AddClient(connection);
+        }
+    }
+    traceTime = mTrace.Add("accept", traceTime);
+
+    // update all senders, poses are converted in a single batch
     SendAll();
+    SendPoses();
+    PublishSendFrame();
+    traceTime = mTrace.Add("SendAll", traceTime);
 
-    // update all receivers, loop as long as we have some time
+    // continue large transfers
+    mSendPending = SendQueued();
+    traceTime = mTrace.Add("SendQueued", traceTime);
+
+    // update all receivers, loop as long as we have some time, also
+    // check triggered senders and continue large transfers
     do {
         ReceiveAll();
+        if (!mTriggers.empty()) {
+            SendTriggered();
+        }
+        if (mSendPending) {
+            mSendPending = SendQueued();
+        }
     } while ((mtsComponentManager::GetInstance()->GetTimeServer().GetRelativeTime() - start) < this->Period);
+    mTrace.Add("ReceiveAll", traceTime);
+    mTrace.Add("Run", traceStart);
+}
+
+mtsComponent * mtsIGTLBridge::GetLocalComponent(const std::string & componentName)
+{
+    return mtsComponentManager::GetInstance()->GetComponent(componentName);
 }
 
 void mtsIGTLBridge::SendAll(void)
 {
-    // get data if we have any socket
-    if (mData->mSockets.empty()) {
+    // get data if we have any socket, or to keep the cache up to
+    // date for future clients
+    if (mData->mClients.empty() && !mCache) {
         return;
     }
 
-    for (auto & sender : mSenders) {
+    if (!mSendersByPriorityValid) {
+        UpdateSendersByPriority();
+    }
+
+    // high priority, always executed
+    for (auto & sender : mSendersByPriority[MTS_IGTL_PRIORITY_HIGH].Senders) {
         sender->Execute();
     }
+
+    // lower priorities, round robin within budget, start where we
+    // stopped last cycle so all senders eventually get executed
+    for (size_t priority = MTS_IGTL_PRIORITY_NORMAL;
+         priority < MTS_IGTL_PRIORITY_COUNT;
+         ++priority) {
+        PrioritySenders & senders = mSendersByPriority[priority];
+        const size_t nbSenders = senders.Senders.size();
+        for (size_t count = 0; count < nbSenders; ++count) {
+            if (!InBudget()) {
+                mTrace.Add("deferred", senders.Senders[senders.Next]->GetName(), mTrace.Time());
+                return;
+            }
+            senders.Senders[senders.Next]->Execute();
+            senders.Next = (senders.Next + 1) % nbSenders;
+        }
+    }
+}
+
+void mtsIGTLBridge::UpdateSendersByPriority(void)
+{
+    for (auto & senders : mSendersByPriority) {
+        senders.Senders.clear();
+        senders.Next = 0;
+    }
+    for (auto & sender : mSenders) {
+        if (!sender->IsTriggered()) {
+            mSendersByPriority[sender->GetPriority()].Senders.push_back(sender);
+        }
+    }
+    mSendersByPriorityValid = true;
+}
+
+void mtsIGTLBridge::SendTriggered(void)
+{
+    for (auto & trigger : mTriggers) {
+        // always check so we don't accumulate triggers while no client is connected
+        if (trigger->Check() && (!mData->mClients.empty() || mCache)) {
+            const double traceStart = mTrace.Time();
+            for (auto & sender : trigger->Senders) {
+                sender->Execute();
+            }
+            mTrace.Add("triggered", traceStart);
+        }
+    }
+    SendPoses();
+    PublishSendFrame();
+}
+
+void mtsIGTLBridge::QueuePose(mtsIGTLPoseSender * sender)
+{
+    // a sender executed twice before SendPoses only sends its latest pose
+    if (std::find(mPoseSenders.begin(), mPoseSenders.end(), sender) == mPoseSenders.end()) {
+        mPoseSenders.push_back(sender);
+    }
+}
+
+void mtsIGTLBridge::SendPoses(void)
+{
+    const size_t nbPoses = mPoseSenders.size();
+    if (nbPoses == 0) {
+        return;
+    }
+    double traceTime = mTrace.Time();
+    mPoseBatch.Resize(nbPoses);
+    mPoseBodies.resize(nbPoses);
+    for (size_t index = 0; index < nbPoses; ++index) {
+        mtsIGTLPoseSender * sender = mPoseSenders[index];
+        mPoseBatch.Set(index, sender->mCISSTData.Position());
+        mPoseBodies[index] = sender->mIGTLData.AllocateBody(mtsIGTLPoseBatch::BODY_SIZE);
+    }
+    mPoseBatch.PackTransforms(mPoseBodies.data());
+    traceTime = mTrace.Add("convert poses", traceTime);
+    for (auto & sender : mPoseSenders) {
+        sender->mIGTLData.SetTimeStamp(sender->mCISSTData.Timestamp());
+        sender->mIGTLData.Pack();
+        Send(&(sender->mIGTLData), true);
+    }
+    mTrace.Add("send poses", traceTime);
+    mPoseSenders.clear();
+}
+
+void mtsIGTLBridge::QueuePose(mtsIGTLPoseReceiver * receiver,
+                              mtsIGTLReceiveBuffer & buffer, const bool deferred)
+{
+    const size_t offset = mPoseReceived.size();
+    mPoseReceived.resize(offset + mtsIGTLPoseBatch::BODY_SIZE);
+    buffer.Read(mPoseReceived.data() + offset, mtsIGTLPoseBatch::BODY_SIZE);
+    mPoseReceivers.push_back(std::make_pair(receiver, deferred));
+}
+
+void mtsIGTLBridge::ReceivePoses(void)
+{
+    const size_t nbPoses = mPoseReceivers.size();
+    if (nbPoses == 0) {
+        return;
+    }
+    const double traceTime = mTrace.Time();
+    mPoseBatch.Resize(nbPoses);
+    mPoseBodies.resize(nbPoses);
+    for (size_t index = 0; index < nbPoses; ++index) {
+        mPoseBodies[index] = mPoseReceived.data() + index * mtsIGTLPoseBatch::BODY_SIZE;
+    }
+    mPoseBatch.UnpackTransforms(mPoseBodies.data());
+    mTrace.Add("convert poses", traceTime);
+    // execute in order received
+    for (size_t index = 0; index < nbPoses; ++index) {
+        mtsIGTLPoseReceiver * receiver = mPoseReceivers[index].first;
+        prmPositionCartesianSet & cisstData = receiver->mCISSTData;
+        mPoseBatch.Get(index, cisstData.Goal());
+        cisstData.Goal().Rotation().NormalizedSelf();
+        cisstData.SetValid(true);
+        receiver->ExecuteConverted(mPoseReceivers[index].second);
+    }
+    mPoseReceivers.clear();
+    mPoseReceived.clear();
+}
+
+bool mtsIGTLBridge::AddTrigger(const std::string & interfaceRequiredName,
+                               mtsIGTLTrigger * trigger)
+{
+    for (auto & sender : mSenders) {
+        if (sender->GetInterfaceRequiredName() == interfaceRequiredName) {
+            sender->SetTriggered(true);
+            trigger->Senders.push_back(sender);
+        }
+    }
+    if (trigger->Senders.empty()) {
+        CMN_LOG_CLASS_INIT_WARNING << "AddTrigger: no sender found for required interface \""
+                                   << interfaceRequiredName << "\"" << std::endl;
+    }
+    trigger->Wakeup = &(mData->mWakeup);
+    mTriggers.push_back(trigger);
+    mSendersByPriorityValid = false;
+    // no way to wake up the receive loop, reduce socket timeout so
+    // triggers are checked often
+    if (mData->mWakeup.GetDescriptor() < 0) {
+        mSocketTimeout = 1;
+    }
+    return true;
+}
+
+bool mtsIGTLBridge::AddTriggerFromEventVoid(const std::string & interfaceRequiredName,
+                                            const std::string & eventName)
+{
+    mtsInterfaceRequired * interfaceRequired = this->GetInterfaceRequired(interfaceRequiredName);
+    if (!interfaceRequired) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddTriggerFromEventVoid: unable to find required interface \""
+                                 << interfaceRequiredName << "\"" << std::endl;
+        return false;
+    }
+    mtsIGTLTrigger * trigger = new mtsIGTLTrigger;
+    // not queued, the handler only sets a flag checked by the bridge
+    if (!interfaceRequired->AddEventHandlerVoid(&mtsIGTLTrigger::EventHandler, trigger,
+                                                eventName, MTS_EVENT_NOT_QUEUED)) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddTriggerFromEventVoid: failed to add event \""
+                                 << eventName << "\" to required interface \""
+                                 << interfaceRequiredName << "\"" << std::endl;
+        delete trigger;
+        return false;
+    }
+    return AddTrigger(interfaceRequiredName, trigger);
+}
+
+bool mtsIGTLBridge::AddTriggerFromStateTable(const std::string & interfaceRequiredName,
+                                             const std::string & componentName,
+                                             const std::string & stateTableName)
+{
+    mtsTask * task = dynamic_cast<mtsTask *>(GetLocalComponent(componentName));
+    if (!task) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddTriggerFromStateTable: unable to find task \""
+                                 << componentName << "\"" << std::endl;
+        return false;
+    }
+    mtsStateTable * stateTable = stateTableName.empty() ?
+        task->GetDefaultStateTable() : task->GetStateTable(stateTableName);
+    if (!stateTable) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddTriggerFromStateTable: unable to find state table \""
+                                 << stateTableName << "\" for task \""
+                                 << componentName << "\"" << std::endl;
+        return false;
+    }
+    mtsIGTLTrigger * trigger = new mtsIGTLTrigger;
+    trigger->StateTable = stateTable;
+    // state tables don't signal new data, reduce socket timeout so
+    // the receive loop checks the state table often
+    mSocketTimeout = 1;
+    return AddTrigger(interfaceRequiredName, trigger);
 }
 
 void mtsIGTLBridge::ReceiveAll(void)
 {
-    typedef std::list<igtl::ClientSocket::Pointer> RemovedType;
-    RemovedType toBeRemoved;
+    if (mData->mClients.empty()) {
+        return;
+    }
 
-    // send to all clients of this server
-    for (auto & socket : mData->mSockets) {
-        igtl::MessageHeader::Pointer headerMsg;
-        headerMsg = igtl::MessageHeader::New();
-
-        // keep track of which client we can send to
-        bool timeout(false);
-        headerMsg->InitPack();
-        auto sendingClientActive =
-            socket->Receive(headerMsg->GetPackPointer(),
-                            headerMsg->GetPackSize(),
-                            timeout);
-        headerMsg->Unpack();
-
-        // process message if valid
-        if (sendingClientActive >= 1 && sendingClientActive == headerMsg->GetPackSize()) {
+    mtsIGTLBridgeData::RemovedType toBeRemoved;
+    igtl::MessageHeader::Pointer headerMsg = mData->mReceiveHeader;
+    const size_t headerSize = headerMsg->GetPackSize();
+
+    // don't wait for new data if a client still has a complete
+    // message buffered and budget left to parse it (e.g. over the
+    // per pass limit) or some connections are polled (can't be
+    // selected nor signal the wakeup).  Partial messages need more
+    // data and clients over budget wait for next cycle.
+    bool buffered = false;
+    unsigned char header[mtsIGTLPackedMessage::HEADER_SIZE];
+    for (auto & client : mData->mClients) {
+        if (client.Polled) {
+            buffered = true;
+            break;
+        }
+        if (((mReceiveMaxMessages != 0) && (client.CycleMessages >= mReceiveMaxMessages))
+            || ((mReceiveMaxBytes != 0) && (client.CycleBytes >= mReceiveMaxBytes))
+            || !client.Buffer.Peek(header, headerSize)) {
+            continue;
+        }
+        const unsigned long long bodySize = mtsIGTLPackedMessage::ReadUint64
+            (header + mtsIGTLPackedMessage::BODY_SIZE_OFFSET);
+        if ((bodySize > mtsIGTLMaximumBodySize)
+            || (client.Buffer.Size() >= headerSize + bodySize)) {
+            buffered = true;
+            break;
+        }
+    }
+    const int timeout = buffered ? 0 : mSocketTimeout;
+    const double traceStart = mTrace.Time();
+
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    int nbReady = 0;
+#if SAW_OPENIGTLINK_HAS_IO_URING
+    if (mData->mUring) {
+        mData->ProcessUring(timeout, toBeRemoved);
+        mTrace.Add("io_uring", traceStart);
+    } else
+#endif
+    {
+        // wait for any client to have new data or a trigger
+        int maxDescriptor = mData->mWakeup.GetDescriptor();
+        if (mtsIGTLConnection::Selectable(maxDescriptor)) {
+            FD_SET(maxDescriptor, &readSet);
+        }
+        for (auto & client : mData->mClients) {
+            const int descriptor = client.Connection->GetDescriptor();
+            if (mtsIGTLConnection::Selectable(descriptor)) {
+                FD_SET(descriptor, &readSet);
+                maxDescriptor = std::max(maxDescriptor, descriptor);
+            }
+        }
+        struct timeval timeoutSelect;
+        timeoutSelect.tv_sec = 0;
+        timeoutSelect.tv_usec = timeout * 1000;
+        nbReady = select(maxDescriptor + 1, &readSet, nullptr, nullptr, &timeoutSelect);
+    }
+    mData->mWakeup.Clear();
+
+    // read as much as possible in the client ring buffers
+    for (auto & client : mData->mClients) {
+        // io_uring already filled the buffer
+        if (client.QueueOnly) {
+            continue;
+        }
+        const int descriptor = client.Connection->GetDescriptor();
+        if (mtsIGTLConnection::Selectable(descriptor)
+            && ((nbReady <= 0) || !FD_ISSET(descriptor, &readSet))) {
+            continue;
+        }
+        size_t freeSize;
+        unsigned char * freePointer = client.Buffer.WritePointer(freeSize);
+        if (freeSize > 0) {
+            const long long nbBytes = client.Connection->Receive(freePointer, freeSize);
+            if (nbBytes < 0) {
+                CMN_LOG_CLASS_RUN_VERBOSE << "ReceiveAll: can't receive from client at "
+                                          << client.Name
+                                          << ", dropped " << client.Dropped
+                                          << " message(s) over quota" << std::endl;
+                toBeRemoved.push_back(client.Connection);
+                continue;
+            }
+            if (nbBytes > 0) {
+                client.Buffer.CommitWrite(static_cast<size_t>(nbBytes));
+                mTrace.Add("read", client.Name, traceStart);
+            }
+        }
+    }
+
+    // start with a different client on each pass
+    const size_t nbClients = mData->mClients.size();
+    auto clientIterator = mData->mClients.begin();
+    std::advance(clientIterator, mData->mReceiveNext % nbClients);
+    mData->mReceiveNext = (mData->mReceiveNext + 1) % nbClients;
+    for (size_t clientCount = 0; clientCount < nbClients; ++clientCount) {
+        mtsIGTLBridgeData::Client & client = *clientIterator;
+        if (++clientIterator == mData->mClients.end()) {
+            clientIterator = mData->mClients.begin();
+        }
+        mtsIGTLConnection * connection = client.Connection;
+        if (std::find(toBeRemoved.begin(), toBeRemoved.end(), connection) != toBeRemoved.end()) {
+            continue;
+        }
+
+        // parse complete messages, a few per pass so clients take
+        // turns, and up to the client budget for the cycle so a
+        // client flooding the bridge can't starve the others
+        size_t passMessages = 0;
+        while ((passMessages < mtsIGTLReceivePassMessages)
+               && ((mReceiveMaxMessages == 0) || (client.CycleMessages < mReceiveMaxMessages))
+               && ((mReceiveMaxBytes == 0) || (client.CycleBytes < mReceiveMaxBytes))) {
+            // wait for full header
+            if (client.Buffer.Size() < headerSize) {
+                break;
+            }
+            headerMsg->InitPack();
+            client.Buffer.Peek(headerMsg->GetPackPointer(), headerSize);
+            // body CRC from raw header, verified here based on policy
+            const unsigned long long crc = mtsIGTLPackedMessage::ReadUint64
+                (static_cast<const unsigned char *>(headerMsg->GetPackPointer())
+                 + mtsIGTLPackedMessage::CRC_OFFSET);
+            headerMsg->Unpack();
+            const size_t bodySize = headerMsg->GetBodySizeToRead();
+            if (bodySize > mtsIGTLMaximumBodySize) {
+                CMN_LOG_CLASS_RUN_ERROR << "ReceiveAll: invalid body size (" << bodySize
+                                        << ") from client at " << client.Name
+                                        << ", closing connection" << std::endl;
+                toBeRemoved.push_back(connection);
+                break;
+            }
+            // wait for full body, make sure the buffer is large enough
+            if (client.Buffer.Size() < headerSize + bodySize) {
+                client.Buffer.Reserve(headerSize + bodySize);
+                break;
+            }
+            client.Buffer.Skip(headerSize);
+
+            // process message
             const auto deviceName = headerMsg->GetDeviceName();
+            ++passMessages;
+            ++client.CycleMessages;
+            client.CycleBytes += headerSize + bodySize;
+            const std::string deviceType = headerMsg->GetDeviceType();
             auto receiver = mReceivers.find(deviceName);
-            if (receiver != mReceivers.end()) {
-                receiver->second->Execute(socket, headerMsg);
-            } else {
-                socket->Skip(headerMsg->GetBodySizeToRead(), 0);
+            if (deviceType.compare(0, 4, "GET_") == 0) {
+                // query for latest message, served from cache
+                client.Buffer.Skip(bodySize);
+                const double traceGet = mTrace.Time();
+                if (!mCache) {
+                    CMN_LOG_CLASS_RUN_WARNING << "ReceiveAll: received \"" << deviceType
+                                              << "\" but cache is not enabled" << std::endl;
+                } else if (client.QuotaAllows(deviceName, osaGetTime(), mReceiveQuotas)) {
+                    auto lock = mData->SendLock(&client);
+                    bool found;
+                    if (!mData->SendCached(client, deviceType.substr(4), deviceName,
+                                           mSendChunkSize, mSendMaxQueueSize, found)) {
+                        toBeRemoved.push_back(connection);
+                        break;
+                    }
+                    if (!found) {
+                        CMN_LOG_CLASS_RUN_VERBOSE << "ReceiveAll: no message cached for \""
+                                                  << deviceType << "\" and device \""
+                                                  << deviceName << "\" requested by "
+                                                  << client.Name << std::endl;
+                    }
+                }
+                mTrace.Add("get", deviceName, traceGet);
+            } else if ((deviceName == mtsIGTLClientProfileDevice) && (deviceType == "STRING")) {
+                // profile selected by client: encoding (16 bits), length (16 bits), string
+                std::vector<unsigned char> body(bodySize);
+                client.Buffer.Read(body.data(), bodySize);
+                const size_t length = (bodySize < 4) ? 0 : ((body[2] << 8) | body[3]);
+                const std::string name(reinterpret_cast<const char *>(body.data()) + 4,
+                                       std::min(length, bodySize - std::min(bodySize, size_t(4))));
+                auto profile = std::find_if(mClientProfiles.begin(), mClientProfiles.end(),
+                                            [&name](const ClientProfile & profile) {
+                                                return profile.Name == name;
+                                            });
+                if (profile == mClientProfiles.end()) {
+                    CMN_LOG_CLASS_RUN_WARNING << "ReceiveAll: unknown profile \"" << name
+                                              << "\" requested by client at " << client.Name << std::endl;
+                } else {
+                    CMN_LOG_CLASS_RUN_VERBOSE << "ReceiveAll: using profile \"" << name
+                                              << "\" for client at " << client.Name << std::endl;
+                    auto lock = mData->SendLock(&client);
+                    client.SetProfile(&(*profile));
+                }
+            } else if (receiver == mReceivers.end()) {
+                client.Buffer.Skip(bodySize);
                 CMN_LOG_CLASS_RUN_WARNING << "ReceiveAll: not receiver known for device \""
                                           << deviceName << "\"" << std::endl;
+            } else if (!client.QuotaAllows(deviceName, osaGetTime(), mReceiveQuotas)) {
+                client.Buffer.Skip(bodySize);
+                // only log first message dropped in each window
+                const mtsIGTLBridgeData::Client::Quota & quota = client.Quotas[deviceName];
+                if (quota.Count == static_cast<size_t>(quota.Rate) + 1) {
+                    CMN_LOG_CLASS_RUN_WARNING << "ReceiveAll: quota exceeded for device \""
+                                              << deviceName << "\" from client "
+                                              << client.Name << ", dropping messages" << std::endl;
+                }
+                mTrace.Add("receive dropped", deviceName, mTrace.Time());
+            } else if (VerifyCRC(receiver->second->GetPriority())
+                       && (client.Buffer.CRC64(bodySize) != crc)) {
+                client.Buffer.Skip(bodySize);
+                CMN_LOG_CLASS_RUN_WARNING << "ReceiveAll: invalid CRC for device \""
+                                          << deviceName << "\" from client "
+                                          << client.Name << ", dropping message" << std::endl;
+                mTrace.Add("receive invalid", deviceName, mTrace.Time());
+            } else {
+                // commands are executed in the order received, poses
+                // are only batched while TRANSFORM messages are
+                // consecutive
+                if (!mPoseReceivers.empty()
+                    && !((deviceType == "TRANSFORM")
+                         && mtsIGTLPoseReceiver::Batched(headerMsg)
+                         && dynamic_cast<mtsIGTLPoseReceiver *>(receiver->second))) {
+                    ReceivePoses();
+                }
+                const double traceReceive = mTrace.Time();
+                // lower priority state is deferred to next cycle if
+                // over budget, commands are never deferred since only
+                // the latest message is kept
+                const bool deferred = receiver->second->GetCoalesced()
+                    && (receiver->second->GetPriority() != MTS_IGTL_PRIORITY_HIGH)
+                    && !InBudget();
+                receiver->second->Execute(client.Buffer, headerMsg, deferred);
+                mTrace.Add(deferred ? "receive deferred" : "receive", deviceName, traceReceive);
             }
-        }
 
-        if (sendingClientActive == 0) {
-            // log some information and remove from list
-            std::string address;
-            int port;
-            socket->GetSocketAddressAndPort(address, port);
-            CMN_LOG_CLASS_RUN_VERBOSE << "ReceiveAll: can't receive from client at "
-                                      << address << ":" << port
-                                      << std::endl;
-            toBeRemoved.push_back(socket);
+            // don't keep parsing past the end of the period
+            if ((osaGetTime() - mCycleStart) >= this->Period) {
+                break;
+            }
         }
     }
 
+    // TRANSFORM messages are converted in a single batch
+    ReceivePoses();
+
     // remove all sockets we identified as inactive
-    for (auto & socket : toBeRemoved) {
-        mData->mSockets.remove(socket);
-    }
+    mData->RemoveClients(toBeRemoved);
 }
 
 // templated implementation for Send
 template <typename _igtlMessagePointer>
-void mtsIGTLBridge::Send(_igtlMessagePointer message)
+void mtsIGTLBridge::Send(_igtlMessagePointer message, const bool state)
 {
-    typedef std::list<igtl::ClientSocket::Pointer> RemovedType;
-    RemovedType toBeRemoved;
+    SendBytes(static_cast<const unsigned char *>(message->GetPackPointer()),
+              message->GetPackSize(),
+              message->GetDeviceName(), state);
+}
+
+void mtsIGTLBridge::SendBytes(const unsigned char * data, const size_t size,
+                              const std::string & deviceName, const bool state)
+{
+    // keep a copy for GET_ requests and new clients
+    if (mCache) {
+        mData->UpdateCache(data, size, deviceName);
+    }
+
+#if (CISST_OS != CISST_WINDOWS)
+    // same host clients, never blocks
+    if (mData->mSharedMemory) {
+        const double traceStart = mTrace.Time();
+        if (!mData->mSharedMemory->Write(data, size)) {
+            CMN_LOG_CLASS_RUN_WARNING << "Send: message for \"" << deviceName
+                                      << "\" is too large for shared memory \""
+                                      << mData->mSharedMemory->GetName() << "\"" << std::endl;
+        }
+        mTrace.Add("send shared memory", deviceName, traceStart);
+    }
+#endif
+
+    // sent by the worker with all messages of this cycle
+    if (mSendWorker) {
+        mData->mSendFilling->Add(data, size, deviceName, mtsIGTLIsState(data, state));
+        return;
+    }
 
     // send to all clients of this server
-    for (auto & socket : mData->mSockets) {
-        socket->SetTimeout(10);
-        socket->SetSendBlocking(10);
-        // keep track of which client we can send to
-        int receivingClientActive =
-            socket->Send(message->GetPackPointer(),
-                         message->GetPackSize());
-
-        if (receivingClientActive == 0) {
-            // log some information and remove from list
-            std::string address;
-            int port;
-            socket->GetSocketAddressAndPort(address, port);
+    mtsIGTLBridgeData::RemovedType toBeRemoved;
+    if (SendToClients(data, size, deviceName, mtsIGTLIsState(data, state), mTrace, toBeRemoved)) {
+        mSendPending = true;
+    }
+
+    // remove all sockets we identified as inactive
+    mData->RemoveClients(toBeRemoved);
+}
+
+bool mtsIGTLBridge::SendToClients(const unsigned char * data, const size_t size,
+                                  const std::string & deviceName, const bool state,
+                                  mtsIGTLTrace & trace,
+                                  std::list<mtsIGTLConnection *> & toBeRemoved)
+{
+    bool pending = false;
+    for (auto clientPointer : mData->mSendClients) {
+        mtsIGTLBridgeData::Client & client = *clientPointer;
+        if (client.Lost) {
+            continue;
+        }
+        const double traceStart = trace.Time();
+        if (!client.Send(data, size, deviceName, state, mSendChunkSize, mSendMaxQueueSize)) {
             CMN_LOG_CLASS_RUN_VERBOSE << "Send: can't send to client at "
-                                      << address << ":" << port
-                                      << std::endl;
-            toBeRemoved.push_back(socket);
+                                      << client.Name << std::endl;
+            toBeRemoved.push_back(client.Connection);
+            continue;
         }
+        pending = pending || !client.SendQueue.empty();
+        trace.Add("send client", client.Name, traceStart);
+    }
+    return pending;
+}
+
+bool mtsIGTLBridge::SendQueued(void)
+{
+    // continued by the send worker
+    if (mSendWorker) {
+        return false;
     }
 
+    mtsIGTLBridgeData::RemovedType toBeRemoved;
+    bool pending = false;
+
+#if SAW_OPENIGTLINK_HAS_IO_URING
+    // the kernel sends queued data, no chunks needed
+    if (mData->mUring) {
+        mData->ProcessUring(0, toBeRemoved);
+        pending = mData->UringSendPending();
+    }
+#endif
+
+    pending = SendChunks(mTrace, toBeRemoved) || pending;
+
     // remove all sockets we identified as inactive
-    for (auto & socket : toBeRemoved) {
-        mData->mSockets.remove(socket);
+    mData->RemoveClients(toBeRemoved);
+    return pending;
+}
+
+bool mtsIGTLBridge::SendChunks(mtsIGTLTrace & trace,
+                               std::list<mtsIGTLConnection *> & toBeRemoved)
+{
+    const double start = osaGetTime();
+    bool pending = false;
+    const size_t nbClients = mData->mSendClients.size();
+    if (nbClients == 0) {
+        return false;
+    }
+    // start with the client after the last one served so clients
+    // take turns when the time slice runs out
+    const size_t first = mData->mSendNext % nbClients;
+    mData->mSendNext = (first + 1) % nbClients;
+    for (size_t clientCount = 0; clientCount < nbClients; ++clientCount) {
+        mtsIGTLBridgeData::Client & client = *(mData->mSendClients[(first + clientCount) % nbClients]);
+        // sent by io_uring
+        if (client.QueueOnly || client.Lost) {
+            continue;
+        }
+        bool wouldBlock = false;
+        while (!client.SendQueue.empty() && !wouldBlock) {
+            // a large transfer can't take more than the time slice
+            if ((mSendTimeSlice > 0.0) && ((osaGetTime() - start) >= mSendTimeSlice)) {
+                mData->mSendNext = (first + clientCount + 1) % nbClients;
+                return true;
+            }
+            const double traceStart = trace.Time();
+            mtsIGTLBridgeData::Client::Frame & frame = client.SendQueue.front();
+            const size_t chunk = std::min(frame.Data.size() - frame.Offset, mSendChunkSize);
+            const long long sent = client.Connection->Send(frame.Data.data() + frame.Offset, chunk);
+            if (sent < 0) {
+                CMN_LOG_CLASS_RUN_VERBOSE << "SendQueued: can't send to client at "
+                                          << client.Name << std::endl;
+                toBeRemoved.push_back(client.Connection);
+                break;
+            }
+            frame.Offset += static_cast<size_t>(sent);
+            trace.Add("send chunk", frame.DeviceName, traceStart);
+            if (frame.Offset == frame.Data.size()) {
+                client.PopFrame();
+            } else {
+                // partial or no write, kernel buffer is full
+                wouldBlock = (static_cast<size_t>(sent) < chunk);
+            }
+        }
+        pending = pending || !client.SendQueue.empty();
+    }
+    return pending;
+}
+
+void mtsIGTLBridge::PublishSendFrame(void)
+{
+    if (!mSendWorker || mData->mSendFilling->Messages.empty()) {
+        return;
+    }
+    // worker still sending previous frame, keep filling this one
+    mtsIGTLBridgeData::SendFrame * done = mData->mSendDone.exchange(nullptr, std::memory_order_acquire);
+    if (!done) {
+        mTrace.Add("send worker busy", mTrace.Time());
+        return;
+    }
+    mData->mSendReady.store(mData->mSendFilling, std::memory_order_release);
+    mData->mSendFilling = done;
+    mData->WakeSendWorker();
+}
+
+void mtsIGTLBridge::SendWorker(void)
+{
+    // mtsIGTLTrace is not thread safe, the worker uses a disabled trace
+    mtsIGTLTrace trace;
+    mtsIGTLBridgeData::RemovedType toBeRemoved;
+    bool pending = false;
+    while (!mData->mSendWorkerStop.load(std::memory_order_acquire)) {
+        mtsIGTLBridgeData::SendFrame * frame = mData->mSendReady.exchange(nullptr, std::memory_order_acquire);
+        if (frame || pending) {
+            // the bridge thread can add clients while the worker
+            // writes, it only waits to modify or remove a client the
+            // worker is writing to
+            {
+                std::lock_guard<std::mutex> lock(mData->mSendMutex);
+                mData->UpdateSendClients();
+                for (auto client : mData->mSendClients) {
+                    client->Sending = true;
+                }
+            }
+            if (frame) {
+                for (auto & message : frame->Messages) {
+                    if (SendToClients(frame->Data.data() + message.Offset, message.Size,
+                                      message.DeviceName, message.State,
+                                      trace, toBeRemoved)) {
+                        pending = true;
+                    }
+                }
+            }
+            // continue large transfers
+            pending = SendChunks(trace, toBeRemoved);
+            // clients are removed by the bridge thread, see Run
+            {
+                std::lock_guard<std::mutex> lock(mData->mSendMutex);
+                for (auto client : mData->mSendClients) {
+                    if (std::find(toBeRemoved.begin(), toBeRemoved.end(), client->Connection) != toBeRemoved.end()) {
+                        client->Lost = true;
+                    }
+                    client->Sending = false;
+                }
+                mData->mSendClients.clear();
+            }
+            mData->mSendIdle.notify_all();
+            toBeRemoved.clear();
+        }
+        if (frame) {
+            frame->Clear();
+            mData->mSendDone.store(frame, std::memory_order_release);
+            continue;
+        }
+        // wait for next frame, poll often if transfers are pending
+        std::unique_lock<std::mutex> lock(mData->mSendWakeMutex);
+        mData->mSendWake.wait_for(lock,
+                                  pending ? std::chrono::microseconds(100) : std::chrono::microseconds(1000),
+                                  [this] {
+                                      return (mData->mSendReady.load(std::memory_order_acquire) != nullptr)
+                                          || mData->mSendWorkerStop.load(std::memory_order_acquire);
+                                  });
     }
 }
 
 // force instantiation
 template
-void mtsIGTLBridge::Send<igtl::TransformMessage::Pointer>(igtl::TransformMessage::Pointer);
+void mtsIGTLBridge::Send<igtl::TransformMessage::Pointer>(igtl::TransformMessage::Pointer, const bool);
+template
+void mtsIGTLBridge::Send<igtl::PositionMessage::Pointer>(igtl::PositionMessage::Pointer, const bool);
 template
-void mtsIGTLBridge::Send<igtl::StringMessage::Pointer>(igtl::StringMessage::Pointer);
+void mtsIGTLBridge::Send<igtl::StringMessage::Pointer>(igtl::StringMessage::Pointer, const bool);
 template
-void mtsIGTLBridge::Send<igtl::SensorMessage::Pointer>(igtl::SensorMessage::Pointer);
+void mtsIGTLBridge::Send<igtl::SensorMessage::Pointer>(igtl::SensorMessage::Pointer, const bool);
 template
-void mtsIGTLBridge::Send<igtl::NDArrayMessage::Pointer>(igtl::NDArrayMessage::Pointer);
+void mtsIGTLBridge::Send<igtl::NDArrayMessage::Pointer>(igtl::NDArrayMessage::Pointer, const bool);
 template
-void mtsIGTLBridge::Send<igtl::PointMessage::Pointer>(igtl::PointMessage::Pointer);
+void mtsIGTLBridge::Send<igtl::PointMessage::Pointer>(igtl::PointMessage::Pointer, const bool);
+template
+void mtsIGTLBridge::Send<mtsIGTLPackedMessage *>(mtsIGTLPackedMessage *, const bool);
 
 
 // templated implementation for mtsIGTLReceiver::Execute
 template <typename _igtlType, typename _cisstType>
-bool mtsIGTLReceiver<_igtlType, _cisstType>::Execute(igtl::Socket * socket,
-                                                     igtl::MessageBase * header)
+bool mtsIGTLReceiver<_igtlType, _cisstType>::Execute(mtsIGTLReceiveBuffer & buffer,
+                                                     igtl::MessageBase * header,
+                                                     const bool deferred)
 {
-    IGTLPointer message;
-    message = _igtlType::New();
+    // message and its pack buffer are re-used
+    IGTLPointer & message = mIGTLData;
     message->SetMessageHeader(header);
     message->AllocatePack();
-    bool timeout(false);
-    socket->Receive(message->GetPackBodyPointer(),
-                    message->GetPackBodySize(),
-                    timeout);
-    int c = message->Unpack(1);
+    buffer.Read(message->GetPackBodyPointer(),
+                message->GetPackBodySize());
+    // CRC is verified by ReceiveAll, based on CRC policy
+    int c = message->Unpack(0);
     if (c & igtl::MessageHeader::UNPACK_BODY) {
         // convert igtl message to cisst type
         if (mtsIGTLToCISST(message, mCISSTData)) {
+            if (deferred) {
+                mPending = true;
+                return true;
+            }
+            mPending = false;
             mtsExecutionResult result = Function(mCISSTData);
             if (result) {
                 return true;
@@ -277,16 +1906,138 @@ bool mtsIGTLReceiver<_igtlType, _cisstType>::Execute(igtl::Socket * socket,
     return false;
 }
 
+template <typename _igtlType, typename _cisstType>
+bool mtsIGTLReceiver<_igtlType, _cisstType>::ExecutePending(void)
+{
+    if (!mPending) {
+        return false;
+    }
+    mPending = false;
+    mtsExecutionResult result = Function(mCISSTData);
+    if (!result) {
+        CMN_LOG_RUN_WARNING << "mtsIGTLReceiver: failed to execute deferred command for device \""
+                            << mName << "\", error:" << result << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// TRANSFORM senders and receivers, see SendPoses and ReceivePoses
+bool mtsIGTLSender<prmPositionCartesianGet, mtsIGTLPackedMessage>::Execute(void)
+{
+    mtsIGTLTrace & trace = mBridge->Trace();
+    const double traceTime = trace.Time();
+    mtsExecutionResult result = Function(mCISSTData);
+    trace.Add("pull", mName, traceTime);
+    if (!result) {
+        CMN_LOG_RUN_ERROR << "mtsIGTLSender::Execute: " << result
+                          << " for " << mName << std::endl;
+        return false;
+    }
+    if (!mCISSTData.Valid()) {
+        return false;
+    }
+    mBridge->QueuePose(this);
+    return true;
+}
+
+bool mtsIGTLReceiver<igtl::TransformMessage, prmPositionCartesianSet>::Execute(mtsIGTLReceiveBuffer & buffer,
+                                                                              igtl::MessageBase * header,
+                                                                              const bool deferred)
+{
+    if (Batched(header)) {
+        mBridge->QueuePose(this, buffer, deferred);
+        return true;
+    }
+    // other versions might have extended header and meta data
+    igtl::TransformMessage::Pointer message = igtl::TransformMessage::New();
+    message->SetMessageHeader(header);
+    message->AllocatePack();
+    buffer.Read(message->GetPackBodyPointer(),
+                message->GetPackBodySize());
+    int c = message->Unpack(0);
+    if (c & igtl::MessageHeader::UNPACK_BODY) {
+        if (mtsIGTLToCISST(message, mCISSTData)) {
+            return ExecuteConverted(deferred);
+        }
+        CMN_LOG_RUN_WARNING << "mtsIGTLReceiver: failed to convert data for device \""
+                            << header->GetDeviceName() << "\"" << std::endl;
+    }
+    return false;
+}
+
+bool mtsIGTLReceiver<igtl::TransformMessage, prmPositionCartesianSet>::Batched(igtl::MessageBase * header)
+{
+    return (header->GetHeaderVersion() == 1)
+        && (header->GetBodySizeToRead() == mtsIGTLPoseBatch::BODY_SIZE);
+}
+
+bool mtsIGTLReceiver<igtl::TransformMessage, prmPositionCartesianSet>::ExecuteConverted(const bool deferred)
+{
+    if (deferred) {
+        mPending = true;
+        return true;
+    }
+    mPending = false;
+    mtsExecutionResult result = Function(mCISSTData);
+    if (!result) {
+        CMN_LOG_RUN_WARNING << "mtsIGTLReceiver: failed to execute for device \""
+                            << mName << "\", error:" << result << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool mtsIGTLReceiver<igtl::TransformMessage, prmPositionCartesianSet>::ExecutePending(void)
+{
+    if (!mPending) {
+        return false;
+    }
+    return ExecuteConverted(false);
+}
+
 // force implementation
 template
-bool mtsIGTLReceiver<igtl::StringMessage, std::string>::Execute(igtl::Socket *, igtl::MessageBase *);
+bool mtsIGTLReceiver<igtl::StringMessage, std::string>::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::SensorMessage, prmForceCartesianSet>::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::SensorMessage, prmStateJoint>::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::SensorMessage, prmPositionJointSet>::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::PositionMessage, prmPositionCartesianSet>::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::NDArrayMessage, prmPositionJointSet>::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::NDArrayMessage, prmStateJoint>::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::PointMessage, vct3>::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::PointMessage, std::vector<vct3> >::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::PointMessage, vctDynamicVector<vct3> >::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::PointMessage, vctDoubleMat>::Execute(mtsIGTLReceiveBuffer &, igtl::MessageBase *, const bool);
+template
+bool mtsIGTLReceiver<igtl::StringMessage, std::string>::ExecutePending(void);
+template
+bool mtsIGTLReceiver<igtl::SensorMessage, prmForceCartesianSet>::ExecutePending(void);
+template
+bool mtsIGTLReceiver<igtl::SensorMessage, prmStateJoint>::ExecutePending(void);
+template
+bool mtsIGTLReceiver<igtl::SensorMessage, prmPositionJointSet>::ExecutePending(void);
+template
+bool mtsIGTLReceiver<igtl::PositionMessage, prmPositionCartesianSet>::ExecutePending(void);
+template
+bool mtsIGTLReceiver<igtl::NDArrayMessage, prmPositionJointSet>::ExecutePending(void);
 template
-bool mtsIGTLReceiver<igtl::SensorMessage, prmForceCartesianSet>::Execute(igtl::Socket *, igtl::MessageBase *);
+bool mtsIGTLReceiver<igtl::NDArrayMessage, prmStateJoint>::ExecutePending(void);
 template
-bool mtsIGTLReceiver<igtl::SensorMessage, prmStateJoint>::Execute(igtl::Socket *, igtl::MessageBase *);
+bool mtsIGTLReceiver<igtl::PointMessage, vct3>::ExecutePending(void);
 template
-bool mtsIGTLReceiver<igtl::SensorMessage, prmPositionJointSet>::Execute(igtl::Socket *, igtl::MessageBase *);
+bool mtsIGTLReceiver<igtl::PointMessage, std::vector<vct3> >::ExecutePending(void);
 template
-bool mtsIGTLReceiver<igtl::TransformMessage, prmPositionCartesianSet>::Execute(igtl::Socket *, igtl::MessageBase *);
+bool mtsIGTLReceiver<igtl::PointMessage, vctDynamicVector<vct3> >::ExecutePending(void);
 template
-bool mtsIGTLReceiver<igtl::PointMessage, vct3>::Execute(igtl::Socket *, igtl::MessageBase *);
+bool mtsIGTLReceiver<igtl::PointMessage, vctDoubleMat>::ExecutePending(void);
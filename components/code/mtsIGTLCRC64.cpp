@@ -0,0 +1,83 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLCRC64.h>
+
+// polynomial used by OpenIGTLink, most significant bit first, no
+// reflection nor final xor
+#define MTS_IGTL_CRC64_POLYNOMIAL 0x42F0E1EBA9EA3693ULL
+
+/*! Tables[0] is the regular byte table, Tables[k][i] is the CRC of
+  byte i followed by k zero bytes. */
+class mtsIGTLCRC64Tables
+{
+public:
+    mtsIGTLCRC64Tables(void) {
+        for (unsigned int byte = 0; byte < 256; ++byte) {
+            unsigned long long crc = static_cast<unsigned long long>(byte) << 56;
+            for (size_t bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x8000000000000000ULL) ?
+                    ((crc << 1) ^ MTS_IGTL_CRC64_POLYNOMIAL) : (crc << 1);
+            }
+            Tables[0][byte] = crc;
+        }
+        for (size_t table = 1; table < 8; ++table) {
+            for (unsigned int byte = 0; byte < 256; ++byte) {
+                const unsigned long long previous = Tables[table - 1][byte];
+                Tables[table][byte] = (previous << 8) ^ Tables[0][previous >> 56];
+            }
+        }
+    }
+
+    unsigned long long Tables[8][256];
+};
+
+static const mtsIGTLCRC64Tables mtsIGTLCRC64Lookup;
+
+unsigned long long mtsIGTLCRC64(const unsigned char * data,
+                                const size_t size,
+                                const unsigned long long crc)
+{
+    const unsigned long long (* tables)[256] = mtsIGTLCRC64Lookup.Tables;
+    unsigned long long result = crc;
+    const unsigned char * end = data + size;
+    // 8 bytes at a time, first byte of data is the most significant
+    for (; data + 8 <= end; data += 8) {
+        result ^= (static_cast<unsigned long long>(data[0]) << 56)
+            | (static_cast<unsigned long long>(data[1]) << 48)
+            | (static_cast<unsigned long long>(data[2]) << 40)
+            | (static_cast<unsigned long long>(data[3]) << 32)
+            | (static_cast<unsigned long long>(data[4]) << 24)
+            | (static_cast<unsigned long long>(data[5]) << 16)
+            | (static_cast<unsigned long long>(data[6]) << 8)
+            | static_cast<unsigned long long>(data[7]);
+        result = tables[7][result >> 56]
+            ^ tables[6][(result >> 48) & 0xFF]
+            ^ tables[5][(result >> 40) & 0xFF]
+            ^ tables[4][(result >> 32) & 0xFF]
+            ^ tables[3][(result >> 24) & 0xFF]
+            ^ tables[2][(result >> 16) & 0xFF]
+            ^ tables[1][(result >> 8) & 0xFF]
+            ^ tables[0][result & 0xFF];
+    }
+    // remaining bytes
+    for (; data < end; ++data) {
+        result = tables[0][(result >> 56) ^ *data] ^ (result << 8);
+    }
+    return result;
+}
@@ -30,6 +30,11 @@ void mtsIGTLCRTKBridge::ConfigureJSON(const Json::Value & jsonConfig)
     // to set port
     mtsIGTLBridge::ConfigureJSON(jsonConfig);
 
+    // optional channels, must be created before bridging interfaces
+    if (!ConfigureChannelsJSON(jsonConfig["channels"])) {
+        return;
+    }
+
     Json::Value jsonValue;
     const Json::Value interfaces = jsonConfig["interfaces"];
     if (interfaces.empty()) {
@@ -66,8 +71,51 @@ void mtsIGTLCRTKBridge::ConfigureJSON(const Json::Value & jsonConfig)
             mBridgeOnly.insert(bridgeOnly[bo].asString());
         }
 
+        // encoding is optional, use bridge default
+        InterfaceOptions options;
+        options.Encoding = mEncoding;
+        jsonValue = interfaces[index]["encoding"];
+        if (!jsonValue.empty()) {
+            if (!mtsIGTLEncodingFromString(jsonValue.asString(), options.Encoding)) {
+                CMN_LOG_CLASS_INIT_ERROR << "ConfigureJSON: \"encoding\" must be \"float64\" or \"float32\", found \""
+                                         << jsonValue.asString() << "\" for interface \""
+                                         << interfaceName << "\"" << std::endl;
+                return;
+            }
+        }
+
+        // Cartesian poses can be sent as "transform" (default) or "position"
+        jsonValue = interfaces[index]["pose"];
+        if (!jsonValue.empty()) {
+            const std::string pose = jsonValue.asString();
+            if (pose == "position") {
+                options.UsePositionMessage = true;
+            } else if (pose != "transform") {
+                CMN_LOG_CLASS_INIT_ERROR << "ConfigureJSON: \"pose\" must be \"transform\" or \"position\", found \""
+                                         << pose << "\" for interface \""
+                                         << interfaceName << "\"" << std::endl;
+                return;
+            }
+        }
+
+        // commands sent as state table history blocks
+        const Json::Value history = interfaces[index]["history"];
+        for (unsigned int h = 0; h < history.size(); ++h) {
+            options.History.insert(history[h].asString());
+        }
+
+        // send read commands when the component has new data
+        jsonValue = interfaces[index]["trigger-event"];
+        if (!jsonValue.empty()) {
+            options.TriggerEvent = jsonValue.asString();
+        }
+        jsonValue = interfaces[index]["trigger-state-table"];
+        if (!jsonValue.empty()) {
+            options.TriggerStateTable = jsonValue.asBool();
+        }
+
         // and now add the bridge
-        BridgeInterfaceProvided(componentName, interfaceName, name);
+        BridgeInterfaceProvided(componentName, interfaceName, name, options);
     }
 
     // skip connecting interfaces in case users want to add more
@@ -81,9 +129,73 @@ void mtsIGTLCRTKBridge::ConfigureJSON(const Json::Value & jsonConfig)
     }
 }
 
+bool mtsIGTLCRTKBridge::ConfigureChannelsJSON(const Json::Value & jsonChannels)
+{
+    Json::Value jsonValue;
+    for (unsigned int index = 0; index < jsonChannels.size(); ++index) {
+        const Json::Value jsonChannel = jsonChannels[index];
+        Channel channel;
+        jsonValue = jsonChannel["name"];
+        if (jsonValue.empty()) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureJSON: all \"channels\" must define \"name\"" << std::endl;
+            return false;
+        }
+        channel.Name = jsonValue.asString();
+        // each channel needs its own port
+        if (jsonChannel["port"].empty()) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureJSON: channel \"" << channel.Name
+                                     << "\" must define \"port\"" << std::endl;
+            return false;
+        }
+        // period is optional, use same as this bridge by default
+        double period = this->Period;
+        jsonValue = jsonChannel["period"];
+        if (!jsonValue.empty()) {
+            period = jsonValue.asDouble();
+        }
+        const Json::Value commands = jsonChannel["commands"];
+        for (unsigned int c = 0; c < commands.size(); ++c) {
+            channel.Patterns.push_back(commands[c].asString());
+        }
+        if (channel.Patterns.empty()) {
+            CMN_LOG_CLASS_INIT_WARNING << "ConfigureJSON: channel \"" << channel.Name
+                                       << "\" doesn't define any \"commands\"" << std::endl;
+        }
+        // new bridge using same configuration format for port, trace, encoding...
+        channel.Bridge = new mtsIGTLBridge(this->GetName() + "-" + channel.Name, period);
+        channel.Bridge->ConfigureJSON(jsonChannel);
+        channel.Bridge->SetPort(jsonChannel["port"].asInt());
+        if (!mtsComponentManager::GetInstance()->AddComponent(channel.Bridge)) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureJSON: failed to add component for channel \""
+                                     << channel.Name << "\"" << std::endl;
+            delete channel.Bridge;
+            return false;
+        }
+        CMN_LOG_CLASS_INIT_VERBOSE << "ConfigureJSON: added channel \"" << channel.Name
+                                   << "\" with period " << period << std::endl;
+        mChannels.push_back(channel);
+    }
+    return true;
+}
+
+mtsIGTLBridge * mtsIGTLCRTKBridge::ChannelFor(const std::string & fullCommand,
+                                              const std::string & crtkCommand)
+{
+    for (auto & channel : mChannels) {
+        for (auto & pattern : channel.Patterns) {
+            if (MatchPattern(pattern, crtkCommand)
+                || MatchPattern(pattern, fullCommand)) {
+                return channel.Bridge;
+            }
+        }
+    }
+    return this;
+}
+
 void mtsIGTLCRTKBridge::BridgeInterfaceProvided(const std::string & componentName,
                                                 const std::string & interfaceName,
-                                                const std::string & nameSpace)
+                                                const std::string & nameSpace,
+                                                const InterfaceOptions & options)
 {
     // first make sure we can find the component to bridge
     mtsManagerLocal * componentManager = mtsComponentManager::GetInstance();
@@ -106,13 +218,19 @@ void mtsIGTLCRTKBridge::BridgeInterfaceProvided(const std::string & componentNam
     // bridged (e.g. subscribers and events)
     const std::string requiredInterfaceName = componentName + "::" + interfaceName;
     std::string crtkCommand;
-    bool connectionNeeded = false;
+    // bridges (channels) using the required interface, need connection
+    std::set<mtsIGTLBridge *> connectionsNeeded;
+    // bridges with read commands, used for triggers
+    std::set<mtsIGTLBridge *> sendersAdded;
+    mtsIGTLBridge * bridge;
 
-    // write commands
+    // write commands, high priority so they are never deferred
     for (auto & command : interfaceProvided->GetNamesOfCommandsWrite()) {
         if (ShouldBeBridged(command)) {
             // get the CRTK command so we know which template type to use
             GetCRTKCommand(command, crtkCommand);
+            // find which channel should be used
+            bridge = ChannelFor(command, crtkCommand);
 
         /* examples from ROS CRTK, to be ported to IGTL
           if (_crtk_command == "servo_jf") {
@@ -122,22 +240,27 @@ void mtsIGTLCRTKBridge::BridgeInterfaceProvided(const std::string & componentNam
                 || (crtkCommand == "servo_jr")
                 || (crtkCommand == "move_jp")
                 || (crtkCommand == "move_jr")) {
-                connectionNeeded = true;
-                AddReceiverToCommandWrite<igtl::SensorMessage, prmPositionJointSet>
-                    (requiredInterfaceName, command, nameSpace + '/' + command);
+                connectionsNeeded.insert(bridge);
+                bridge->AddReceiverToCommandWrite<igtl::SensorMessage, prmPositionJointSet>
+                    (requiredInterfaceName, command, nameSpace + '/' + command, MTS_IGTL_PRIORITY_HIGH);
             } else if ((crtkCommand == "servo_cp")
                        || (crtkCommand == "move_cp")) {
-                connectionNeeded = true;
-                AddReceiverToCommandWrite<igtl::TransformMessage, prmPositionCartesianSet>
-                    (requiredInterfaceName, command, nameSpace + '/' + command);
+                connectionsNeeded.insert(bridge);
+                if (options.UsePositionMessage) {
+                    bridge->AddReceiverToCommandWrite<igtl::PositionMessage, prmPositionCartesianSet>
+                        (requiredInterfaceName, command, nameSpace + '/' + command, MTS_IGTL_PRIORITY_HIGH);
+                } else {
+                    bridge->AddReceiverToCommandWrite<igtl::TransformMessage, prmPositionCartesianSet>
+                        (requiredInterfaceName, command, nameSpace + '/' + command, MTS_IGTL_PRIORITY_HIGH);
+                }
             } else if (crtkCommand == "servo_cf") {
-                connectionNeeded = true;
-                AddReceiverToCommandWrite<igtl::SensorMessage, prmForceCartesianSet>
-                    (requiredInterfaceName, command, nameSpace + '/' + command);
+                connectionsNeeded.insert(bridge);
+                bridge->AddReceiverToCommandWrite<igtl::SensorMessage, prmForceCartesianSet>
+                    (requiredInterfaceName, command, nameSpace + '/' + command, MTS_IGTL_PRIORITY_HIGH);
             } else if (crtkCommand == "state_command") {
-                connectionNeeded = true;
-                AddReceiverToCommandWrite<igtl::StringMessage, std::string>
-                    (requiredInterfaceName, command, nameSpace + '/' + command);
+                connectionsNeeded.insert(bridge);
+                bridge->AddReceiverToCommandWrite<igtl::StringMessage, std::string>
+                    (requiredInterfaceName, command, nameSpace + '/' + command, MTS_IGTL_PRIORITY_HIGH);
             }
         }
     }
@@ -147,34 +270,75 @@ void mtsIGTLCRTKBridge::BridgeInterfaceProvided(const std::string & componentNam
         if (ShouldBeBridged(command)) {
             // get the CRTK command so we know which template type to use
             GetCRTKCommand(command, crtkCommand);
+            // find which channel should be used
+            bridge = ChannelFor(command, crtkCommand);
+
+            // send all samples from the state table instead of latest
+            // one, assumes the state data uses the command name
+            const bool history = (options.History.find(command) != options.History.end());
+            bool added = false;
 
             if ((crtkCommand == "measured_js")
                 || (crtkCommand == "setpoint_js")) {
-                connectionNeeded = true;
-                AddSenderFromCommandRead<prmStateJoint, igtl::NDArrayMessage>
-                    (requiredInterfaceName, command, nameSpace + '/' + command);
+                if (history) {
+                    added = bridge->AddSenderFromStateTable<prmStateJoint>
+                        (requiredInterfaceName, componentName, "", command,
+                         nameSpace + '/' + command, options.Encoding);
+                } else {
+                    connectionsNeeded.insert(bridge);
+                    added = bridge->AddSenderFromCommandRead<prmStateJoint, mtsIGTLPackedMessage>
+                        (requiredInterfaceName, command, nameSpace + '/' + command, options.Encoding);
+                }
             } else if ((crtkCommand == "measured_cp")
                        || (crtkCommand == "setpoint_cp")) {
-                connectionNeeded = true;
-                AddSenderFromCommandRead<prmPositionCartesianGet, igtl::TransformMessage>
-                    (requiredInterfaceName, command, nameSpace + '/' + command);
+                if (history) {
+                    added = bridge->AddSenderFromStateTable<prmPositionCartesianGet>
+                        (requiredInterfaceName, componentName, "", command,
+                         nameSpace + '/' + command, options.Encoding);
+                } else if (options.UsePositionMessage) {
+                    connectionsNeeded.insert(bridge);
+                    added = bridge->AddSenderFromCommandRead<prmPositionCartesianGet, igtl::PositionMessage>
+                        (requiredInterfaceName, command, nameSpace + '/' + command);
+                } else {
+                    connectionsNeeded.insert(bridge);
+                    // converted with all poses of the cycle, see mtsIGTLPoseBatch
+                    added = bridge->AddSenderFromCommandRead<prmPositionCartesianGet, mtsIGTLPackedMessage>
+                        (requiredInterfaceName, command, nameSpace + '/' + command);
+                }
             } else if (crtkCommand == "measured_cv") {
-                connectionNeeded = true;
-                AddSenderFromCommandRead<prmVelocityCartesianGet, igtl::SensorMessage>
-                    (requiredInterfaceName, command, nameSpace + '/' + command);
+                if (history) {
+                    added = bridge->AddSenderFromStateTable<prmVelocityCartesianGet>
+                        (requiredInterfaceName, componentName, "", command,
+                         nameSpace + '/' + command, options.Encoding);
+                } else {
+                    connectionsNeeded.insert(bridge);
+                    added = bridge->AddSenderFromCommandRead<prmVelocityCartesianGet, igtl::SensorMessage>
+                        (requiredInterfaceName, command, nameSpace + '/' + command);
+                }
             } else if (crtkCommand == "measured_cf") {
-                connectionNeeded = true;
-                AddSenderFromCommandRead<prmForceCartesianGet, igtl::SensorMessage>
-                    (requiredInterfaceName, command, nameSpace + '/' + command);
-            } /* else if (_crtk_command == "jacobian") {
-                 _pub_bridge_used = true;
-                 _pub_bridge->AddPublisherFromCommandRead<vctDoubleMat, std_msgs::Float64MultiArray>
-                 (interfaceName, *_command, _ros_topic);
-                 } else if (_crtk_command == "operating_state") {
+                if (history) {
+                    added = bridge->AddSenderFromStateTable<prmForceCartesianGet>
+                        (requiredInterfaceName, componentName, "", command,
+                         nameSpace + '/' + command, options.Encoding);
+                } else {
+                    connectionsNeeded.insert(bridge);
+                    added = bridge->AddSenderFromCommandRead<prmForceCartesianGet, igtl::SensorMessage>
+                        (requiredInterfaceName, command, nameSpace + '/' + command);
+                }
+            } else if (crtkCommand == "jacobian") {
+                // body/jacobian and spatial/jacobian, packed directly as NDARRAY
+                connectionsNeeded.insert(bridge);
+                added = bridge->AddSenderFromCommandRead<vctDoubleMat, mtsIGTLPackedMessage>
+                    (requiredInterfaceName, command, nameSpace + '/' + command, options.Encoding);
+            } /* else if (_crtk_command == "operating_state") {
                  m_subscribers_bridge->AddServiceFromCommandRead<prmOperatingState, crtk_msgs::trigger_operating_state>
                  (_requiredinterfaceName, *_command, _ros_topic);
                  }
               */
+            // triggers only apply to channels with senders
+            if (added) {
+                sendersAdded.insert(bridge);
+            }
         }
     }
 
@@ -183,6 +347,8 @@ void mtsIGTLCRTKBridge::BridgeInterfaceProvided(const std::string & componentNam
         if (ShouldBeBridged(command)) {
             // get the CRTK command so we know which template type to use
             GetCRTKCommand(command, crtkCommand);
+            // find which channel should be used
+            bridge = ChannelFor(command, crtkCommand);
             /*
               if (_crtk_command == "operating_state") {
               m_events_bridge->AddPublisherFromEventWrite<prmOperatingState, crtk_msgs::operating_state>
@@ -191,15 +357,28 @@ void mtsIGTLCRTKBridge::BridgeInterfaceProvided(const std::string & componentNam
             if ((crtkCommand == "error")
                 || (crtkCommand == "warning")
                 || (crtkCommand == "status")) {
-                connectionNeeded = true;
-                AddSenderFromEventWrite<mtsMessage, igtl::StringMessage>
+                connectionsNeeded.insert(bridge);
+                bridge->AddSenderFromEventWrite<mtsMessage, igtl::StringMessage>
                     (requiredInterfaceName, command, nameSpace + '/' + command);
             }
         }
     }
 
-    if (connectionNeeded) {
-        mConnections.Add(this->GetName(), requiredInterfaceName,
+    // triggers apply to all read commands added so far for this
+    // interface, on each channel
+    for (auto & senderBridge : sendersAdded) {
+        if (!options.TriggerEvent.empty()) {
+            if (senderBridge->AddTriggerFromEventVoid(requiredInterfaceName, options.TriggerEvent)) {
+                connectionsNeeded.insert(senderBridge);
+            }
+        }
+        if (options.TriggerStateTable) {
+            senderBridge->AddTriggerFromStateTable(requiredInterfaceName, componentName);
+        }
+    }
+
+    for (auto & connectionBridge : connectionsNeeded) {
+        mConnections.Add(connectionBridge->GetName(), requiredInterfaceName,
                          componentName, interfaceName);
     }
 
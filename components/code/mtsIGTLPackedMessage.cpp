@@ -0,0 +1,340 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLPackedMessage.h>
+#include <sawOpenIGTLink/mtsIGTLCRC64.h>
+
+#include <algorithm>
+#include <cmath>
+
+// vectorized byte swaps, selected at runtime based on CPU
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MTS_IGTL_HAS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+mtsIGTLPackedMessage::mtsIGTLPackedMessage(void):
+    mBuffer(HEADER_SIZE, 0),
+    mTimeStamp(0.0)
+{
+}
+
+void mtsIGTLPackedMessage::SetDeviceType(const std::string & deviceType)
+{
+    mDeviceType = deviceType;
+}
+
+void mtsIGTLPackedMessage::SetDeviceName(const std::string & deviceName)
+{
+    mDeviceName = deviceName;
+}
+
+void mtsIGTLPackedMessage::SetTimeStamp(const double & timeStamp)
+{
+    mTimeStamp = timeStamp;
+}
+
+unsigned char * mtsIGTLPackedMessage::AllocateBody(const size_t bodySize)
+{
+    mBuffer.resize(HEADER_SIZE + bodySize);
+    return GetPackBodyPointer();
+}
+
+void mtsIGTLPackedMessage::Pack(void)
+{
+    unsigned char * header = mBuffer.data();
+    // version
+    header = WriteUint16(header, 1);
+    // type and device name, padded with 0
+    memset(header, 0, TYPE_SIZE + NAME_SIZE);
+    memcpy(header, mDeviceType.data(),
+           std::min(mDeviceType.size(), static_cast<size_t>(TYPE_SIZE)));
+    header += TYPE_SIZE;
+    memcpy(header, mDeviceName.data(),
+           std::min(mDeviceName.size(), static_cast<size_t>(NAME_SIZE)));
+    header += NAME_SIZE;
+    // time stamp, 32 bits for seconds and 32 bits for fraction
+    unsigned long long timeStamp = 0;
+    if (mTimeStamp > 0.0) {
+        const unsigned long long maxUint32 = 0xFFFFFFFFULL;
+        if (mTimeStamp >= static_cast<double>(maxUint32 + 1)) {
+            // past 2106 (or infinite), clamp to the largest time stamp
+            timeStamp = (maxUint32 << 32) | maxUint32;
+        } else {
+            double seconds;
+            const double fraction = modf(mTimeStamp, &seconds);
+            unsigned long long secondsBits = static_cast<unsigned long long>(seconds);
+            // rounded fraction can reach 2^32, carry into seconds
+            unsigned long long fractionBits = static_cast<unsigned long long>(fraction * 4294967296.0 + 0.5);
+            if (fractionBits > maxUint32) {
+                fractionBits = 0;
+                ++secondsBits;
+                if (secondsBits > maxUint32) {
+                    secondsBits = maxUint32;
+                    fractionBits = maxUint32;
+                }
+            }
+            timeStamp = (secondsBits << 32) | fractionBits;
+        }
+    }
+    header = WriteUint64(header, timeStamp);
+    // body size and crc
+    const size_t bodySize = GetPackBodySize();
+    header = WriteUint64(header, bodySize);
+    WriteUint64(header, mtsIGTLCRC64(GetPackBodyPointer(), bodySize));
+}
+
+typedef unsigned char * (*mtsIGTLWriteArrayFunction)(unsigned char *, const double *, const size_t);
+typedef const unsigned char * (*mtsIGTLReadArrayFunction)(const unsigned char *, double *, const size_t);
+
+static unsigned char * mtsIGTLWriteFloat64ArrayScalar(unsigned char * buffer,
+                                                      const double * values, const size_t count)
+{
+    for (size_t index = 0; index < count; ++index) {
+        buffer = mtsIGTLPackedMessage::WriteFloat64(buffer, values[index]);
+    }
+    return buffer;
+}
+
+static unsigned char * mtsIGTLWriteFloat32ArrayScalar(unsigned char * buffer,
+                                                      const double * values, const size_t count)
+{
+    for (size_t index = 0; index < count; ++index) {
+        buffer = mtsIGTLPackedMessage::WriteFloat32(buffer, static_cast<float>(values[index]));
+    }
+    return buffer;
+}
+
+static const unsigned char * mtsIGTLReadFloat32ArrayScalar(const unsigned char * buffer,
+                                                           double * values, const size_t count)
+{
+    for (size_t index = 0; index < count; ++index, buffer += 4) {
+        values[index] = mtsIGTLPackedMessage::ReadFloat32(buffer);
+    }
+    return buffer;
+}
+
+#ifdef MTS_IGTL_HAS_X86_SIMD
+
+// shuffle masks reversing bytes of each 64 or 32 bits element
+#define MTS_IGTL_SWAP64 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+#define MTS_IGTL_SWAP32 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+
+__attribute__((target("ssse3")))
+static unsigned char * mtsIGTLWriteFloat64ArraySSSE3(unsigned char * buffer,
+                                                     const double * values, const size_t count)
+{
+    const __m128i mask = _mm_setr_epi8(MTS_IGTL_SWAP64);
+    size_t index = 0;
+    for (; index + 2 <= count; index += 2, buffer += 16) {
+        const __m128i raw = _mm_castpd_si128(_mm_loadu_pd(values + index));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(buffer), _mm_shuffle_epi8(raw, mask));
+    }
+    return mtsIGTLWriteFloat64ArrayScalar(buffer, values + index, count - index);
+}
+
+__attribute__((target("ssse3")))
+static unsigned char * mtsIGTLWriteFloat32ArraySSSE3(unsigned char * buffer,
+                                                     const double * values, const size_t count)
+{
+    const __m128i mask = _mm_setr_epi8(MTS_IGTL_SWAP32);
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4, buffer += 16) {
+        // cvtpd_ps rounds like static_cast<float>
+        const __m128 low = _mm_cvtpd_ps(_mm_loadu_pd(values + index));
+        const __m128 high = _mm_cvtpd_ps(_mm_loadu_pd(values + index + 2));
+        const __m128i raw = _mm_castps_si128(_mm_movelh_ps(low, high));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(buffer), _mm_shuffle_epi8(raw, mask));
+    }
+    return mtsIGTLWriteFloat32ArrayScalar(buffer, values + index, count - index);
+}
+
+__attribute__((target("ssse3")))
+static const unsigned char * mtsIGTLReadFloat32ArraySSSE3(const unsigned char * buffer,
+                                                          double * values, const size_t count)
+{
+    const __m128i mask = _mm_setr_epi8(MTS_IGTL_SWAP32);
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4, buffer += 16) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer));
+        const __m128 floats = _mm_castsi128_ps(_mm_shuffle_epi8(raw, mask));
+        _mm_storeu_pd(values + index, _mm_cvtps_pd(floats));
+        _mm_storeu_pd(values + index + 2, _mm_cvtps_pd(_mm_movehl_ps(floats, floats)));
+    }
+    return mtsIGTLReadFloat32ArrayScalar(buffer, values + index, count - index);
+}
+
+// AVX2 shuffles bytes within each 128 bits lane, masks are repeated
+__attribute__((target("avx2")))
+static unsigned char * mtsIGTLWriteFloat64ArrayAVX2(unsigned char * buffer,
+                                                    const double * values, const size_t count)
+{
+    const __m256i mask = _mm256_setr_epi8(MTS_IGTL_SWAP64, MTS_IGTL_SWAP64);
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4, buffer += 32) {
+        const __m256i raw = _mm256_castpd_si256(_mm256_loadu_pd(values + index));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(buffer), _mm256_shuffle_epi8(raw, mask));
+    }
+    return mtsIGTLWriteFloat64ArrayScalar(buffer, values + index, count - index);
+}
+
+__attribute__((target("avx2")))
+static unsigned char * mtsIGTLWriteFloat32ArrayAVX2(unsigned char * buffer,
+                                                    const double * values, const size_t count)
+{
+    const __m256i mask = _mm256_setr_epi8(MTS_IGTL_SWAP32, MTS_IGTL_SWAP32);
+    size_t index = 0;
+    for (; index + 8 <= count; index += 8, buffer += 32) {
+        const __m128 low = _mm256_cvtpd_ps(_mm256_loadu_pd(values + index));
+        const __m128 high = _mm256_cvtpd_ps(_mm256_loadu_pd(values + index + 4));
+        const __m256i raw = _mm256_castps_si256(_mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(buffer), _mm256_shuffle_epi8(raw, mask));
+    }
+    return mtsIGTLWriteFloat32ArraySSSE3(buffer, values + index, count - index);
+}
+
+__attribute__((target("avx2")))
+static const unsigned char * mtsIGTLReadFloat32ArrayAVX2(const unsigned char * buffer,
+                                                         double * values, const size_t count)
+{
+    const __m256i mask = _mm256_setr_epi8(MTS_IGTL_SWAP32, MTS_IGTL_SWAP32);
+    size_t index = 0;
+    for (; index + 8 <= count; index += 8, buffer += 32) {
+        const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer));
+        const __m256 floats = _mm256_castsi256_ps(_mm256_shuffle_epi8(raw, mask));
+        _mm256_storeu_pd(values + index, _mm256_cvtps_pd(_mm256_castps256_ps128(floats)));
+        _mm256_storeu_pd(values + index + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(floats, 1)));
+    }
+    return mtsIGTLReadFloat32ArraySSSE3(buffer, values + index, count - index);
+}
+
+#endif // MTS_IGTL_HAS_X86_SIMD
+
+// all kernels, SIMD entries use the scalar functions if not compiled
+class mtsIGTLArrayFunctions
+{
+public:
+    mtsIGTLWriteArrayFunction WriteFloat64;
+    mtsIGTLWriteArrayFunction WriteFloat32;
+    mtsIGTLReadArrayFunction ReadFloat32;
+};
+
+static const mtsIGTLArrayFunctions mtsIGTLArrayKernelTable[] = {
+    {mtsIGTLWriteFloat64ArrayScalar, mtsIGTLWriteFloat32ArrayScalar, mtsIGTLReadFloat32ArrayScalar},
+#ifdef MTS_IGTL_HAS_X86_SIMD
+    {mtsIGTLWriteFloat64ArraySSSE3, mtsIGTLWriteFloat32ArraySSSE3, mtsIGTLReadFloat32ArraySSSE3},
+    {mtsIGTLWriteFloat64ArrayAVX2, mtsIGTLWriteFloat32ArrayAVX2, mtsIGTLReadFloat32ArrayAVX2}
+#else
+    {mtsIGTLWriteFloat64ArrayScalar, mtsIGTLWriteFloat32ArrayScalar, mtsIGTLReadFloat32ArrayScalar},
+    {mtsIGTLWriteFloat64ArrayScalar, mtsIGTLWriteFloat32ArrayScalar, mtsIGTLReadFloat32ArrayScalar}
+#endif
+};
+
+bool mtsIGTLPackedMessage::ArrayKernelAvailable(const ArrayKernelType kernel)
+{
+    switch (kernel) {
+    case ARRAY_KERNEL_SCALAR:
+        return true;
+#ifdef MTS_IGTL_HAS_X86_SIMD
+    case ARRAY_KERNEL_SSSE3:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("ssse3");
+    case ARRAY_KERNEL_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+const char * mtsIGTLPackedMessage::ArrayKernelName(const ArrayKernelType kernel)
+{
+    switch (kernel) {
+    case ARRAY_KERNEL_SSSE3:
+        return "ssse3";
+    case ARRAY_KERNEL_AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+// kernel is selected once, based on CPU
+static mtsIGTLPackedMessage::ArrayKernelType mtsIGTLSelectArrayKernel(void)
+{
+    if (mtsIGTLPackedMessage::ArrayKernelAvailable(mtsIGTLPackedMessage::ARRAY_KERNEL_AVX2)) {
+        return mtsIGTLPackedMessage::ARRAY_KERNEL_AVX2;
+    }
+    if (mtsIGTLPackedMessage::ArrayKernelAvailable(mtsIGTLPackedMessage::ARRAY_KERNEL_SSSE3)) {
+        return mtsIGTLPackedMessage::ARRAY_KERNEL_SSSE3;
+    }
+    return mtsIGTLPackedMessage::ARRAY_KERNEL_SCALAR;
+}
+
+static const mtsIGTLPackedMessage::ArrayKernelType mtsIGTLArrayKernel = mtsIGTLSelectArrayKernel();
+
+static const mtsIGTLArrayFunctions & mtsIGTLArrayKernelFunctions(const mtsIGTLPackedMessage::ArrayKernelType kernel)
+{
+    return mtsIGTLPackedMessage::ArrayKernelAvailable(kernel) ?
+        mtsIGTLArrayKernelTable[kernel] : mtsIGTLArrayKernelTable[mtsIGTLPackedMessage::ARRAY_KERNEL_SCALAR];
+}
+
+mtsIGTLPackedMessage::ArrayKernelType mtsIGTLPackedMessage::GetArrayKernel(void)
+{
+    return mtsIGTLArrayKernel;
+}
+
+unsigned char * mtsIGTLPackedMessage::WriteFloat64Array(unsigned char * buffer,
+                                                        const double * values, const size_t count)
+{
+    return mtsIGTLArrayKernelTable[mtsIGTLArrayKernel].WriteFloat64(buffer, values, count);
+}
+
+unsigned char * mtsIGTLPackedMessage::WriteFloat32Array(unsigned char * buffer,
+                                                        const double * values, const size_t count)
+{
+    return mtsIGTLArrayKernelTable[mtsIGTLArrayKernel].WriteFloat32(buffer, values, count);
+}
+
+const unsigned char * mtsIGTLPackedMessage::ReadFloat32Array(const unsigned char * buffer,
+                                                             double * values, const size_t count)
+{
+    return mtsIGTLArrayKernelTable[mtsIGTLArrayKernel].ReadFloat32(buffer, values, count);
+}
+
+unsigned char * mtsIGTLPackedMessage::WriteFloat64Array(const ArrayKernelType kernel,
+                                                        unsigned char * buffer,
+                                                        const double * values, const size_t count)
+{
+    return mtsIGTLArrayKernelFunctions(kernel).WriteFloat64(buffer, values, count);
+}
+
+unsigned char * mtsIGTLPackedMessage::WriteFloat32Array(const ArrayKernelType kernel,
+                                                        unsigned char * buffer,
+                                                        const double * values, const size_t count)
+{
+    return mtsIGTLArrayKernelFunctions(kernel).WriteFloat32(buffer, values, count);
+}
+
+const unsigned char * mtsIGTLPackedMessage::ReadFloat32Array(const ArrayKernelType kernel,
+                                                             const unsigned char * buffer,
+                                                             double * values, const size_t count)
+{
+    return mtsIGTLArrayKernelFunctions(kernel).ReadFloat32(buffer, values, count);
+}
@@ -0,0 +1,85 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLPoseBatch.h>
+#include <sawOpenIGTLink/mtsIGTLPackedMessage.h>
+
+void mtsIGTLPoseBatch::Resize(const size_t nbPoses)
+{
+    mSize = nbPoses;
+    mComponents.resize(NB_COMPONENTS * nbPoses);
+    mWire.resize(NB_COMPONENTS * nbPoses * 4);
+}
+
+void mtsIGTLPoseBatch::Set(const size_t index, const vctFrm3 & pose)
+{
+    double * element = mComponents.data() + index;
+    for (size_t col = 0; col < 3; ++col) {
+        for (size_t row = 0; row < 3; ++row, element += mSize) {
+            *element = pose.Rotation().Element(row, col);
+        }
+    }
+    for (size_t row = 0; row < 3; ++row, element += mSize) {
+        *element = pose.Translation().Element(row);
+    }
+}
+
+void mtsIGTLPoseBatch::Get(const size_t index, vctFrm3 & pose) const
+{
+    const double * element = mComponents.data() + index;
+    for (size_t col = 0; col < 3; ++col) {
+        for (size_t row = 0; row < 3; ++row, element += mSize) {
+            pose.Rotation().Element(row, col) = *element;
+        }
+    }
+    for (size_t row = 0; row < 3; ++row, element += mSize) {
+        pose.Translation().Element(row) = *element;
+    }
+}
+
+void mtsIGTLPoseBatch::PackTransforms(unsigned char * const * bodies)
+{
+    // narrow and swap each component for all poses
+    for (size_t component = 0; component < NB_COMPONENTS; ++component) {
+        mtsIGTLPackedMessage::WriteFloat32Array(mWire.data() + component * mSize * 4,
+                                                Component(component), mSize);
+    }
+    // scatter to message bodies
+    for (size_t index = 0; index < mSize; ++index) {
+        unsigned char * body = bodies[index];
+        for (size_t component = 0; component < NB_COMPONENTS; ++component, body += 4) {
+            memcpy(body, mWire.data() + (component * mSize + index) * 4, 4);
+        }
+    }
+}
+
+void mtsIGTLPoseBatch::UnpackTransforms(const unsigned char * const * bodies)
+{
+    // gather from message bodies
+    for (size_t index = 0; index < mSize; ++index) {
+        const unsigned char * body = bodies[index];
+        for (size_t component = 0; component < NB_COMPONENTS; ++component, body += 4) {
+            memcpy(mWire.data() + (component * mSize + index) * 4, body, 4);
+        }
+    }
+    // swap and widen each component for all poses
+    for (size_t component = 0; component < NB_COMPONENTS; ++component) {
+        mtsIGTLPackedMessage::ReadFloat32Array(mWire.data() + component * mSize * 4,
+                                               Component(component), mSize);
+    }
+}
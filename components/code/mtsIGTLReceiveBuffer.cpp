@@ -0,0 +1,117 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLReceiveBuffer.h>
+#include <sawOpenIGTLink/mtsIGTLCRC64.h>
+
+#include <algorithm>
+#include <cstring>
+
+mtsIGTLReceiveBuffer::mtsIGTLReceiveBuffer(const size_t capacity):
+    mBuffer(capacity),
+    mHead(0),
+    mSize(0)
+{
+}
+
+unsigned char * mtsIGTLReceiveBuffer::WritePointer(size_t & contiguousSize)
+{
+    const size_t capacity = mBuffer.size();
+    if (mSize == capacity) {
+        contiguousSize = 0;
+        return nullptr;
+    }
+    const size_t tail = (mHead + mSize) % capacity;
+    // free space either goes to the end of the buffer or to the head
+    contiguousSize = (tail >= mHead) ? (capacity - tail) : (mHead - tail);
+    return mBuffer.data() + tail;
+}
+
+void mtsIGTLReceiveBuffer::CommitWrite(const size_t nbBytes)
+{
+    mSize = std::min(mSize + nbBytes, mBuffer.size());
+}
+
+void mtsIGTLReceiveBuffer::Write(const void * source, const size_t nbBytes)
+{
+    if (mSize + nbBytes > mBuffer.size()) {
+        Reserve(std::max(mSize + nbBytes, 2 * mBuffer.size()));
+    }
+    // copy in up to two parts if the free space wraps around
+    const unsigned char * input = static_cast<const unsigned char *>(source);
+    size_t remaining = nbBytes;
+    while (remaining > 0) {
+        size_t contiguousSize;
+        unsigned char * output = WritePointer(contiguousSize);
+        const size_t size = std::min(remaining, contiguousSize);
+        memcpy(output, input, size);
+        CommitWrite(size);
+        input += size;
+        remaining -= size;
+    }
+}
+
+bool mtsIGTLReceiveBuffer::Peek(void * destination, const size_t nbBytes) const
+{
+    if (nbBytes > mSize) {
+        return false;
+    }
+    // copy in up to two parts if the data wraps around
+    const size_t first = std::min(nbBytes, mBuffer.size() - mHead);
+    unsigned char * output = static_cast<unsigned char *>(destination);
+    memcpy(output, mBuffer.data() + mHead, first);
+    memcpy(output + first, mBuffer.data(), nbBytes - first);
+    return true;
+}
+
+bool mtsIGTLReceiveBuffer::Read(void * destination, const size_t nbBytes)
+{
+    return Peek(destination, nbBytes) && Skip(nbBytes);
+}
+
+bool mtsIGTLReceiveBuffer::Skip(const size_t nbBytes)
+{
+    if (nbBytes > mSize) {
+        return false;
+    }
+    mSize -= nbBytes;
+    // rewind when empty so reads are as large as possible
+    mHead = (mSize == 0) ? 0 : (mHead + nbBytes) % mBuffer.size();
+    return true;
+}
+
+unsigned long long mtsIGTLReceiveBuffer::CRC64(const size_t nbBytes) const
+{
+    // compute in up to two parts if the data wraps around
+    const size_t size = std::min(nbBytes, mSize);
+    const size_t first = std::min(size, mBuffer.size() - mHead);
+    const unsigned long long crc = mtsIGTLCRC64(mBuffer.data() + mHead, first);
+    return mtsIGTLCRC64(mBuffer.data(), size - first, crc);
+}
+
+void mtsIGTLReceiveBuffer::Reserve(const size_t capacity)
+{
+    if (capacity <= mBuffer.size()) {
+        return;
+    }
+    // linearize data at the beginning of the new buffer
+    std::vector<unsigned char> newBuffer(capacity);
+    Peek(newBuffer.data(), mSize);
+    mBuffer.swap(newBuffer);
+    mHead = 0;
+}
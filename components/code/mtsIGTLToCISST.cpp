@@ -18,6 +18,8 @@ http://www.cisst.org/cisst/license.txt.
 
 #include <sawOpenIGTLink/mtsIGTLToCISST.h>
 
+#include <cisstVector/vctQuaternionRotation3.h>
+
 bool mtsIGTLToCISST(const igtl::StringMessage::Pointer igtlData,
                     std::string & cisstData)
 {
@@ -72,6 +74,28 @@ bool mtsIGTLToCISST(const igtl::TransformMessage::Pointer igtlData,
     return false;
 }
 
+bool mtsIGTLToCISST(const igtl::PositionMessage::Pointer igtlData,
+                    prmPositionCartesianSet & cisstData)
+{
+    float position[3];
+    igtlData->GetPosition(position);
+    cisstData.Goal().Translation().Element(0) = position[0];
+    cisstData.Goal().Translation().Element(1) = position[1];
+    cisstData.Goal().Translation().Element(2) = position[2];
+
+    // message might not contain a quaternion, GetQuaternion then
+    // returns identity
+    float quaternion[4];
+    igtlData->GetQuaternion(quaternion);
+    vctQuatRot3 rotation(quaternion[0], quaternion[1], quaternion[2], quaternion[3],
+                         VCT_DO_NOT_NORMALIZE);
+    rotation.NormalizedSelf();
+    cisstData.Goal().Rotation().FromRaw(rotation);
+
+    cisstData.SetValid(true);
+    return true;
+}
+
 bool mtsIGTLToCISST(const igtl::SensorMessage::Pointer igtlData,
                     prmForceCartesianSet & cisstData)
 {
@@ -92,10 +116,91 @@ bool mtsIGTLToCISST(const igtl::SensorMessage::Pointer igtlData,
     return false;
 }
 
+// access element of float32 or float64 array, returns false for
+// other scalar types
+static bool mtsIGTLToCISSTArrayValues(const igtl::NDArrayMessage::Pointer igtlData,
+                                      vctDoubleVec & values)
+{
+    igtl::ArrayBase * array = igtlData->GetArray();
+    if (!array) {
+        return false;
+    }
+    const size_t nbElements = array->GetNumberOfElements();
+    values.SetSize(nbElements);
+    switch (igtlData->GetType()) {
+    case igtl::NDArrayMessage::TYPE_FLOAT32:
+        {
+            const igtl_float32 * raw = static_cast<igtl_float32 *>(array->GetRawArray());
+            for (size_t index = 0; index < nbElements; ++index) {
+                values.Element(index) = raw[index];
+            }
+        }
+        return true;
+    case igtl::NDArrayMessage::TYPE_FLOAT64:
+        {
+            const igtl_float64 * raw = static_cast<igtl_float64 *>(array->GetRawArray());
+            for (size_t index = 0; index < nbElements; ++index) {
+                values.Element(index) = raw[index];
+            }
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool mtsIGTLToCISST(const igtl::NDArrayMessage::Pointer igtlData,
+                    prmPositionJointSet & cisstData)
+{
+    if (!mtsIGTLToCISSTArrayValues(igtlData, cisstData.Goal())) {
+        return false;
+    }
+    cisstData.SetValid(true);
+    return true;
+}
+
+bool mtsIGTLToCISST(const igtl::NDArrayMessage::Pointer igtlData,
+                    prmStateJoint & cisstData)
+{
+    igtl::ArrayBase * array = igtlData->GetArray();
+    if (!array) {
+        return false;
+    }
+    const igtl::ArrayBase::IndexType size = array->GetSize();
+    if ((size.size() != 2) || (size[0] != 6)) {
+        return false;
+    }
+    vctDoubleVec values;
+    if (!mtsIGTLToCISSTArrayValues(igtlData, values)) {
+        return false;
+    }
+    // rows are pos_flag/pos/vel_flag/vel/effort_flag/effort
+    const size_t nbJoints = size[1];
+    vctDoubleVec * vectors[3] = {&(cisstData.Position()),
+                                 &(cisstData.Velocity()),
+                                 &(cisstData.Effort())};
+    for (size_t index = 0; index < 3; ++index) {
+        const double * flag = values.Pointer() + (2 * index) * nbJoints;
+        if ((nbJoints != 0) && (flag[0] != 0.0)) {
+            vectors[index]->SetSize(nbJoints);
+            for (size_t joint = 0; joint < nbJoints; ++joint) {
+                vectors[index]->Element(joint) = flag[nbJoints + joint];
+            }
+        } else {
+            vectors[index]->SetSize(0);
+        }
+    }
+    cisstData.SetValid(true);
+    return true;
+}
+
 bool mtsIGTLToCISST(const igtl::PointMessage::Pointer igtlData, vct3 &cisstData)
 {
+    if (igtlData->GetNumberOfPointElement() < 1) {
+        return false;
+    }
+    // GetPointElement assigns the element from the message, no need to allocate
     igtl::PointElement::Pointer p;
-    p = igtl::PointElement::New();
     igtlData->GetPointElement(0, p);
     float x, y, z;
     p->GetPosition(x, y, z);
@@ -104,3 +209,48 @@ bool mtsIGTLToCISST(const igtl::PointMessage::Pointer igtlData, vct3 &cisstData)
     cisstData[2] = z;
     return true;
 }
+
+template <typename _pointsType>
+static bool mtsIGTLToCISSTPoints(const igtl::PointMessage::Pointer igtlData,
+                                 _pointsType & cisstData)
+{
+    const int nbPoints = igtlData->GetNumberOfPointElement();
+    cisstData.resize(nbPoints);
+    igtl::PointElement::Pointer p;
+    float position[3];
+    for (int index = 0; index < nbPoints; ++index) {
+        igtlData->GetPointElement(index, p);
+        p->GetPosition(position);
+        cisstData[index].Assign(position[0], position[1], position[2]);
+    }
+    return true;
+}
+
+bool mtsIGTLToCISST(const igtl::PointMessage::Pointer igtlData,
+                    std::vector<vct3> & cisstData)
+{
+    return mtsIGTLToCISSTPoints(igtlData, cisstData);
+}
+
+bool mtsIGTLToCISST(const igtl::PointMessage::Pointer igtlData,
+                    vctDynamicVector<vct3> & cisstData)
+{
+    return mtsIGTLToCISSTPoints(igtlData, cisstData);
+}
+
+bool mtsIGTLToCISST(const igtl::PointMessage::Pointer igtlData,
+                    vctDoubleMat & cisstData)
+{
+    const int nbPoints = igtlData->GetNumberOfPointElement();
+    cisstData.SetSize(nbPoints, 3);
+    igtl::PointElement::Pointer p;
+    float position[3];
+    for (int index = 0; index < nbPoints; ++index) {
+        igtlData->GetPointElement(index, p);
+        p->GetPosition(position);
+        cisstData.Element(index, 0) = position[0];
+        cisstData.Element(index, 1) = position[1];
+        cisstData.Element(index, 2) = position[2];
+    }
+    return true;
+}
@@ -0,0 +1,122 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLTrace.h>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+mtsIGTLTrace::mtsIGTLTrace(void):
+    mEnabled(false),
+    mNext(0),
+    mCount(0)
+{
+}
+
+void mtsIGTLTrace::SetSize(const size_t nbEvents)
+{
+    mEvents.resize(nbEvents);
+    mNext = 0;
+    mCount = 0;
+    mEnabled = (nbEvents != 0);
+}
+
+void mtsIGTLTrace::AddEvent(const char * name, const char * detail,
+                            const double & start, const double & end)
+{
+    Event & event = mEvents[mNext];
+    event.Name = name;
+    strncpy(event.Detail, detail, DETAIL_SIZE - 1);
+    event.Detail[DETAIL_SIZE - 1] = '\0';
+    event.Start = start;
+    event.Duration = end - start;
+    mNext = (mNext + 1) % mEvents.size();
+    if (mCount < mEvents.size()) {
+        ++mCount;
+    }
+}
+
+// device names and process name come from users/clients, quotes,
+// backslashes and control characters must be escaped
+static void mtsIGTLTraceWriteJSONString(std::ostream & output, const char * text)
+{
+    output << '"';
+    for (const char * c = text; *c != '\0'; ++c) {
+        const unsigned char character = static_cast<unsigned char>(*c);
+        switch (character) {
+        case '"':
+            output << "\\\"";
+            break;
+        case '\\':
+            output << "\\\\";
+            break;
+        case '\n':
+            output << "\\n";
+            break;
+        case '\r':
+            output << "\\r";
+            break;
+        case '\t':
+            output << "\\t";
+            break;
+        default:
+            if (character < 0x20) {
+                const char * hex = "0123456789abcdef";
+                output << "\\u00" << hex[character >> 4] << hex[character & 0x0F];
+            } else {
+                output << *c;
+            }
+        }
+    }
+    output << '"';
+}
+
+bool mtsIGTLTrace::SaveChromeTrace(const std::string & fileName,
+                                   const std::string & processName) const
+{
+    std::ofstream output(fileName.c_str());
+    if (!output.is_open()) {
+        return false;
+    }
+    output << "{\"traceEvents\": [" << std::endl
+           << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": ";
+    mtsIGTLTraceWriteJSONString(output, processName.c_str());
+    output << "}}";
+    // oldest event is at mNext if the buffer has wrapped
+    const size_t size = mEvents.size();
+    const size_t first = (mCount < size) ? 0 : mNext;
+    output << std::fixed << std::setprecision(3);
+    for (size_t index = 0; index < mCount; ++index) {
+        const Event & event = mEvents[(first + index) % size];
+        // timestamps and durations are in micro seconds
+        output << "," << std::endl
+               << "{\"name\": ";
+        mtsIGTLTraceWriteJSONString(output, event.Name);
+        output << ", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": " << event.Start * 1.0e6
+               << ", \"dur\": " << event.Duration * 1.0e6;
+        if (event.Detail[0] != '\0') {
+            output << ", \"args\": {\"detail\": ";
+            mtsIGTLTraceWriteJSONString(output, event.Detail);
+            output << "}";
+        }
+        output << "}";
+    }
+    output << std::endl << "]}" << std::endl;
+    return true;
+}
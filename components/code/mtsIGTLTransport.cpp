@@ -0,0 +1,632 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLTransport.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <cisstCommon/cmnPortability.h>
+#include <cisstOSAbstraction/osaGetTime.h>
+
+#if (CISST_OS == CISST_WINDOWS)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sawOpenIGTLink/mtsIGTLUnixSocket.h>
+#endif
+
+// flags for non blocking sends, no SIGPIPE if the client is gone
+#if defined(MSG_DONTWAIT) && defined(MSG_NOSIGNAL)
+static const int mtsIGTLSendFlags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#elif defined(MSG_DONTWAIT)
+static const int mtsIGTLSendFlags = MSG_DONTWAIT;
+#else
+static const int mtsIGTLSendFlags = 0;
+#endif
+
+// flags for non blocking receives
+#if defined(MSG_DONTWAIT)
+static const int mtsIGTLReceiveFlags = MSG_DONTWAIT;
+#else
+static const int mtsIGTLReceiveFlags = 0;
+#endif
+
+static bool mtsIGTLWouldBlock(void)
+{
+#if (CISST_OS == CISST_WINDOWS)
+    return (WSAGetLastError() == WSAEWOULDBLOCK);
+#else
+    return ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR));
+#endif
+}
+
+static void mtsIGTLCloseSocket(const int descriptor)
+{
+#if (CISST_OS == CISST_WINDOWS)
+    closesocket(descriptor);
+#else
+    close(descriptor);
+#endif
+}
+
+static bool mtsIGTLSetBlocking(const int descriptor, const bool blocking)
+{
+#if (CISST_OS == CISST_WINDOWS)
+    u_long mode = blocking ? 0 : 1;
+    return (ioctlsocket(descriptor, FIONBIO, &mode) == 0);
+#else
+    const int flags = fcntl(descriptor, F_GETFL, 0);
+    return (fcntl(descriptor, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK)) == 0);
+#endif
+}
+
+bool mtsIGTLConnection::Selectable(const int descriptor)
+{
+#if (CISST_OS == CISST_WINDOWS)
+    // fd_set is a list of sockets, not a bit mask indexed by descriptor
+    return (descriptor >= 0);
+#else
+    return (descriptor >= 0) && (descriptor < FD_SETSIZE);
+#endif
+}
+
+mtsIGTLSocketConnection::mtsIGTLSocketConnection(const int descriptor,
+                                                 const std::string & name):
+    mtsIGTLConnection(name),
+    mDescriptor(descriptor)
+{
+}
+
+mtsIGTLSocketConnection::~mtsIGTLSocketConnection()
+{
+    mtsIGTLCloseSocket(mDescriptor);
+}
+
+int mtsIGTLSocketConnection::GetDescriptor(void) const
+{
+    return mDescriptor;
+}
+
+long long mtsIGTLSocketConnection::Receive(unsigned char * data, const size_t size)
+{
+    const auto nbBytes = recv(mDescriptor, reinterpret_cast<char *>(data),
+                              static_cast<int>(size), mtsIGTLReceiveFlags);
+    if (nbBytes == 0) {
+        return -1;
+    }
+    if (nbBytes < 0) {
+        return mtsIGTLWouldBlock() ? 0 : -1;
+    }
+    return nbBytes;
+}
+
+long long mtsIGTLSocketConnection::Send(const unsigned char * data, const size_t size)
+{
+    // check the socket is writable, send might block without
+    // MSG_DONTWAIT, which is available where descriptors can't be
+    // selected
+    if (Selectable(mDescriptor)) {
+        fd_set writeSet;
+        FD_ZERO(&writeSet);
+        FD_SET(mDescriptor, &writeSet);
+        struct timeval timeout = {0, 0};
+        const int ready = select(mDescriptor + 1, nullptr, &writeSet, nullptr, &timeout);
+        if (ready < 0) {
+            return -1;
+        }
+        if (ready == 0) {
+            return 0;
+        }
+    }
+    const auto nbBytes = send(mDescriptor, reinterpret_cast<const char *>(data),
+                              static_cast<int>(size), mtsIGTLSendFlags);
+    if (nbBytes < 0) {
+        return mtsIGTLWouldBlock() ? 0 : -1;
+    }
+    return nbBytes;
+}
+
+void mtsIGTLSocketConnection::Shutdown(void)
+{
+#if (CISST_OS == CISST_WINDOWS)
+    shutdown(mDescriptor, SD_BOTH);
+#else
+    shutdown(mDescriptor, SHUT_RDWR);
+#endif
+}
+
+mtsIGTLTCPListener::mtsIGTLTCPListener(void):
+    mDescriptor(-1)
+{
+}
+
+mtsIGTLTCPListener::~mtsIGTLTCPListener()
+{
+    if (mDescriptor >= 0) {
+        mtsIGTLCloseSocket(mDescriptor);
+    }
+}
+
+bool mtsIGTLTCPListener::Create(const int port)
+{
+    if (mDescriptor >= 0) {
+        mtsIGTLCloseSocket(mDescriptor);
+    }
+    mDescriptor = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+    if (mDescriptor < 0) {
+        return false;
+    }
+    // allow restart while old connections are in TIME_WAIT
+    int reuse = 1;
+    setsockopt(mDescriptor, SOL_SOCKET, SO_REUSEADDR,
+               reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<unsigned short>(port));
+    if ((bind(mDescriptor, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0)
+        || (listen(mDescriptor, SOMAXCONN) != 0)
+        || !mtsIGTLSetBlocking(mDescriptor, false)) {
+        mtsIGTLCloseSocket(mDescriptor);
+        mDescriptor = -1;
+        return false;
+    }
+    return true;
+}
+
+mtsIGTLConnection * mtsIGTLTCPListener::Accept(void)
+{
+    if (mDescriptor < 0) {
+        return nullptr;
+    }
+    struct sockaddr_in address;
+    socklen_t length = sizeof(address);
+    const int descriptor = static_cast<int>(accept(mDescriptor,
+                                                   reinterpret_cast<struct sockaddr *>(&address),
+                                                   &length));
+    if (descriptor < 0) {
+        return nullptr;
+    }
+    // some systems inherit non blocking mode from the listening socket
+    mtsIGTLSetBlocking(descriptor, true);
+    char name[INET_ADDRSTRLEN] = "";
+    inet_ntop(AF_INET, &(address.sin_addr), name, sizeof(name));
+    return new mtsIGTLSocketConnection(descriptor, std::string(name) + ":"
+                                       + std::to_string(ntohs(address.sin_port)));
+}
+
+mtsIGTLUnixListener::mtsIGTLUnixListener(void):
+    mDescriptor(-1),
+    mConnections(0)
+{
+}
+
+mtsIGTLUnixListener::~mtsIGTLUnixListener()
+{
+#if (CISST_OS != CISST_WINDOWS)
+    mtsIGTLUnixSocket::Close(mDescriptor, mPath, mDevice, mInode);
+#endif
+}
+
+bool mtsIGTLUnixListener::Create(const std::string & path)
+{
+#if (CISST_OS != CISST_WINDOWS)
+    mtsIGTLUnixSocket::Close(mDescriptor, mPath, mDevice, mInode);
+    mDescriptor = mtsIGTLUnixSocket::Listen(path, mDevice, mInode);
+    mPath = path;
+    return (mDescriptor >= 0);
+#else
+    return false;
+#endif
+}
+
+mtsIGTLConnection * mtsIGTLUnixListener::Accept(void)
+{
+#if (CISST_OS != CISST_WINDOWS)
+    if (mDescriptor < 0) {
+        return nullptr;
+    }
+    const int descriptor = mtsIGTLUnixSocket::Accept(mDescriptor);
+    if (descriptor < 0) {
+        return nullptr;
+    }
+    ++mConnections;
+    return new mtsIGTLSocketConnection(descriptor, "unix:" + mPath + ":"
+                                       + std::to_string(mConnections));
+#else
+    return nullptr;
+#endif
+}
+
+static bool mtsIGTLConnectInProgress(void)
+{
+#if (CISST_OS == CISST_WINDOWS)
+    return (WSAGetLastError() == WSAEWOULDBLOCK);
+#else
+    return (errno == EINPROGRESS);
+#endif
+}
+
+// connection returned by mtsIGTLTCPConnector, lets the connector know
+// when the bridge deletes it
+class mtsIGTLConnectorConnection: public mtsIGTLSocketConnection
+{
+public:
+    mtsIGTLConnectorConnection(const int descriptor,
+                               const std::string & name,
+                               std::shared_ptr<bool> connected):
+        mtsIGTLSocketConnection(descriptor, name),
+        mConnected(connected) {
+        *mConnected = true;
+    }
+
+    ~mtsIGTLConnectorConnection() {
+        *mConnected = false;
+    }
+
+protected:
+    std::shared_ptr<bool> mConnected;
+};
+
+mtsIGTLTCPConnector::mtsIGTLTCPConnector(void):
+    mDescriptor(-1),
+    mConnected(std::make_shared<bool>(false)),
+    mNextAttempt(0.0)
+{
+}
+
+mtsIGTLTCPConnector::~mtsIGTLTCPConnector()
+{
+    if (mDescriptor >= 0) {
+        mtsIGTLCloseSocket(mDescriptor);
+    }
+}
+
+bool mtsIGTLTCPConnector::ParseAddress(const std::string & address,
+                                       std::string & host, int & port)
+{
+    size_t colon;
+    if (!address.empty() && (address[0] == '[')) {
+        const size_t bracket = address.find(']');
+        if ((bracket == std::string::npos)
+            || (bracket + 1 >= address.size())
+            || (address[bracket + 1] != ':')) {
+            return false;
+        }
+        host = address.substr(1, bracket - 1);
+        colon = bracket + 1;
+    } else {
+        colon = address.rfind(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+        host = address.substr(0, colon);
+        // IPv6 address without brackets, port is ambiguous
+        if (host.find(':') != std::string::npos) {
+            return false;
+        }
+    }
+    const char * start = address.c_str() + colon + 1;
+    char * end = nullptr;
+    const long value = strtol(start, &end, 10);
+    if (host.empty() || (end == start) || (*end != '\0')
+        || (value <= 0) || (value > 65535)) {
+        return false;
+    }
+    port = static_cast<int>(value);
+    return true;
+}
+
+bool mtsIGTLTCPConnector::Create(const std::string & host, const int port)
+{
+    mHost = host;
+    mPort = port;
+    mName = ((host.find(':') == std::string::npos) ? host : ("[" + host + "]"))
+        + ":" + std::to_string(port);
+    mAttempts = 0;
+    return Resolve();
+}
+
+bool mtsIGTLTCPConnector::Resolve(void)
+{
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo * result = nullptr;
+    if ((getaddrinfo(mHost.c_str(), std::to_string(mPort).c_str(), &hints, &result) != 0)
+        || !result) {
+        return false;
+    }
+    // e.g. localhost resolves to ::1 and 127.0.0.1, use them in turn
+    size_t nbAddresses = 0;
+    for (const struct addrinfo * info = result; info; info = info->ai_next) {
+        ++nbAddresses;
+    }
+    const struct addrinfo * info = result;
+    for (size_t index = mAttempts % nbAddresses; index > 0; --index) {
+        info = info->ai_next;
+    }
+    const unsigned char * address = reinterpret_cast<const unsigned char *>(info->ai_addr);
+    mAddress.assign(address, address + info->ai_addrlen);
+    freeaddrinfo(result);
+    return true;
+}
+
+void mtsIGTLTCPConnector::Retry(void)
+{
+    if (mDescriptor >= 0) {
+        mtsIGTLCloseSocket(mDescriptor);
+        mDescriptor = -1;
+    }
+    ++mAttempts;
+    mNextAttempt = osaGetTime() + mDelay;
+    mDelay = std::min(2.0 * mDelay, mMaximumDelay);
+}
+
+mtsIGTLConnection * mtsIGTLTCPConnector::Accept(void)
+{
+    // connected, reconnect once the bridge closes the connection
+    if (*mConnected || mHost.empty()) {
+        return nullptr;
+    }
+    if (mDescriptor < 0) {
+        if (osaGetTime() < mNextAttempt) {
+            return nullptr;
+        }
+        // the server address might have changed since last attempt
+        if (!Resolve()) {
+            Retry();
+            return nullptr;
+        }
+        const struct sockaddr * address = reinterpret_cast<const struct sockaddr *>(mAddress.data());
+        mDescriptor = static_cast<int>(socket(address->sa_family, SOCK_STREAM, 0));
+        if (mDescriptor < 0) {
+            Retry();
+            return nullptr;
+        }
+        // completion is checked with select
+        if (!mtsIGTLConnection::Selectable(mDescriptor)
+            || !mtsIGTLSetBlocking(mDescriptor, false)) {
+            Retry();
+            return nullptr;
+        }
+        mAttemptStart = osaGetTime();
+        if (connect(mDescriptor, address, static_cast<socklen_t>(mAddress.size())) != 0) {
+            if (!mtsIGTLConnectInProgress()) {
+                Retry();
+            }
+            // completion checked on next calls
+            return nullptr;
+        }
+    } else {
+        // check if connect completed, Windows reports failures in
+        // the exception set instead of the write set
+        fd_set writeSet;
+        FD_ZERO(&writeSet);
+        FD_SET(mDescriptor, &writeSet);
+        fd_set exceptSet;
+        FD_ZERO(&exceptSet);
+#if (CISST_OS == CISST_WINDOWS)
+        FD_SET(mDescriptor, &exceptSet);
+#endif
+        struct timeval timeout = {0, 0};
+        const int ready = select(mDescriptor + 1, nullptr, &writeSet, &exceptSet, &timeout);
+        if (ready == 0) {
+            // no answer, e.g. packets dropped by a firewall
+            if ((mConnectTimeout > 0.0)
+                && ((osaGetTime() - mAttemptStart) >= mConnectTimeout)) {
+                Retry();
+            }
+            return nullptr;
+        }
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if ((ready < 0)
+            || FD_ISSET(mDescriptor, &exceptSet)
+            || (getsockopt(mDescriptor, SOL_SOCKET, SO_ERROR,
+                           reinterpret_cast<char *>(&error), &length) != 0)
+            || (error != 0)) {
+            Retry();
+            return nullptr;
+        }
+    }
+    // connected, same blocking mode as accepted connections
+    mtsIGTLSetBlocking(mDescriptor, true);
+    const int descriptor = mDescriptor;
+    mDescriptor = -1;
+    mDelay = mInitialDelay;
+    mNextAttempt = 0.0;
+    return new mtsIGTLConnectorConnection(descriptor, mName, mConnected);
+}
+
+mtsIGTLMemoryListener::mtsIGTLMemoryListener(const size_t capacity):
+    mCapacity(capacity)
+{
+}
+
+mtsIGTLMemoryListener::~mtsIGTLMemoryListener()
+{
+    for (auto & connection : mPending) {
+        delete connection;
+    }
+}
+
+mtsIGTLConnection * mtsIGTLMemoryListener::Connect(const std::string & name)
+{
+    mtsIGTLMemoryConnection::PipePointer toBridge = std::make_shared<mtsIGTLMemoryConnection::Pipe>();
+    mtsIGTLMemoryConnection::PipePointer toClient = std::make_shared<mtsIGTLMemoryConnection::Pipe>();
+    toBridge->Capacity = mCapacity;
+    toClient->Capacity = mCapacity;
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPending.push_back(new mtsIGTLMemoryConnection("memory:" + name, toBridge, toClient));
+    return new mtsIGTLMemoryConnection("memory:" + name, toClient, toBridge);
+}
+
+mtsIGTLConnection * mtsIGTLMemoryListener::Accept(void)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mPending.empty()) {
+        return nullptr;
+    }
+    mtsIGTLConnection * connection = mPending.front();
+    mPending.pop_front();
+    return connection;
+}
+
+mtsIGTLMemoryConnection::mtsIGTLMemoryConnection(const std::string & name,
+                                                 PipePointer in, PipePointer out):
+    mtsIGTLConnection(name),
+    mIn(in),
+    mOut(out)
+{
+}
+
+mtsIGTLMemoryConnection::~mtsIGTLMemoryConnection()
+{
+    Shutdown();
+    // wakeup might be deleted after this connection
+    std::lock_guard<std::mutex> lock(mIn->Mutex);
+    mIn->Wakeup = nullptr;
+}
+
+long long mtsIGTLMemoryConnection::Receive(unsigned char * data, const size_t size)
+{
+    std::lock_guard<std::mutex> lock(mIn->Mutex);
+    const size_t available = mIn->Data.size() - mIn->Start;
+    if (available == 0) {
+        return mIn->Closed ? -1 : 0;
+    }
+    const size_t nbBytes = std::min(size, available);
+    memcpy(data, mIn->Data.data() + mIn->Start, nbBytes);
+    mIn->Start += nbBytes;
+    // everything read, reuse the buffer from the beginning
+    if (mIn->Start == mIn->Data.size()) {
+        mIn->Data.clear();
+        mIn->Start = 0;
+    }
+    return static_cast<long long>(nbBytes);
+}
+
+long long mtsIGTLMemoryConnection::Send(const unsigned char * data, const size_t size)
+{
+    std::lock_guard<std::mutex> lock(mOut->Mutex);
+    if (mOut->Closed) {
+        return -1;
+    }
+    const size_t used = mOut->Data.size() - mOut->Start;
+    const size_t nbBytes = std::min(size, mOut->Capacity - std::min(used, mOut->Capacity));
+    if (nbBytes == 0) {
+        return 0;
+    }
+    // reclaim space already read once it's more than half the buffer
+    if (mOut->Start > used) {
+        mOut->Data.erase(mOut->Data.begin(), mOut->Data.begin() + mOut->Start);
+        mOut->Start = 0;
+    }
+    mOut->Data.insert(mOut->Data.end(), data, data + nbBytes);
+    if (mOut->Wakeup) {
+        mOut->Wakeup->Signal();
+    }
+    return static_cast<long long>(nbBytes);
+}
+
+void mtsIGTLMemoryConnection::Shutdown(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(mIn->Mutex);
+        mIn->Closed = true;
+    }
+    std::lock_guard<std::mutex> lock(mOut->Mutex);
+    mOut->Closed = true;
+    // other end finds out the connection is closed
+    if (mOut->Wakeup) {
+        mOut->Wakeup->Signal();
+    }
+}
+
+bool mtsIGTLMemoryConnection::SetWakeup(mtsIGTLWakeup * wakeup)
+{
+    std::lock_guard<std::mutex> lock(mIn->Mutex);
+    mIn->Wakeup = wakeup;
+    // data sent before
+    if (wakeup && ((mIn->Data.size() > mIn->Start) || mIn->Closed)) {
+        wakeup->Signal();
+    }
+    return true;
+}
+
+mtsIGTLWakeup::mtsIGTLWakeup(void):
+    mSignaled(false)
+{
+    mDescriptors[0] = -1;
+    mDescriptors[1] = -1;
+#if (CISST_OS != CISST_WINDOWS)
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, mDescriptors) != 0) {
+        mDescriptors[0] = -1;
+        mDescriptors[1] = -1;
+        return;
+    }
+    fcntl(mDescriptors[0], F_SETFL, fcntl(mDescriptors[0], F_GETFL) | O_NONBLOCK);
+    fcntl(mDescriptors[1], F_SETFL, fcntl(mDescriptors[1], F_GETFL) | O_NONBLOCK);
+#endif
+}
+
+mtsIGTLWakeup::~mtsIGTLWakeup()
+{
+#if (CISST_OS != CISST_WINDOWS)
+    if (mDescriptors[0] >= 0) {
+        close(mDescriptors[0]);
+        close(mDescriptors[1]);
+    }
+#endif
+}
+
+void mtsIGTLWakeup::Signal(void)
+{
+#if (CISST_OS != CISST_WINDOWS)
+    if ((mDescriptors[1] >= 0) && !mSignaled.exchange(true)) {
+        const char byte = 0;
+        // socket full means the bridge will wake up anyway
+        const auto result = send(mDescriptors[1], &byte, 1, mtsIGTLSendFlags);
+        (void)result;
+    }
+#endif
+}
+
+void mtsIGTLWakeup::Clear(void)
+{
+#if (CISST_OS != CISST_WINDOWS)
+    if ((mDescriptors[0] >= 0) && mSignaled.exchange(false)) {
+        char buffer[64];
+        while (recv(mDescriptors[0], buffer, sizeof(buffer), mtsIGTLReceiveFlags) > 0) {
+        }
+    }
+#endif
+}
@@ -0,0 +1,322 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIGTLUring.h"
+
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+
+mtsIGTLUring::mtsIGTLUring(void):
+    mInitialized(false),
+    mZeroCopy(true),
+    mZeroCopyWorks(false),
+    mZeroCopyThreshold(0),
+    mPollInFlight(nullptr)
+{
+}
+
+mtsIGTLUring::~mtsIGTLUring()
+{
+    if (mInitialized) {
+        io_uring_queue_exit(&mRing);
+    }
+    // requests in flight can be deleted once the ring is closed
+    for (auto & request : mReceivesInFlight) {
+        delete request.second;
+    }
+    for (auto & request : mSendsInFlight) {
+        delete request.second;
+    }
+    for (auto & request : mCompleted) {
+        delete request;
+    }
+    delete mPollInFlight;
+}
+
+bool mtsIGTLUring::Init(const unsigned int entries,
+                        const size_t nbBuffers, const size_t bufferSize,
+                        const size_t zeroCopyThreshold)
+{
+    if (io_uring_queue_init(entries, &mRing, 0) < 0) {
+        return false;
+    }
+    mInitialized = true;
+    mZeroCopyThreshold = zeroCopyThreshold;
+
+    // buffers used for receives, registration is optional
+    mBuffers.resize(nbBuffers);
+    std::vector<struct iovec> iovecs(nbBuffers);
+    for (size_t index = 0; index < nbBuffers; ++index) {
+        mBuffers[index].resize(bufferSize);
+        iovecs[index].iov_base = mBuffers[index].data();
+        iovecs[index].iov_len = bufferSize;
+    }
+    if ((nbBuffers > 0)
+        && (io_uring_register_buffers(&mRing, iovecs.data(), static_cast<unsigned int>(nbBuffers)) == 0)) {
+        for (size_t index = nbBuffers; index > 0; --index) {
+            mFreeSlots.push_back(static_cast<int>(index - 1));
+        }
+    }
+    return true;
+}
+
+struct io_uring_sqe * mtsIGTLUring::GetSQE(void)
+{
+    struct io_uring_sqe * sqe = io_uring_get_sqe(&mRing);
+    if (!sqe) {
+        // submission queue full, submit what we have and retry
+        io_uring_submit(&mRing);
+        sqe = io_uring_get_sqe(&mRing);
+    }
+    return sqe;
+}
+
+bool mtsIGTLUring::Receive(const unsigned int id, const int descriptor)
+{
+    if (mReceivesInFlight.find(id) != mReceivesInFlight.end()) {
+        return true;
+    }
+    struct io_uring_sqe * sqe = GetSQE();
+    if (!sqe) {
+        return false;
+    }
+    Request * request = new Request;
+    request->Operation = RECEIVE;
+    request->Id = id;
+    request->Descriptor = descriptor;
+
+    // get a registered buffer for this client if any is left
+    auto slot = mSlots.find(id);
+    if (slot == mSlots.end() && !mFreeSlots.empty()) {
+        slot = mSlots.insert(std::make_pair(id, mFreeSlots.back())).first;
+        mFreeSlots.pop_back();
+    }
+    if (slot != mSlots.end()) {
+        request->Slot = slot->second;
+        std::vector<unsigned char> & buffer = mBuffers[request->Slot];
+        io_uring_prep_read_fixed(sqe, descriptor, buffer.data(),
+                                 static_cast<unsigned int>(buffer.size()), 0, request->Slot);
+    } else {
+        request->Data.resize(mBuffers.empty() ? 64 * 1024 : mBuffers.front().size());
+        io_uring_prep_recv(sqe, descriptor, request->Data.data(), request->Data.size(), 0);
+    }
+    io_uring_sqe_set_data(sqe, request);
+    mReceivesInFlight[id] = request;
+    return true;
+}
+
+bool mtsIGTLUring::Poll(const int descriptor)
+{
+    if (mPollInFlight) {
+        return true;
+    }
+    struct io_uring_sqe * sqe = GetSQE();
+    if (!sqe) {
+        return false;
+    }
+    Request * request = new Request;
+    request->Operation = POLL;
+    request->Id = 0;
+    request->Descriptor = descriptor;
+    io_uring_prep_poll_add(sqe, descriptor, POLLIN);
+    io_uring_sqe_set_data(sqe, request);
+    mPollInFlight = request;
+    return true;
+}
+
+bool mtsIGTLUring::Send(const unsigned int id, const int descriptor,
+                        std::vector<unsigned char> & data)
+{
+    if (SendInFlight(id)) {
+        return false;
+    }
+    Request * request = new Request;
+    request->Operation = SEND;
+    request->Id = id;
+    request->Descriptor = descriptor;
+    request->Data.swap(data);
+    request->ZeroCopy = mZeroCopy && (request->Data.size() >= mZeroCopyThreshold);
+    if (!PrepareSend(request)) {
+        delete request;
+        return false;
+    }
+    mSendsInFlight[id] = request;
+    return true;
+}
+
+bool mtsIGTLUring::PrepareSend(Request * request)
+{
+    struct io_uring_sqe * sqe = GetSQE();
+    if (!sqe) {
+        return false;
+    }
+    const unsigned char * data = request->Data.data() + request->Offset;
+    const size_t size = request->Data.size() - request->Offset;
+    if (request->ZeroCopy) {
+        io_uring_prep_send_zc(sqe, request->Descriptor, data, size, MSG_NOSIGNAL, 0);
+    } else {
+        io_uring_prep_send(sqe, request->Descriptor, data, size, MSG_NOSIGNAL);
+    }
+    io_uring_sqe_set_data(sqe, request);
+    return true;
+}
+
+int mtsIGTLUring::SubmitAndWait(const int timeout, std::vector<Completion> & completions)
+{
+    completions.clear();
+    // data from last receives has been used
+    for (auto & request : mCompleted) {
+        delete request;
+    }
+    mCompleted.clear();
+
+    struct io_uring_cqe * cqe = nullptr;
+    int result;
+    if (timeout > 0) {
+        struct __kernel_timespec ts;
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000;
+        result = io_uring_submit_and_wait_timeout(&mRing, &cqe, 1, &ts, nullptr);
+    } else {
+        result = io_uring_submit(&mRing);
+    }
+    // nothing completed in time or interrupted by a signal
+    if ((result == -ETIME) || (result == -EINTR)) {
+        result = 0;
+    }
+    // reap all completions available, even on error
+    while (io_uring_peek_cqe(&mRing, &cqe) == 0) {
+        HandleCompletion(cqe, completions);
+        io_uring_cqe_seen(&mRing, cqe);
+    }
+    return (result < 0) ? result : 0;
+}
+
+void mtsIGTLUring::HandleCompletion(struct io_uring_cqe * cqe, std::vector<Completion> & completions)
+{
+    Request * request = static_cast<Request *>(io_uring_cqe_get_data(cqe));
+    if (!request) {
+        return;
+    }
+    // only used to wake up SubmitAndWait
+    if (request->Operation == POLL) {
+        mPollInFlight = nullptr;
+        delete request;
+        return;
+    }
+    const bool released = (request->Id == 0);
+    Completion completion;
+    completion.Operation = request->Operation;
+    completion.Id = request->Id;
+    completion.Result = cqe->res;
+    completion.Data = nullptr;
+
+    if (request->Operation == RECEIVE) {
+        if (!released) {
+            mReceivesInFlight.erase(request->Id);
+        }
+        // interrupted, will be re-submitted on next Receive
+        if (!released && ((cqe->res == -EINTR) || (cqe->res == -EAGAIN))) {
+            delete request;
+            return;
+        }
+        if (released) {
+            // registered buffer can now be used by another client
+            if (request->Slot >= 0) {
+                mFreeSlots.push_back(request->Slot);
+            }
+            delete request;
+            return;
+        }
+        completion.Data = (request->Slot >= 0) ?
+            mBuffers[request->Slot].data() : request->Data.data();
+        completions.push_back(completion);
+        mCompleted.push_back(request);
+        return;
+    }
+
+    // sends, zero copy notification means the kernel is done with the data
+    if (cqe->flags & IORING_CQE_F_NOTIF) {
+        --(request->NotificationsPending);
+        if (request->Done && (request->NotificationsPending == 0)) {
+            delete request;
+        }
+        return;
+    }
+    if (cqe->flags & IORING_CQE_F_MORE) {
+        ++(request->NotificationsPending);
+    }
+    // zero copy not supported by the kernel or socket, use regular
+    // sends.  Only these errors before any zero copy send succeeded,
+    // other errors (e.g. connection reset) are reported below.
+    if (request->ZeroCopy && !mZeroCopyWorks
+        && ((cqe->res == -EOPNOTSUPP) || (cqe->res == -EINVAL))) {
+        mZeroCopy = false;
+        request->ZeroCopy = false;
+        if (!released && PrepareSend(request)) {
+            return;
+        }
+    } else if (cqe->res > 0) {
+        if (request->ZeroCopy) {
+            mZeroCopyWorks = true;
+        }
+        request->Offset += static_cast<size_t>(cqe->res);
+        // partial send, continue with remaining
+        if (!released && (request->Offset < request->Data.size()) && PrepareSend(request)) {
+            return;
+        }
+    } else if ((cqe->res == -EINTR) || (cqe->res == -EAGAIN)) {
+        if (!released && PrepareSend(request)) {
+            return;
+        }
+    }
+    if (!released) {
+        mSendsInFlight.erase(request->Id);
+        // only report errors, sends are done otherwise
+        if (cqe->res < 0) {
+            completions.push_back(completion);
+        }
+    }
+    request->Done = true;
+    if (request->NotificationsPending == 0) {
+        delete request;
+    }
+}
+
+void mtsIGTLUring::Release(const unsigned int id)
+{
+    // requests in flight now belong to no client, id 0 is never used
+    auto send = mSendsInFlight.find(id);
+    if (send != mSendsInFlight.end()) {
+        send->second->Id = 0;
+        mSendsInFlight.erase(send);
+    }
+    // registered buffer is freed when the receive in flight completes
+    auto slot = mSlots.find(id);
+    auto receive = mReceivesInFlight.find(id);
+    if (receive != mReceivesInFlight.end()) {
+        receive->second->Id = 0;
+        mReceivesInFlight.erase(receive);
+    } else if (slot != mSlots.end()) {
+        mFreeSlots.push_back(slot->second);
+    }
+    if (slot != mSlots.end()) {
+        mSlots.erase(slot);
+    }
+}
@@ -0,0 +1,135 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// private header, only used by mtsIGTLBridge.cpp when compiled with
+// SAW_OPENIGTLINK_HAS_IO_URING (Linux with liburing)
+
+#ifndef _mtsIGTLUring_h
+#define _mtsIGTLUring_h
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <liburing.h>
+
+/*!
+  \brief io_uring backend used by mtsIGTLBridge
+
+  Receives and sends for all clients are prepared then submitted in a
+  single system call, completions are reaped in batch.  Each client
+  (identified by a unique id) has at most one receive and one send in
+  flight.  Receives use registered (fixed) buffers, one per client,
+  as long as some are available.  Sends own the message data until
+  the kernel is done with it, large messages use zero copy sends
+  (IORING_OP_SEND_ZC) if supported by the kernel.  Sends don't use
+  registered buffers: the data is moved from the client queue
+  without copy and buffers can't be registered per message, so the
+  kernel maps the pages for each send.
+*/
+class mtsIGTLUring
+{
+public:
+    typedef enum {RECEIVE, SEND, POLL} OperationType;
+
+    class Completion {
+    public:
+        OperationType Operation;
+        unsigned int Id;
+        //! Number of bytes, 0 if the connection is closed, negative errno on error
+        int Result;
+        //! Data received, valid until next call to SubmitAndWait
+        const unsigned char * Data;
+    };
+
+    mtsIGTLUring(void);
+    ~mtsIGTLUring();
+
+    /*! Create ring and register nbBuffers of bufferSize bytes for
+      receives.  Messages larger than zeroCopyThreshold are sent
+      using zero copy if supported. */
+    bool Init(const unsigned int entries,
+              const size_t nbBuffers, const size_t bufferSize,
+              const size_t zeroCopyThreshold);
+
+    //! Prepare receive for client if none is in flight
+    bool Receive(const unsigned int id, const int descriptor);
+
+    /*! Wait for descriptor to be readable if not already waiting,
+      only used to interrupt SubmitAndWait so no completion is
+      returned. */
+    bool Poll(const int descriptor);
+
+    //! Prepare send, data is moved in the request.  Fails if a send is in flight.
+    bool Send(const unsigned int id, const int descriptor,
+              std::vector<unsigned char> & data);
+
+    inline bool SendInFlight(const unsigned int id) const {
+        return mSendsInFlight.find(id) != mSendsInFlight.end();
+    }
+
+    /*! Submit all prepared requests and wait up to timeout (in ms, 0
+      to not wait) for at least one completion.  All completions
+      available are returned.  Returns 0, or a negative errno if the
+      requests can't be submitted.  Timeouts and interruptions are not
+      errors. */
+    int SubmitAndWait(const int timeout, std::vector<Completion> & completions);
+
+    //! Client removed, requests still in flight are ignored when completed
+    void Release(const unsigned int id);
+
+protected:
+    class Request {
+    public:
+        OperationType Operation;
+        unsigned int Id;
+        int Descriptor;
+        //! Fixed buffer index, -1 if Data is used
+        int Slot = -1;
+        std::vector<unsigned char> Data;
+        size_t Offset = 0;
+        bool ZeroCopy = false;
+        bool Done = false;
+        //! Zero copy notifications not received yet
+        size_t NotificationsPending = 0;
+    };
+
+    struct io_uring_sqe * GetSQE(void);
+    bool PrepareSend(Request * request);
+    void HandleCompletion(struct io_uring_cqe * cqe, std::vector<Completion> & completions);
+
+    struct io_uring mRing;
+    bool mInitialized;
+    bool mZeroCopy;
+    //! A zero copy send succeeded, errors are not from missing support
+    bool mZeroCopyWorks;
+    size_t mZeroCopyThreshold;
+
+    //! Registered buffers for receives, one per client while available
+    std::vector<std::vector<unsigned char> > mBuffers;
+    std::vector<int> mFreeSlots;
+    std::map<unsigned int, int> mSlots;
+
+    std::map<unsigned int, Request *> mReceivesInFlight;
+    std::map<unsigned int, Request *> mSendsInFlight;
+    Request * mPollInFlight;
+    //! Receives completed, deleted on next SubmitAndWait
+    std::list<Request *> mCompleted;
+};
+
+#endif // _mtsIGTLUring_h
@@ -20,6 +20,7 @@ http://www.cisst.org/cisst/license.txt.
 #define _mtsCISSTToIGTL_h
 
 #include <igtlTransformMessage.h>
+#include <igtlPositionMessage.h>
 #include <igtlStringMessage.h>
 #include <igtlSensorMessage.h>
 #include <igtlNDArrayMessage.h>
@@ -30,6 +31,18 @@ http://www.cisst.org/cisst/license.txt.
 #include <cisstParameterTypes/prmForceCartesianGet.h>
 #include <cisstParameterTypes/prmStateJoint.h>
 #include <cisstParameterTypes/prmEventButton.h>
+#include <cisstVector/vctDynamicMatrixTypes.h>
+#include <cisstVector/vctDynamicVectorTypes.h>
+
+#include <sawOpenIGTLink/mtsIGTLPackedMessage.h>
+
+//! Scalar type used to encode floating point arrays (NDARRAY)
+typedef enum {MTS_IGTL_FLOAT64, MTS_IGTL_FLOAT32} mtsIGTLEncoding;
+
+/*! Convert encoding name ("float64" or "float32") to enum, returns
+  false if the name is not recognized. */
+bool mtsIGTLEncodingFromString(const std::string & name,
+                               mtsIGTLEncoding & encoding);
 
 bool mtsCISSTToIGTL(const std::string & cisstData,
                     igtl::StringMessage::Pointer igtlData);
@@ -43,6 +56,10 @@ bool mtsCISSTToIGTL(const prmPositionCartesianGet & cisstData,
 bool mtsCISSTToIGTL(const prmPositionCartesianGet & cisstData,
                     igtl::TransformMessage::Pointer igtlData);
 
+//! Position and quaternion, more compact than a transformation
+bool mtsCISSTToIGTL(const prmPositionCartesianGet & cisstData,
+                    igtl::PositionMessage::Pointer igtlData);
+
 bool mtsCISSTToIGTL(const prmVelocityCartesianGet & cisstData,
                     igtl::SensorMessage::Pointer igtlData);
 
@@ -55,10 +72,81 @@ bool mtsCISSTToIGTL(const prmStateJoint & cisstData,
 bool mtsCISSTToIGTL(const prmStateJoint & cisstData,
                     igtl::NDArrayMessage::Pointer igtlData);
 
+bool mtsCISSTToIGTL(const prmStateJoint & cisstData,
+                    igtl::NDArrayMessage::Pointer igtlData,
+                    const mtsIGTLEncoding encoding);
+
+/*! Packs joint state as a 2D NDARRAY, same layout as the
+  igtl::NDArrayMessage version but values are written directly in the
+  message buffer using vectorized byte swaps. */
+bool mtsCISSTToIGTL(const prmStateJoint & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding encoding);
+
+/*! Packs matrix as a 2D NDARRAY (rows, cols), elements are written
+  directly from the matrix storage to the message body, row major,
+  regardless of the matrix storage order. */
+bool mtsCISSTToIGTL(const vctDoubleMat & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding encoding);
+
+//! Same for a block of rows of a larger matrix, nothing is copied
+bool mtsCISSTToIGTL(const vctDynamicConstMatrixRef<double> & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding encoding);
+
 bool mtsCISSTToIGTL(const prmEventButton & cisstData,
                     igtl::SensorMessage::Pointer igtlData);
 
 bool mtsCISSTToIGTL(const vct3 & cisstData,
                     igtl::PointMessage::Pointer igtlData);
 
+/*! Packs a N x 3 matrix, one point per row.  Point elements are
+  re-used if the number of rows doesn't change between calls.  Note
+  that vctDoubleMat with an mtsIGTLPackedMessage is sent as an NDARRAY
+  so the packed POINT path is only available for containers of
+  vct3. */
+bool mtsCISSTToIGTL(const vctDoubleMat & cisstData,
+                    igtl::PointMessage::Pointer igtlData);
+
+/*! Packs all points in a single POINT message.  If the number of
+  points doesn't change between calls, the point elements already in
+  the message buffer are re-used and only the positions are
+  updated. */
+bool mtsCISSTToIGTL(const std::vector<vct3> & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding encoding);
+
+bool mtsCISSTToIGTL(const vctDynamicVector<vct3> & cisstData,
+                    mtsIGTLPackedMessage & igtlData,
+                    const mtsIGTLEncoding encoding);
+
+/*! Flatten a sample to an array of values, used to send state table
+  history blocks.  For prmStateJoint, position, velocity and effort
+  are concatenated, each with one column per joint (number of names
+  or largest vector if there are no names), missing values are NaN.
+  For prmPositionCartesianGet, translation followed by rotation
+  matrix, row major. */
+bool mtsCISSTToIGTLSample(const prmStateJoint & cisstData,
+                          std::vector<double> & values);
+
+bool mtsCISSTToIGTLSample(const prmPositionCartesianGet & cisstData,
+                          std::vector<double> & values);
+
+bool mtsCISSTToIGTLSample(const prmVelocityCartesianGet & cisstData,
+                          std::vector<double> & values);
+
+bool mtsCISSTToIGTLSample(const prmForceCartesianGet & cisstData,
+                          std::vector<double> & values);
+
+/*! Types without a compact representation ignore the encoding.  Note
+  that SENSOR messages are always float64 per OpenIGTLink protocol. */
+template <typename _cisstType, typename _igtlPointer>
+inline bool mtsCISSTToIGTL(const _cisstType & cisstData,
+                           _igtlPointer igtlData,
+                           const mtsIGTLEncoding)
+{
+    return mtsCISSTToIGTL(cisstData, igtlData);
+}
+
 #endif  // _mtsCISSTToIGTL_h
@@ -26,21 +26,58 @@ http://www.cisst.org/cisst/license.txt.
 #define _mtsIGTLBridge_h
 
 #include <map>
+#include <atomic>
 
 #include <cisstMultiTask/mtsTaskPeriodic.h>
 #include <cisstMultiTask/mtsInterfaceRequired.h>
+#include <cisstMultiTask/mtsStateTable.h>
+#include <cisstOSAbstraction/osaGetTime.h>
+
+
+#include <sawOpenIGTLink/mtsCISSTToIGTL.h>
+#include <sawOpenIGTLink/mtsIGTLMatchPattern.h>
+#include <sawOpenIGTLink/mtsIGTLTrace.h>
+#include <sawOpenIGTLink/mtsIGTLTransport.h>
+#include <sawOpenIGTLink/mtsIGTLPoseBatch.h>
 
 // Always include last!
 #include <sawOpenIGTLink/sawOpenIGTLinkExport.h>
 
 class mtsIGTLBridge;
 class mtsIGTLBridgeData;
+class mtsIGTLReceiveBuffer;
 
 namespace igtl {
     class MessageBase;
     class Socket;
 }
 
+/*! Priority classes for senders and receivers.  High priority
+  senders are executed every cycle, lower priorities share the time
+  left in the cycle budget (see mtsIGTLBridge::SendAll). */
+typedef enum {MTS_IGTL_PRIORITY_HIGH,
+              MTS_IGTL_PRIORITY_NORMAL,
+              MTS_IGTL_PRIORITY_LOW,
+              MTS_IGTL_PRIORITY_COUNT} mtsIGTLPriority;
+
+/*! Convert priority name ("high", "normal" or "low") to enum, returns
+  false if the name is not recognized. */
+bool mtsIGTLPriorityFromString(const std::string & name,
+                               mtsIGTLPriority & priority);
+
+/*! CRC verification for messages received.  Control messages are
+  messages for high priority receivers, e.g. CRTK write commands.
+  Skipping is meant for trusted local clients (loopback, Unix domain
+  sockets or in process). */
+typedef enum {MTS_IGTL_CRC_VERIFY,
+              MTS_IGTL_CRC_VERIFY_CONTROL,
+              MTS_IGTL_CRC_SKIP} mtsIGTLCRCPolicy;
+
+/*! Convert policy name ("verify", "verify-on-control-only" or
+  "skip") to enum, returns false if the name is not recognized. */
+bool mtsIGTLCRCPolicyFromString(const std::string & name,
+                                mtsIGTLCRCPolicy & policy);
+
 class mtsIGTLSenderBase
 {
 public:
@@ -54,17 +91,57 @@ public:
 
     virtual bool Execute(void) = 0;
 
+    //! Encoding used for floating point arrays, default is float64
+    inline void SetEncoding(const mtsIGTLEncoding encoding) {
+        mEncoding = encoding;
+    }
+
+    //! Required interface used to pull data, empty if none
+    inline void SetInterfaceRequiredName(const std::string & name) {
+        mInterfaceRequiredName = name;
+    }
+    inline const std::string & GetInterfaceRequiredName(void) const {
+        return mInterfaceRequiredName;
+    }
+
+    //! Triggered senders are not executed periodically, see mtsIGTLTrigger
+    inline void SetTriggered(const bool triggered) {
+        mTriggered = triggered;
+    }
+    inline bool IsTriggered(void) const {
+        return mTriggered;
+    }
+
+    inline void SetPriority(const mtsIGTLPriority priority) {
+        mPriority = priority;
+    }
+    inline mtsIGTLPriority GetPriority(void) const {
+        return mPriority;
+    }
+
+    inline const std::string & GetName(void) const {
+        return mName;
+    }
+
 protected:
     std::string mName;
     mtsIGTLBridge * mBridge;
+    mtsIGTLEncoding mEncoding = MTS_IGTL_FLOAT64;
+    std::string mInterfaceRequiredName;
+    bool mTriggered = false;
+    mtsIGTLPriority mPriority = MTS_IGTL_PRIORITY_NORMAL;
 };
 
+/*! Sender based on an igtl message, the message is created once and
+  its pack buffer is re-used as long as the size doesn't change. */
 template <typename _cisstType, typename _igtlType>
 class mtsIGTLSender: public mtsIGTLSenderBase
 {
 public:
     inline mtsIGTLSender(const std::string & name, mtsIGTLBridge * bridge):
         mtsIGTLSenderBase(name, bridge) {
+        mIGTLData = _igtlType::New();
+        mIGTLData->SetDeviceName(name);
     }
     inline virtual ~mtsIGTLSender() {}
     bool Execute(void) override;
@@ -75,6 +152,47 @@ protected:
     IGTLPointer mIGTLData;
 };
 
+/*! Specialization for pre-packed messages, conversion writes directly
+  in the message buffer which is re-used for each call. */
+template <typename _cisstType>
+class mtsIGTLSender<_cisstType, mtsIGTLPackedMessage>: public mtsIGTLSenderBase
+{
+public:
+    inline mtsIGTLSender(const std::string & name, mtsIGTLBridge * bridge):
+        mtsIGTLSenderBase(name, bridge) {
+        mIGTLData.SetDeviceName(name);
+    }
+    inline virtual ~mtsIGTLSender() {}
+    bool Execute(void) override;
+
+protected:
+    _cisstType mCISSTData;
+    mtsIGTLPackedMessage mIGTLData;
+};
+
+/*! Specialization for TRANSFORM messages, Execute only pulls the
+  pose.  Poses of all senders executed in the same cycle are then
+  converted at once by the bridge, see mtsIGTLBridge::SendPoses. */
+template <>
+class CISST_EXPORT mtsIGTLSender<prmPositionCartesianGet, mtsIGTLPackedMessage>: public mtsIGTLSenderBase
+{
+    friend class mtsIGTLBridge;
+public:
+    inline mtsIGTLSender(const std::string & name, mtsIGTLBridge * bridge):
+        mtsIGTLSenderBase(name, bridge) {
+        mIGTLData.SetDeviceName(name);
+        mIGTLData.SetDeviceType("TRANSFORM");
+    }
+    inline virtual ~mtsIGTLSender() {}
+    bool Execute(void) override;
+
+protected:
+    prmPositionCartesianGet mCISSTData;
+    mtsIGTLPackedMessage mIGTLData;
+};
+
+typedef mtsIGTLSender<prmPositionCartesianGet, mtsIGTLPackedMessage> mtsIGTLPoseSender;
+
 template <typename _cisstType, typename _igtlType>
 class mtsIGTLEventWriteSender: public mtsIGTLSenderBase
 {
@@ -94,6 +212,87 @@ protected:
     IGTLPointer mIGTLData;
 };
 
+/*! Sender reading all the entries added to a state table since the
+  last call.  Samples are sent as a single 2D NDARRAY, one row per
+  sample.  First column is the time of the sample relative to the
+  message timestamp (time of first sample), followed by the sample
+  values (see mtsCISSTToIGTLSample).  The state table must belong to
+  a component in the same process. */
+template <typename _cisstType>
+class mtsIGTLStateTableSender: public mtsIGTLSenderBase
+{
+public:
+    inline mtsIGTLStateTableSender(const std::string & name, mtsIGTLBridge * bridge,
+                                   const mtsStateTable * stateTable,
+                                   const mtsStateTable::AccessorBase * accessor):
+        mtsIGTLSenderBase(name, bridge),
+        mStateTable(stateTable),
+        mAccessor(accessor) {
+        mIGTLData.SetDeviceName(name);
+    }
+    inline virtual ~mtsIGTLStateTableSender() {}
+    bool Execute(void) override;
+
+    /*! Number of samples not sent because more than half of the
+      state table was written between two calls */
+    inline size_t GetDropped(void) const {
+        return mDropped;
+    }
+
+protected:
+    const mtsStateTable * mStateTable;
+    const mtsStateTable::AccessorBase * mAccessor;
+    //! Index of last sample sent, only valid after first call
+    bool mFirst = true;
+    mtsStateIndex mLast;
+    size_t mDropped = 0;
+    _cisstType mCISSTData;
+    std::vector<double> mValues;
+    //! Large enough for all samples read per call, only rows filled are sent
+    vctDoubleMat mBlock;
+    mtsIGTLPackedMessage mIGTLData;
+};
+
+/*! Trigger used to execute senders as soon as the bridged component
+  has new data instead of the bridge period.  The trigger can be a
+  void event from the bridged component (handler is not queued, it
+  only sets a flag and wakes up the bridge) and/or the state table of
+  the component advancing (polled).  Triggers are checked by the
+  bridge in its receive loop. */
+class mtsIGTLTrigger
+{
+public:
+    inline mtsIGTLTrigger(void):
+        Pending(false) {}
+
+    inline void EventHandler(void) {
+        Pending = true;
+        if (Wakeup) {
+            Wakeup->Signal();
+        }
+    }
+
+    //! Returns true if triggered since last call
+    inline bool Check(void) {
+        bool triggered = Pending.exchange(false);
+        if (StateTable) {
+            const mtsStateIndex::TimeTicksType ticks = StateTable->GetIndexReader().Ticks();
+            if (ticks != LastTicks) {
+                LastTicks = ticks;
+                triggered = true;
+            }
+        }
+        return triggered;
+    }
+
+    std::atomic<bool> Pending;
+    //! Set by the bridge, interrupts the wait for data
+    mtsIGTLWakeup * Wakeup = nullptr;
+    const mtsStateTable * StateTable = nullptr;
+    mtsStateIndex::TimeTicksType LastTicks = 0;
+    std::list<mtsIGTLSenderBase *> Senders;
+};
+
 
 class mtsIGTLReceiverBase
 {
@@ -106,11 +305,45 @@ public:
 
     virtual ~mtsIGTLReceiverBase() {};
 
-    virtual bool Execute(igtl::Socket * socket, igtl::MessageBase * header) = 0;
+    /*! Read message body from the client receive buffer and convert.
+      The buffer must contain the full body.  If deferred, the data is
+      kept and the command is executed by ExecutePending, only the
+      latest message is kept.  Only coalesced receivers are deferred,
+      see SetCoalesced. */
+    virtual bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase * header,
+                         const bool deferred = false) = 0;
+
+    //! Execute command for deferred message if any
+    virtual bool ExecutePending(void) = 0;
+
+    inline void SetPriority(const mtsIGTLPriority priority) {
+        mPriority = priority;
+    }
+    inline mtsIGTLPriority GetPriority(void) const {
+        return mPriority;
+    }
+
+    /*! Receivers for state (e.g. telemetry or tracking) can be
+      deferred past the cycle budget, only the latest message is then
+      kept.  Commands (default) are never deferred so none is lost and
+      all are executed in the order received. */
+    inline void SetCoalesced(const bool coalesced) {
+        mCoalesced = coalesced;
+    }
+    inline bool GetCoalesced(void) const {
+        return mCoalesced;
+    }
+
+    inline const std::string & GetName(void) const {
+        return mName;
+    }
 
 protected:
     std::string mName;
     mtsIGTLBridge * mBridge;
+    mtsIGTLPriority mPriority = MTS_IGTL_PRIORITY_NORMAL;
+    bool mCoalesced = false;
+    bool mPending = false;
 };
 
 template <typename _igtlType, typename _cisstType>
@@ -119,15 +352,50 @@ class mtsIGTLReceiver: public mtsIGTLReceiverBase
 public:
     inline mtsIGTLReceiver(const std::string & name, mtsIGTLBridge * bridge):
         mtsIGTLReceiverBase(name, bridge) {
+        mIGTLData = _igtlType::New();
     }
     inline virtual ~mtsIGTLReceiver() {}
-    bool Execute(igtl::Socket * socket, igtl::MessageBase * header) override;
+    bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase * header,
+                 const bool deferred = false) override;
+    bool ExecutePending(void) override;
 
 protected:
     typedef typename _igtlType::Pointer IGTLPointer;
+    //! Re-used for all messages received, see mtsIGTLSender
+    IGTLPointer mIGTLData;
     _cisstType mCISSTData;
 };
 
+/*! Specialization for TRANSFORM messages, bodies are converted with
+  the other TRANSFORM messages received consecutively in the same
+  pass, see mtsIGTLBridge::ReceivePoses.  Any other command received
+  flushes the batch first so commands are executed in order.  Messages
+  with a version 2 header use igtl::TransformMessage. */
+template <>
+class CISST_EXPORT mtsIGTLReceiver<igtl::TransformMessage, prmPositionCartesianSet>: public mtsIGTLReceiverBase
+{
+    friend class mtsIGTLBridge;
+public:
+    inline mtsIGTLReceiver(const std::string & name, mtsIGTLBridge * bridge):
+        mtsIGTLReceiverBase(name, bridge) {
+    }
+    inline virtual ~mtsIGTLReceiver() {}
+    bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase * header,
+                 const bool deferred = false) override;
+    bool ExecutePending(void) override;
+
+    /*! True if the message body is queued for the batch conversion,
+      other messages are converted and executed immediately. */
+    static bool Batched(igtl::MessageBase * header);
+
+protected:
+    //! Execute command with mCISSTData or keep it for ExecutePending
+    bool ExecuteConverted(const bool deferred);
+    prmPositionCartesianSet mCISSTData;
+};
+
+typedef mtsIGTLReceiver<igtl::TransformMessage, prmPositionCartesianSet> mtsIGTLPoseReceiver;
+
 
 class CISST_EXPORT mtsIGTLBridge: public mtsTaskPeriodic
 {
@@ -171,49 +439,399 @@ class CISST_EXPORT mtsIGTLBridge: public mtsTaskPeriodic
     template <typename _cisstType, typename _igtlType>
     bool AddSenderFromCommandRead(const std::string & interfaceRequiredName,
                                   const std::string & functionName,
-                                  const std::string & igtlDeviceName);
+                                  const std::string & igtlDeviceName,
+                                  const mtsIGTLEncoding encoding = MTS_IGTL_FLOAT64,
+                                  const mtsIGTLPriority priority = MTS_IGTL_PRIORITY_NORMAL);
 
     template <typename _cisstType, typename _igtlType>
     bool AddSenderFromEventWrite(const std::string & interfaceRequiredName,
                                  const std::string & eventName,
-                                 const std::string & igtlDeviceName);
+                                 const std::string & igtlDeviceName,
+                                 const mtsIGTLEncoding encoding = MTS_IGTL_FLOAT64);
+
+    /*! Add sender for all samples of a state table, see
+      mtsIGTLStateTableSender.  If the state table name is empty, use
+      the default state table of the component.  The required
+      interface name is not used to pull data, it only groups the
+      sender with other senders for triggers (see
+      AddTriggerFromEventVoid). */
+    template <typename _cisstType>
+    bool AddSenderFromStateTable(const std::string & interfaceRequiredName,
+                                 const std::string & componentName,
+                                 const std::string & stateTableName,
+                                 const std::string & stateDataName,
+                                 const std::string & igtlDeviceName,
+                                 const mtsIGTLEncoding encoding = MTS_IGTL_FLOAT64,
+                                 const mtsIGTLPriority priority = MTS_IGTL_PRIORITY_NORMAL);
 
     template <typename _igtlType, typename _cisstType>
     bool AddReceiverToCommandWrite(const std::string & interfaceRequiredName,
                                    const std::string & commandName,
-                                   const std::string & igtlDeviceName);
+                                   const std::string & igtlDeviceName,
+                                   const mtsIGTLPriority priority = MTS_IGTL_PRIORITY_NORMAL);
+
+    /*! Set priority for all senders and receivers with a device name
+      matching the pattern (see MatchPattern), returns false if none
+      found. */
+    bool SetPriority(const std::string & igtlDevicePattern,
+                     const mtsIGTLPriority priority);
+
+    /*! Mark all receivers with a device name matching the pattern as
+      state, see mtsIGTLReceiverBase::SetCoalesced.  Returns false if
+      none found. */
+    bool SetCoalesced(const std::string & igtlDevicePattern,
+                      const bool coalesced = true);
+
+    /*! Time budget in seconds for each cycle, starting from the
+      beginning of Run.  High priority senders are always executed,
+      other senders are executed in round robin until the budget is
+      used and deferred to the next cycle otherwise.  0 (default)
+      means no limit. */
+    inline void SetCycleBudget(const double & budget) {
+        mCycleBudget = budget;
+    }
+
+    //! CRC verification for messages received, default is verify
+    inline void SetCRCPolicy(const mtsIGTLCRCPolicy policy) {
+        mCRCPolicy = policy;
+    }
 
+    /*! Execute all senders added so far for the required interface
+      when the void event is emitted by the bridged component, senders
+      are then no longer executed periodically. */
+    bool AddTriggerFromEventVoid(const std::string & interfaceRequiredName,
+                                 const std::string & eventName);
+
+    /*! Execute all senders added so far for the required interface
+      when the state table of the component advances.  If the state
+      table name is empty, use the default state table. */
+    bool AddTriggerFromStateTable(const std::string & interfaceRequiredName,
+                                  const std::string & componentName,
+                                  const std::string & stateTableName = "");
+
+    //! Execute all periodic senders based on priority and budget
     void SendAll(void);
 
+    //! Execute senders for all triggers set since last call
+    void SendTriggered(void);
+
+    /*! Send message to all clients.  The message is sent without
+      blocking, what can't be sent immediately is queued per client
+      and sent in chunks by SendQueued.  If the message is state
+      (e.g. periodic measured_js), a queued message for the same
+      device not yet started is replaced.  Other messages (events,
+      samples) and STRING messages are never replaced. */
     template <typename _igtlMessagePointer>
-    void Send(_igtlMessagePointer message);
+    void Send(_igtlMessagePointer message, const bool state = false);
+
+    void SendBytes(const unsigned char * data, const size_t size,
+                   const std::string & deviceName, const bool state = false);
+
+    //! Used by mtsIGTLPoseSender::Execute, pose is sent by SendPoses
+    void QueuePose(mtsIGTLPoseSender * sender);
+
+    /*! Convert all poses queued since last call to TRANSFORM messages
+      in a single batch (see mtsIGTLPoseBatch) and send them. */
+    void SendPoses(void);
+
+    /*! Used by mtsIGTLPoseReceiver::Execute, reads the TRANSFORM body
+      from the buffer, the command is executed by ReceivePoses. */
+    void QueuePose(mtsIGTLPoseReceiver * receiver,
+                   mtsIGTLReceiveBuffer & buffer, const bool deferred);
+
+    /*! Convert all TRANSFORM messages queued since last call in a
+      single batch and execute the commands. */
+    void ReceivePoses(void);
+
+    /*! Continue sending queued messages, one chunk at a time, until
+      the sockets would block or the time slice is used.  Returns true
+      if some data is still queued. */
+    bool SendQueued(void);
+
+    /*! Keep the last message sent for each device and type, senders
+      are executed even when no client is connected.  Clients can
+      then query a device using GET_<type> (e.g. GET_TRANSFORM), an
+      empty device name returns all devices of that type.  If
+      snapshot is set, all cached messages are sent to new clients. */
+    inline void SetCache(const bool cache, const bool snapshot) {
+        mCache = cache;
+        mCacheSnapshot = snapshot;
+    }
+
+    /*! Size of chunks used to send large messages, maximum time spent
+      in SendQueued per call (0 for no limit) and maximum number of
+      bytes queued per client, messages are dropped past it. */
+    inline void SetSendChunking(const size_t chunkSize, const double & timeSlice,
+                                const size_t maxQueueSize) {
+        mSendChunkSize = chunkSize;
+        mSendTimeSlice = timeSlice;
+        mSendMaxQueueSize = maxQueueSize;
+    }
+
+    /*! Send to clients from a separate thread.  Messages packed
+      during the send phase of a cycle are handed over to the worker
+      which sends them, and continues large transfers, while the
+      bridge receives and converts the next cycle.  A slow client
+      doesn't block the bridge, it only waits to remove or modify a
+      client the worker is writing to.  Must be set before the bridge
+      starts, not used with the io_uring backend. */
+    inline void SetSendWorker(const bool worker) {
+        mSendWorker = worker;
+    }
+
+    /*! Accept clients from another transport (see mtsIGTLTransport.h),
+      the bridge owns the listener.  Must be called before the bridge
+      is started. */
+    void AddListener(mtsIGTLListener * listener);
+
+    /*! Connect to another OpenIGTLink server, the server is then
+      handled as any other client by senders and receivers.  The
+      connection is established and re-established after failures
+      without blocking the bridge (see mtsIGTLTCPConnector).  Returns
+      false if the host can't be resolved yet, the bridge still tries
+      to resolve and connect on each attempt. */
+    bool ConnectToServer(const std::string & host, const int port);
+
+    /*! Also listen on a Unix domain socket (POSIX only), same
+      framing as TCP clients.  Local clients avoid the TCP/IP stack.
+      A stale socket file with the same path is removed, fails if
+      another process listens on it or if the path is used by another
+      type of file. */
+    bool SetUnixSocket(const std::string & path);
+
+    /*! Also publish all messages sent in a shared memory ring buffer
+      (POSIX only, see mtsIGTLSharedMemory.h).  Name must start with
+      '/' and the size limits the largest message to half of it.
+      Clients on the same host read from it without sockets, mode is
+      used for the permissions (e.g. 0660 for users in the same group). */
+    bool SetSharedMemory(const std::string & name, const size_t size,
+                         const unsigned int mode = 0600);
 
     void ReceiveAll(void);
 
+    //! Add connected client, the bridge owns the connection
+    void AddClient(mtsIGTLConnection * connection);
+
+    //! Tracing, enabled using "trace" in JSON configuration
+    inline mtsIGTLTrace & Trace(void) {
+        return mTrace;
+    }
+
+    //! Save trace using Chrome trace JSON format
+    void SaveTrace(const std::string & fileName);
+
+    /*! Inbound quota, in messages per second, for clients and devices
+      matching the patterns (see MatchPattern).  Messages over quota
+      are dropped and counted.  Rules are checked in order, the first
+      matching rule applies. */
+    class ReceiveQuota {
+    public:
+        std::string Client;
+        std::string Device;
+        double Rate;
+    };
+    typedef std::list<ReceiveQuota> ReceiveQuotasType;
+
+    inline void AddReceiveQuota(const std::string & clientPattern,
+                                const std::string & devicePattern,
+                                const double & rate) {
+        mReceiveQuotas.push_back({clientPattern, devicePattern, rate});
+    }
+
+    /*! Client profile, clients using a profile only receive messages
+      for devices matching one of the patterns (see MatchPattern).  A
+      profile is selected when the client connects if its address
+      (address:port, unix:path or memory:name) matches the address
+      pattern, first match applies.  A client can also select a
+      profile by name by sending a STRING message with the device name
+      "CLIENT" and the profile name as content.  Clients without
+      profile receive all messages. */
+    class ClientProfile {
+    public:
+        std::string Name;
+        //! Empty if the profile can only be selected by name
+        std::string Address;
+        std::list<std::string> Devices;
+    };
+    typedef std::list<ClientProfile> ClientProfilesType;
+
+    inline void AddClientProfile(const std::string & name,
+                                 const std::string & addressPattern,
+                                 const std::list<std::string> & devicePatterns) {
+        mClientProfiles.push_back({name, addressPattern, devicePatterns});
+    }
+
+    /*! Maximum number of messages and bytes received from each client
+      per cycle, 0 (default) means no limit.  Regardless of budget,
+      clients take turns, a few messages per client on each pass of
+      the receive loop, starting with a different client each pass. */
+    inline void SetReceiveBudget(const size_t maxMessages, const size_t maxBytes) {
+        mReceiveMaxMessages = maxMessages;
+        mReceiveMaxBytes = maxBytes;
+    }
+
+    /*! Simple glob matching used for device and command names, supports
+      '*' (any sequence, including empty) and '?' (any character). */
+    static inline bool MatchPattern(const std::string & pattern,
+                                    const std::string & name) {
+        return mtsIGTLMatchPattern(pattern, name);
+    }
+
  protected:
+    //! Find component in local component manager
+    mtsComponent * GetLocalComponent(const std::string & componentName);
+
     // igtl networking
     int mPort = 0; // default
+    //! False if the bridge only connects to servers, see ConnectToServer
+    bool mServer = true;
     mtsIGTLBridgeData * mData = nullptr;
 
+    //! Default encoding for floating point arrays, set by "encoding" in JSON
+    mtsIGTLEncoding mEncoding = MTS_IGTL_FLOAT64;
+
+    mtsIGTLTrace mTrace;
+    //! File used to save the trace on Cleanup, optional
+    std::string mTraceFile;
+
     // cisst interfaces
     typedef std::list<mtsIGTLSenderBase *> SendersType;
     SendersType mSenders;
 
     typedef std::map<std::string, mtsIGTLReceiverBase *> ReceiversType;
     ReceiversType mReceivers;
+
+    typedef std::list<mtsIGTLTrigger *> TriggersType;
+    TriggersType mTriggers;
+
+    //! Attach senders for the required interface to the trigger
+    bool AddTrigger(const std::string & interfaceRequiredName,
+                    mtsIGTLTrigger * trigger);
+
+    //! Socket timeout in ms, reduced when triggers have to be polled
+    int mSocketTimeout = 10;
+
+    //! See SetCRCPolicy
+    mtsIGTLCRCPolicy mCRCPolicy = MTS_IGTL_CRC_VERIFY;
+    inline bool VerifyCRC(const mtsIGTLPriority priority) const {
+        return (mCRCPolicy == MTS_IGTL_CRC_VERIFY)
+            || ((mCRCPolicy == MTS_IGTL_CRC_VERIFY_CONTROL)
+                && (priority == MTS_IGTL_PRIORITY_HIGH));
+    }
+
+    //! See SetCycleBudget
+    double mCycleBudget = 0.0;
+    //! Start time of current cycle (Run)
+    double mCycleStart = 0.0;
+    //! Time left in current cycle budget, always true if no budget
+    inline bool InBudget(void) const {
+        return (mCycleBudget <= 0.0)
+            || ((osaGetTime() - mCycleStart) < mCycleBudget);
+    }
+
+    /*! Periodic senders sorted by priority, rebuilt when senders are
+      added or priorities change.  Next is the index of first sender
+      to execute for round robin on lower priorities. */
+    class PrioritySenders {
+    public:
+        std::vector<mtsIGTLSenderBase *> Senders;
+        size_t Next = 0;
+    };
+    PrioritySenders mSendersByPriority[MTS_IGTL_PRIORITY_COUNT];
+    bool mSendersByPriorityValid = false;
+    void UpdateSendersByPriority(void);
+
+    //! See SetCache
+    bool mCache = false;
+    bool mCacheSnapshot = false;
+
+    //! See SetSendChunking
+    size_t mSendChunkSize = 64 * 1024;
+    double mSendTimeSlice = 0.0002;
+    size_t mSendMaxQueueSize = 64 * 1024 * 1024;
+    //! Some data is queued, SendQueued needs to be called
+    bool mSendPending = false;
+
+    /*! Send to all clients, used by SendBytes or by the send worker.
+      Returns true if some data is queued. */
+    bool SendToClients(const unsigned char * data, const size_t size,
+                       const std::string & deviceName, const bool state,
+                       mtsIGTLTrace & trace,
+                       std::list<mtsIGTLConnection *> & toBeRemoved);
+
+    //! Continue queued transfers, see SendQueued
+    bool SendChunks(mtsIGTLTrace & trace,
+                    std::list<mtsIGTLConnection *> & toBeRemoved);
+
+    //! See SetSendWorker
+    bool mSendWorker = false;
+    //! Hand over messages packed so far to the send worker, if it's ready
+    void PublishSendFrame(void);
+    //! Send worker thread main loop
+    void SendWorker(void);
+
+    //! See SetReceiveBudget and AddReceiveQuota
+    size_t mReceiveMaxMessages = 0;
+    size_t mReceiveMaxBytes = 0;
+    ReceiveQuotasType mReceiveQuotas;
+
+    //! See AddClientProfile
+    ClientProfilesType mClientProfiles;
+
+    //! Priorities from JSON configuration, applied on Startup
+    std::list<std::pair<std::string, mtsIGTLPriority> > mPriorities;
+
+    //! Coalesced receivers from JSON configuration, applied on Startup
+    std::list<std::string> mCoalesced;
+
+    //! See SendPoses and ReceivePoses
+    mtsIGTLPoseBatch mPoseBatch;
+    std::vector<unsigned char *> mPoseBodies;
+    std::vector<mtsIGTLPoseSender *> mPoseSenders;
+    std::vector<std::pair<mtsIGTLPoseReceiver *, bool> > mPoseReceivers;
+    std::vector<unsigned char> mPoseReceived;
 };
 
 
 template <typename _cisstType, typename _igtlType>
 bool mtsIGTLSender<_cisstType, _igtlType>::Execute(void)
 {
+    mtsIGTLTrace & trace = mBridge->Trace();
+    double traceTime = trace.Time();
     mtsExecutionResult result = Function(mCISSTData);
+    traceTime = trace.Add("pull", mName, traceTime);
     if (result) {
-        mIGTLData = _igtlType::New();
-        mIGTLData->SetDeviceName(mName);
-        if (mtsCISSTToIGTL(mCISSTData, mIGTLData)) {
+        if (mtsCISSTToIGTL(mCISSTData, mIGTLData, mEncoding)) {
+            traceTime = trace.Add("convert", mName, traceTime);
             mIGTLData->Pack();
-            mBridge->Send(mIGTLData);
+            traceTime = trace.Add("pack", mName, traceTime);
+            mBridge->Send(mIGTLData, true);
+            trace.Add("send", mName, traceTime);
+            return true;
+        }
+    } else {
+        CMN_LOG_RUN_ERROR << "mtsIGTLSender::Execute: " << result
+                          << " for " << mName << std::endl;
+    }
+    return false;
+}
+
+template <typename _cisstType>
+bool mtsIGTLSender<_cisstType, mtsIGTLPackedMessage>::Execute(void)
+{
+    mtsIGTLTrace & trace = mBridge->Trace();
+    double traceTime = trace.Time();
+    mtsExecutionResult result = Function(mCISSTData);
+    traceTime = trace.Add("pull", mName, traceTime);
+    if (result) {
+        // use current time by default, conversion can override
+        mIGTLData.SetTimeStamp(osaGetTime());
+        if (mtsCISSTToIGTL(mCISSTData, mIGTLData, mEncoding)) {
+            traceTime = trace.Add("convert", mName, traceTime);
+            mIGTLData.Pack();
+            traceTime = trace.Add("pack", mName, traceTime);
+            mBridge->Send(&mIGTLData, true);
+            trace.Add("send", mName, traceTime);
             return true;
         }
     } else {
@@ -226,18 +844,100 @@ bool mtsIGTLSender<_cisstType, _igtlType>::Execute(void)
 template <typename _cisstType, typename _igtlType>
 void mtsIGTLEventWriteSender<_cisstType, _igtlType>::EventHandler(const _cisstType & cisstData)
 {
-    mIGTLData = _igtlType::New();
-    mIGTLData->SetDeviceName(mName);
-    if (mtsCISSTToIGTL(cisstData, mIGTLData)) {
+    mtsIGTLTrace & trace = mBridge->Trace();
+    double traceTime = trace.Time();
+    if (mtsCISSTToIGTL(cisstData, mIGTLData, mEncoding)) {
+        traceTime = trace.Add("convert", mName, traceTime);
         mIGTLData->Pack();
+        traceTime = trace.Add("pack", mName, traceTime);
         mBridge->Send(mIGTLData);
+        trace.Add("send", mName, traceTime);
+    }
+}
+
+template <typename _cisstType>
+bool mtsIGTLStateTableSender<_cisstType>::Execute(void)
+{
+    mtsIGTLTrace & trace = mBridge->Trace();
+    double traceTime = trace.Time();
+    // latest entry written
+    const mtsStateIndex latest = mStateTable->GetIndexReader();
+    if (!mFirst && (latest.Ticks() == mLast.Ticks())) {
+        return false;
     }
+    // stay away from the writer, oldest entries might be overwritten
+    // while we read them
+    const mtsStateIndex::TimeTicksType maxSamples = latest.Length() / 2;
+    mtsStateIndex::TimeTicksType nbSamples = maxSamples;
+    if (!mFirst) {
+        const mtsStateIndex::TimeTicksType nbNew = latest.Ticks() - mLast.Ticks();
+        if (nbNew <= maxSamples) {
+            nbSamples = nbNew;
+        } else {
+            if (mDropped == 0) {
+                CMN_LOG_RUN_WARNING << "mtsIGTLStateTableSender::Execute: more than half of the state table written since last call for "
+                                    << mName << ", older samples are dropped (see GetDropped)" << std::endl;
+            }
+            mDropped += static_cast<size_t>(nbNew - maxSamples);
+        }
+    }
+    mFirst = false;
+    mLast = latest;
+
+    // walk back from the latest entry using the state table index,
+    // Get fails for entries not written yet or already overwritten
+    mtsStateIndex index = latest;
+    for (mtsStateIndex::TimeTicksType sample = 1; sample < nbSamples; ++sample) {
+        --index;
+    }
+    // rows are time offset and values
+    size_t nbRows = 0;
+    size_t nbCols = 0;
+    double firstTime = 0.0;
+    for (mtsStateIndex::TimeTicksType sample = 0; sample < nbSamples; ++sample, ++index) {
+        if (!mAccessor->Get(index, mCISSTData)
+            || !mtsCISSTToIGTLSample(mCISSTData, mValues)) {
+            continue;
+        }
+        if (nbRows == 0) {
+            nbCols = mValues.size() + 1;
+            // only re-allocated if the state table or sample size changes
+            if ((mBlock.rows() != static_cast<size_t>(maxSamples)) || (mBlock.cols() != nbCols)) {
+                mBlock.SetSize(static_cast<size_t>(maxSamples), nbCols);
+            }
+            firstTime = mCISSTData.Timestamp();
+        } else if (mValues.size() + 1 != nbCols) {
+            // size changed, skip sample
+            continue;
+        }
+        mBlock.Element(nbRows, 0) = mCISSTData.Timestamp() - firstTime;
+        std::copy(mValues.begin(), mValues.end(), &(mBlock.Element(nbRows, 1)));
+        ++nbRows;
+    }
+    traceTime = trace.Add("pull", mName, traceTime);
+    if (nbRows == 0) {
+        return false;
+    }
+    // only send rows filled
+    mIGTLData.SetTimeStamp(firstTime);
+    if (mtsCISSTToIGTL(vctDynamicConstMatrixRef<double>(mBlock, 0, 0, nbRows, nbCols),
+                       mIGTLData, mEncoding)) {
+        traceTime = trace.Add("convert", mName, traceTime);
+        mIGTLData.Pack();
+        traceTime = trace.Add("pack", mName, traceTime);
+        mBridge->Send(&mIGTLData);
+        trace.Add("send", mName, traceTime);
+        return true;
+    }
+    return false;
 }
 
 template <typename _cisstType, typename _igtlType>
 bool mtsIGTLBridge::AddSenderFromCommandRead(const std::string & interfaceRequiredName,
                                              const std::string & functionName,
-                                             const std::string & igtlDeviceName)
+                                             const std::string & igtlDeviceName,
+                                             const mtsIGTLEncoding encoding,
+                                             const mtsIGTLPriority priority)
 {
     // check if the interface exists of try to create one
     mtsInterfaceRequired * interfaceRequired
@@ -252,6 +952,9 @@ bool mtsIGTLBridge::AddSenderFromCommandRead(const std::string & interfaceRequir
     }
     mtsIGTLSenderBase * newSender =
         new mtsIGTLSender<_cisstType, _igtlType>(igtlDeviceName, this);
+    newSender->SetEncoding(encoding);
+    newSender->SetPriority(priority);
+    newSender->SetInterfaceRequiredName(interfaceRequiredName);
     if (!interfaceRequired->AddFunction(functionName, newSender->Function)) {
         CMN_LOG_CLASS_INIT_ERROR << "AddSenderFromCommandRead: failed to add function \""
                                  << functionName << "\" to interface required \""
@@ -260,6 +963,7 @@ bool mtsIGTLBridge::AddSenderFromCommandRead(const std::string & interfaceRequir
         return false;
     }
     mSenders.push_back(newSender);
+    mSendersByPriorityValid = false;
     return true;
 }
 
@@ -267,7 +971,8 @@ bool mtsIGTLBridge::AddSenderFromCommandRead(const std::string & interfaceRequir
 template <typename _cisstType, typename _igtlType>
 bool mtsIGTLBridge::AddSenderFromEventWrite(const std::string & interfaceRequiredName,
                                             const std::string & eventName,
-                                            const std::string & igtlDeviceName)
+                                            const std::string & igtlDeviceName,
+                                            const mtsIGTLEncoding encoding)
 {
     // check if the interface exists of try to create one
     mtsInterfaceRequired * interfaceRequired
@@ -282,6 +987,7 @@ bool mtsIGTLBridge::AddSenderFromEventWrite(const std::string & interfaceRequire
     }
     mtsIGTLEventWriteSender<_cisstType, _igtlType> * newSender
         = new mtsIGTLEventWriteSender<_cisstType, _igtlType>(igtlDeviceName, this);
+    newSender->SetEncoding(encoding);
     if (!interfaceRequired->AddEventHandlerWrite(&mtsIGTLEventWriteSender<_cisstType, _igtlType>::EventHandler,
                                                  newSender, eventName)) {
         CMN_LOG_CLASS_INIT_ERROR << "AddSenderFromEventWrite: failed to add event \""
@@ -294,10 +1000,51 @@ bool mtsIGTLBridge::AddSenderFromEventWrite(const std::string & interfaceRequire
     return true;
 }
 
+template <typename _cisstType>
+bool mtsIGTLBridge::AddSenderFromStateTable(const std::string & interfaceRequiredName,
+                                            const std::string & componentName,
+                                            const std::string & stateTableName,
+                                            const std::string & stateDataName,
+                                            const std::string & igtlDeviceName,
+                                            const mtsIGTLEncoding encoding,
+                                            const mtsIGTLPriority priority)
+{
+    mtsTask * task = dynamic_cast<mtsTask *>(GetLocalComponent(componentName));
+    if (!task) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddSenderFromStateTable: unable to find task \""
+                                 << componentName << "\"" << std::endl;
+        return false;
+    }
+    mtsStateTable * stateTable = stateTableName.empty() ?
+        task->GetDefaultStateTable() : task->GetStateTable(stateTableName);
+    if (!stateTable) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddSenderFromStateTable: unable to find state table \""
+                                 << stateTableName << "\" for task \""
+                                 << componentName << "\"" << std::endl;
+        return false;
+    }
+    const mtsStateTable::AccessorBase * accessor = stateTable->GetAccessorByName(stateDataName);
+    if (!accessor) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddSenderFromStateTable: unable to find data \""
+                                 << stateDataName << "\" in state table of task \""
+                                 << componentName << "\"" << std::endl;
+        return false;
+    }
+    mtsIGTLSenderBase * newSender =
+        new mtsIGTLStateTableSender<_cisstType>(igtlDeviceName, this, stateTable, accessor);
+    newSender->SetEncoding(encoding);
+    newSender->SetPriority(priority);
+    newSender->SetInterfaceRequiredName(interfaceRequiredName);
+    mSenders.push_back(newSender);
+    mSendersByPriorityValid = false;
+    return true;
+}
+
 template <typename _igtlType, typename _cisstType>
 bool mtsIGTLBridge::AddReceiverToCommandWrite(const std::string & interfaceRequiredName,
                                               const std::string & commandName,
-                                              const std::string & igtlDeviceName)
+                                              const std::string & igtlDeviceName,
+                                              const mtsIGTLPriority priority)
 {
     // check if the interface exists of try to create one
     mtsInterfaceRequired * interfaceRequired = this->GetInterfaceRequired(interfaceRequiredName);
@@ -311,6 +1058,7 @@ bool mtsIGTLBridge::AddReceiverToCommandWrite(const std::string & interfaceRequi
     }
     mtsIGTLReceiver<_igtlType, _cisstType> * newReceiver
         = new mtsIGTLReceiver<_igtlType, _cisstType>(igtlDeviceName, this);
+    newReceiver->SetPriority(priority);
     if (!interfaceRequired->AddFunction(commandName, newReceiver->Function)) {
         CMN_LOG_CLASS_INIT_ERROR << "AddReceiverToCommandWrite: failed to add function \""
                                  << commandName << "\" to interface required \""
@@ -0,0 +1,35 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIGTLCRC64_h
+#define _mtsIGTLCRC64_h
+
+#include <cstddef>
+
+// Always include last!
+#include <sawOpenIGTLink/sawOpenIGTLinkExport.h>
+
+/*! CRC64 (ECMA-182) used by OpenIGTLink for message bodies, same
+  result as crc64 in igtl_util.h but processes 8 bytes per iteration
+  (slicing-by-8).  Use the previous result as crc to continue over
+  non contiguous data. */
+CISST_EXPORT unsigned long long mtsIGTLCRC64(const unsigned char * data,
+                                             const size_t size,
+                                             const unsigned long long crc = 0);
+
+#endif // _mtsIGTLCRC64_h
@@ -20,6 +20,7 @@ http://www.cisst.org/cisst/license.txt.
 #ifndef _mtsIGTLCRTKBridge_h
 #define _mtsIGTLCRTKBridge_h
 
+#include <list>
 #include <set>
 
 // cisst include
@@ -42,9 +43,38 @@ public:
 
     void ConfigureJSON(const Json::Value & jsonConfig) override;
 
+    //! Options used when bridging a provided interface
+    class InterfaceOptions {
+    public:
+        inline InterfaceOptions(void):
+            Encoding(MTS_IGTL_FLOAT64),
+            UsePositionMessage(false),
+            TriggerStateTable(false) {}
+
+        //! Encoding used for floating point arrays (e.g. measured_js)
+        mtsIGTLEncoding Encoding;
+        /*! Use POSITION (position and quaternion) messages instead
+          of TRANSFORM for Cartesian poses, i.e. measured_cp,
+          setpoint_cp, servo_cp and move_cp */
+        bool UsePositionMessage;
+        /*! Read commands sent as blocks of all samples from the state
+          table since last cycle (see mtsIGTLStateTableSender).  The
+          state table data must have the same name as the command. */
+        std::set<std::string> History;
+        /*! Send read commands when the bridged component emits this
+          void event instead of periodically, empty by default */
+        std::string TriggerEvent;
+        /*! Send read commands when the default state table of the
+          bridged component advances */
+        bool TriggerStateTable;
+    };
+
+    /*! Bridge all CRTK commands and events found in the provided
+      interface. */
     void BridgeInterfaceProvided(const std::string & componentName,
                                  const std::string & interfaceName,
-                                 const std::string & nameSpace);
+                                 const std::string & nameSpace,
+                                 const InterfaceOptions & options = InterfaceOptions());
 
     /*! Connect all components created and used so far. */
     inline virtual void Connect(void) {
@@ -59,6 +89,26 @@ protected:
     void GetCRTKCommand(const std::string & fullCommand,
                         std::string & crtkCommand);
 
+    /*! Additional bridges, each with its own port, thread and period.
+      Commands are assigned to the first channel with a matching
+      pattern, all other commands use this bridge. */
+    class Channel {
+    public:
+        std::string Name;
+        std::list<std::string> Patterns;
+        mtsIGTLBridge * Bridge;
+    };
+    std::list<Channel> mChannels;
+
+    //! Create channels from "channels" in JSON configuration
+    bool ConfigureChannelsJSON(const Json::Value & jsonChannels);
+
+    /*! Find bridge for command, patterns are matched against the full
+      command name or the CRTK command (e.g. "servo_*" or
+      "local/measured_cp") */
+    mtsIGTLBridge * ChannelFor(const std::string & fullCommand,
+                               const std::string & crtkCommand);
+
     //! Explict list of CRTK commands to bridge
     std::set<std::string> mBridgeOnly;
     bool ShouldBeBridged(const std::string & command);
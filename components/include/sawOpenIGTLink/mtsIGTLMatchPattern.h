@@ -0,0 +1,61 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIGTLMatchPattern_h
+#define _mtsIGTLMatchPattern_h
+
+/*!
+  \file
+  \brief Glob matching for device and command names
+
+  Header only, without cisst dependencies, so the same rules apply to
+  mtsIGTLBridge and the utilities (see igtl_relay).
+*/
+
+#include <string>
+
+/*! Simple glob matching, supports '*' (any sequence, including
+  empty) and '?' (any character). */
+inline bool mtsIGTLMatchPattern(const std::string & pattern,
+                                const std::string & name)
+{
+    // iterative matching, backtrack to last '*' on mismatch
+    size_t p = 0, n = 0;
+    size_t star = std::string::npos, starName = 0;
+    while (n < name.size()) {
+        if ((p < pattern.size())
+            && ((pattern[p] == '?') || (pattern[p] == name[n]))) {
+            ++p;
+            ++n;
+        } else if ((p < pattern.size()) && (pattern[p] == '*')) {
+            star = p++;
+            starName = n;
+        } else if (star != std::string::npos) {
+            p = star + 1;
+            n = ++starName;
+        } else {
+            return false;
+        }
+    }
+    while ((p < pattern.size()) && (pattern[p] == '*')) {
+        ++p;
+    }
+    return (p == pattern.size());
+}
+
+#endif // _mtsIGTLMatchPattern_h
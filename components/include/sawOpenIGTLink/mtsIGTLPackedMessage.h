@@ -0,0 +1,189 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIGTLPackedMessage_h
+#define _mtsIGTLPackedMessage_h
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <cisstCommon/cmnPortability.h>
+
+// Always include last!
+#include <sawOpenIGTLink/sawOpenIGTLinkExport.h>
+
+/*!
+  \brief Pre-packed OpenIGTLink message (header and body)
+
+  The body is written directly in network byte order by the conversion
+  functions (see mtsCISSTToIGTL) so there is no intermediate igtl
+  message or array.  The buffer is re-used from one call to the next,
+  it is only re-allocated if the body size increases.  Header is
+  always version 1.
+*/
+class CISST_EXPORT mtsIGTLPackedMessage
+{
+public:
+    enum {HEADER_SIZE = 58,
+          TYPE_OFFSET = 2,
+          TYPE_SIZE = 12,
+          NAME_SIZE = 20,
+          BODY_SIZE_OFFSET = 42,
+          CRC_OFFSET = 50};
+
+    mtsIGTLPackedMessage(void);
+
+    void SetDeviceType(const std::string & deviceType);
+    void SetDeviceName(const std::string & deviceName);
+
+    inline const std::string & GetDeviceType(void) const {
+        return mDeviceType;
+    }
+    inline const std::string & GetDeviceName(void) const {
+        return mDeviceName;
+    }
+
+    /*! Time in seconds, 0 means no timestamp.  The fraction is
+      rounded to the nearest 2^-32 second, times past the 32 bits range
+      of seconds are clamped. */
+    void SetTimeStamp(const double & timeStamp);
+
+    /*! Resize the buffer for the new body size and returns a pointer
+      to the body so the caller can fill it. */
+    unsigned char * AllocateBody(const size_t bodySize);
+
+    //! Write header, including CRC of body
+    void Pack(void);
+
+    // same names as igtl::MessageBase so it can be used with mtsIGTLBridge::Send
+    inline void * GetPackPointer(void) {
+        return mBuffer.data();
+    }
+    inline size_t GetPackSize(void) const {
+        return mBuffer.size();
+    }
+    inline unsigned char * GetPackBodyPointer(void) {
+        return mBuffer.data() + HEADER_SIZE;
+    }
+    inline size_t GetPackBodySize(void) const {
+        return mBuffer.size() - HEADER_SIZE;
+    }
+
+    //! Helpers to write in network byte order (big endian)
+    static inline unsigned char * WriteUint8(unsigned char * buffer, const unsigned char value) {
+        *buffer = value;
+        return buffer + 1;
+    }
+    static inline unsigned char * WriteUint16(unsigned char * buffer, const unsigned short value) {
+        buffer[0] = static_cast<unsigned char>(value >> 8);
+        buffer[1] = static_cast<unsigned char>(value);
+        return buffer + 2;
+    }
+    static inline unsigned char * WriteUint32(unsigned char * buffer, const unsigned int value) {
+        for (size_t index = 0; index < 4; ++index) {
+            buffer[index] = static_cast<unsigned char>(value >> (8 * (3 - index)));
+        }
+        return buffer + 4;
+    }
+    static inline unsigned char * WriteUint64(unsigned char * buffer, const unsigned long long value) {
+        for (size_t index = 0; index < 8; ++index) {
+            buffer[index] = static_cast<unsigned char>(value >> (8 * (7 - index)));
+        }
+        return buffer + 8;
+    }
+    static inline unsigned char * WriteFloat32(unsigned char * buffer, const float value) {
+        unsigned int raw;
+        memcpy(&raw, &value, 4);
+        return WriteUint32(buffer, raw);
+    }
+    static inline unsigned char * WriteFloat64(unsigned char * buffer, const double value) {
+        unsigned long long raw;
+        memcpy(&raw, &value, 8);
+        return WriteUint64(buffer, raw);
+    }
+
+    //! Read in network byte order, e.g. CRC in a received header
+    static inline unsigned long long ReadUint64(const unsigned char * buffer) {
+        unsigned long long value = 0;
+        for (size_t index = 0; index < 8; ++index) {
+            value = (value << 8) | buffer[index];
+        }
+        return value;
+    }
+    static inline unsigned int ReadUint32(const unsigned char * buffer) {
+        unsigned int value = 0;
+        for (size_t index = 0; index < 4; ++index) {
+            value = (value << 8) | buffer[index];
+        }
+        return value;
+    }
+    static inline float ReadFloat32(const unsigned char * buffer) {
+        const unsigned int raw = ReadUint32(buffer);
+        float value;
+        memcpy(&value, &raw, 4);
+        return value;
+    }
+
+    /*! Write arrays of doubles in network byte order, as float 64 or
+      narrowed to float 32, returns pointer after last element.  These
+      use SSSE3 or AVX2 byte swaps when the CPU supports them, one
+      element at a time otherwise. */
+    static unsigned char * WriteFloat64Array(unsigned char * buffer,
+                                             const double * values, const size_t count);
+    static unsigned char * WriteFloat32Array(unsigned char * buffer,
+                                             const double * values, const size_t count);
+
+    //! Read array of float 32 in network byte order as doubles, vectorized as above
+    static const unsigned char * ReadFloat32Array(const unsigned char * buffer,
+                                                  double * values, const size_t count);
+
+    /*! Kernels used by the array functions above.  The best kernel
+      supported by the CPU is selected once, the others can be used
+      explicitly to compare results and performances (see tests). */
+    typedef enum {ARRAY_KERNEL_SCALAR, ARRAY_KERNEL_SSSE3, ARRAY_KERNEL_AVX2} ArrayKernelType;
+
+    //! Kernel used by WriteFloat64Array, WriteFloat32Array and ReadFloat32Array
+    static ArrayKernelType GetArrayKernel(void);
+
+    //! True if the kernel is compiled in and supported by the CPU
+    static bool ArrayKernelAvailable(const ArrayKernelType kernel);
+
+    //! Name of the kernel, e.g. "avx2"
+    static const char * ArrayKernelName(const ArrayKernelType kernel);
+
+    /*! Same as above using the given kernel, the scalar kernel is used
+      if the kernel is not available. */
+    static unsigned char * WriteFloat64Array(const ArrayKernelType kernel,
+                                             unsigned char * buffer,
+                                             const double * values, const size_t count);
+    static unsigned char * WriteFloat32Array(const ArrayKernelType kernel,
+                                             unsigned char * buffer,
+                                             const double * values, const size_t count);
+    static const unsigned char * ReadFloat32Array(const ArrayKernelType kernel,
+                                                  const unsigned char * buffer,
+                                                  double * values, const size_t count);
+
+protected:
+    std::vector<unsigned char> mBuffer;
+    std::string mDeviceType;
+    std::string mDeviceName;
+    double mTimeStamp;
+};
+
+#endif // _mtsIGTLPackedMessage_h
@@ -0,0 +1,76 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIGTLPoseBatch_h
+#define _mtsIGTLPoseBatch_h
+
+#include <cstddef>
+#include <vector>
+
+#include <cisstVector/vctTransformationTypes.h>
+
+// Always include last!
+#include <sawOpenIGTLink/sawOpenIGTLinkExport.h>
+
+/*!
+  \brief Many Cartesian poses converted to or from TRANSFORM bodies in one pass
+
+  Poses are stored as structure of arrays, one array per component
+  using the TRANSFORM body order (rotation column major followed by
+  translation).  Each component is converted for all poses at once
+  using the vectorized kernels of mtsIGTLPackedMessage, then written
+  to (or read from) the 48 bytes body of each message.  The bridge
+  uses this for all TRANSFORM messages sent or received in a cycle.
+*/
+class CISST_EXPORT mtsIGTLPoseBatch
+{
+public:
+    enum {NB_COMPONENTS = 12,
+          BODY_SIZE = 12 * 4};
+
+    //! Number of poses, existing poses are not kept
+    void Resize(const size_t nbPoses);
+
+    inline size_t size(void) const {
+        return mSize;
+    }
+
+    void Set(const size_t index, const vctFrm3 & pose);
+    //! Rotation is not normalized
+    void Get(const size_t index, vctFrm3 & pose) const;
+
+    //! Write float 32 TRANSFORM bodies, one per pose
+    void PackTransforms(unsigned char * const * bodies);
+    //! Read float 32 TRANSFORM bodies, one per pose
+    void UnpackTransforms(const unsigned char * const * bodies);
+
+protected:
+    inline double * Component(const size_t component) {
+        return mComponents.data() + component * mSize;
+    }
+    inline const double * Component(const size_t component) const {
+        return mComponents.data() + component * mSize;
+    }
+
+    size_t mSize = 0;
+    std::vector<double> mComponents;
+    //! Components in network byte order, same layout as mComponents
+    std::vector<unsigned char> mWire;
+};
+
+#endif // _mtsIGTLPoseBatch_h
@@ -0,0 +1,80 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIGTLReceiveBuffer_h
+#define _mtsIGTLReceiveBuffer_h
+
+#include <cstddef>
+#include <vector>
+
+// Always include last!
+#include <sawOpenIGTLink/sawOpenIGTLinkExport.h>
+
+/*!
+  \brief Receive ring buffer used for each client of the bridge
+
+  The socket writes directly in the free space (see WritePointer and
+  CommitWrite) so large reads can be used.  The parser then peeks at
+  the message header and reads (copies out) or skips complete
+  messages.  Partial messages stay in the buffer until more data
+  arrives.  The buffer can grow for messages larger than the current
+  capacity.
+*/
+class CISST_EXPORT mtsIGTLReceiveBuffer
+{
+public:
+    mtsIGTLReceiveBuffer(const size_t capacity = 64 * 1024);
+
+    //! Number of bytes received and not yet read
+    inline size_t Size(void) const {
+        return mSize;
+    }
+
+    inline size_t Capacity(void) const {
+        return mBuffer.size();
+    }
+
+    /*! Pointer to contiguous free space and its size, 0 if the buffer
+      is full.  Call CommitWrite with the number of bytes written. */
+    unsigned char * WritePointer(size_t & contiguousSize);
+    void CommitWrite(const size_t nbBytes);
+
+    //! Copy data in buffer, grows the buffer if needed
+    void Write(const void * source, const size_t nbBytes);
+
+    //! Copy without consuming, false if not enough data
+    bool Peek(void * destination, const size_t nbBytes) const;
+    //! Copy and consume, false if not enough data
+    bool Read(void * destination, const size_t nbBytes);
+    //! Consume, false if not enough data
+    bool Skip(const size_t nbBytes);
+
+    //! CRC64 of the next bytes without consuming, see mtsIGTLCRC64
+    unsigned long long CRC64(const size_t nbBytes) const;
+
+    //! Grow capacity, data is kept.  Never shrinks.
+    void Reserve(const size_t capacity);
+
+protected:
+    std::vector<unsigned char> mBuffer;
+    //! Index of first byte to read
+    size_t mHead;
+    size_t mSize;
+};
+
+#endif // _mtsIGTLReceiveBuffer_h
@@ -0,0 +1,365 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIGTLSharedMemory_h
+#define _mtsIGTLSharedMemory_h
+
+/*!
+  \file
+  \brief Shared memory transport for clients on the same host (POSIX only)
+
+  Header only, without cisst dependencies, so it can be used by
+  clients (see utilities/igtl_receive) as well as by mtsIGTLBridge.
+
+  The bridge (single writer) publishes packed OpenIGTLink messages in
+  a broadcast ring buffer created with shm_open, e.g. in /dev/shm.
+  Each frame is the message length (32 bits, host byte order)
+  followed by the message itself (standard OpenIGTLink header and
+  body), padded to 8 bytes.  Readers keep their own position and
+  detect when the writer laps them, frames overwritten are counted as
+  lost and the reader skips all frames published so far, it continues
+  with the next frame published.  On Linux, readers wait for new
+  frames using a futex, the writer only calls the kernel to wake up
+  readers if some are waiting.
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+//! Memory layout at the beginning of the shared memory segment
+class mtsIGTLSharedMemoryLayout
+{
+public:
+    enum {MAGIC = 0x4c544749, // IGTL
+          VERSION = 1,
+          DATA_OFFSET = 64,
+          ALIGNMENT = 8};
+
+    //! Length used to mark the end of the ring, frame continues at 0
+    static const uint32_t PADDING = 0xffffffff;
+
+    std::atomic<uint32_t> Magic;
+    uint32_t Version;
+    uint64_t Capacity;
+    //! End of the region the writer is writing, set before writing
+    std::atomic<uint64_t> Reserved;
+    //! End of the last frame published
+    std::atomic<uint64_t> Committed;
+    //! Incremented for each frame, used as futex
+    std::atomic<uint32_t> Sequence;
+    //! Number of readers waiting on the futex
+    std::atomic<uint32_t> Waiters;
+
+    static inline uint64_t Align(const uint64_t size) {
+        return (size + ALIGNMENT - 1) & ~static_cast<uint64_t>(ALIGNMENT - 1);
+    }
+
+    inline unsigned char * Data(void) {
+        return reinterpret_cast<unsigned char *>(this) + DATA_OFFSET;
+    }
+};
+
+/*! Base class for reader and writer, maps the shared memory segment */
+class mtsIGTLSharedMemoryBase
+{
+public:
+    inline mtsIGTLSharedMemoryBase(void):
+        mLayout(nullptr),
+        mSize(0) {}
+
+    inline ~mtsIGTLSharedMemoryBase() {
+        Unmap();
+    }
+
+    inline bool IsOpen(void) const {
+        return (mLayout != nullptr);
+    }
+
+    inline const std::string & GetName(void) const {
+        return mName;
+    }
+
+protected:
+    inline bool Map(const int descriptor, const size_t size) {
+        void * address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        close(descriptor);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        mLayout = static_cast<mtsIGTLSharedMemoryLayout *>(address);
+        mSize = size;
+        return true;
+    }
+
+    inline void Unmap(void) {
+        if (mLayout) {
+            munmap(mLayout, mSize);
+            mLayout = nullptr;
+            mSize = 0;
+        }
+    }
+
+    std::string mName;
+    mtsIGTLSharedMemoryLayout * mLayout;
+    size_t mSize;
+};
+
+/*! Writer used by the bridge, creates the shared memory segment and
+  removes it when closed. */
+class mtsIGTLSharedMemoryWriter: public mtsIGTLSharedMemoryBase
+{
+public:
+    inline ~mtsIGTLSharedMemoryWriter() {
+        Close();
+    }
+
+    /*! Create segment, name must start with '/' (see shm_open), the
+      capacity is rounded to a multiple of 8 bytes.  By default, only
+      the bridge user can read the messages (mode 0600), use 0660 or
+      0644 to share with other users. */
+    inline bool Open(const std::string & name, const size_t capacity,
+                     const mode_t mode = 0600) {
+        Close();
+        const uint64_t dataSize = mtsIGTLSharedMemoryLayout::Align(capacity);
+        const size_t size = mtsIGTLSharedMemoryLayout::DATA_OFFSET + dataSize;
+        const int descriptor = shm_open(name.c_str(), O_CREAT | O_RDWR, mode);
+        if (descriptor < 0) {
+            return false;
+        }
+        // mode is masked by umask and ignored if the segment exists
+        if ((fchmod(descriptor, mode) != 0)
+            || (ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+            || !Map(descriptor, size)) {
+            shm_unlink(name.c_str());
+            return false;
+        }
+        mName = name;
+        // readers check magic last
+        mLayout->Magic.store(0, std::memory_order_relaxed);
+        mLayout->Version = mtsIGTLSharedMemoryLayout::VERSION;
+        mLayout->Capacity = dataSize;
+        mLayout->Reserved.store(0, std::memory_order_relaxed);
+        mLayout->Committed.store(0, std::memory_order_relaxed);
+        mLayout->Sequence.store(0, std::memory_order_relaxed);
+        mLayout->Waiters.store(0, std::memory_order_relaxed);
+        mLayout->Magic.store(mtsIGTLSharedMemoryLayout::MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    inline void Close(void) {
+        if (IsOpen()) {
+            Unmap();
+            shm_unlink(mName.c_str());
+        }
+    }
+
+    /*! Publish a packed message, returns false if the message is
+      larger than half the capacity. */
+    inline bool Write(const unsigned char * data, const size_t size) {
+        if (!IsOpen()) {
+            return false;
+        }
+        const uint64_t capacity = mLayout->Capacity;
+        const uint64_t frameSize = mtsIGTLSharedMemoryLayout::Align(sizeof(uint32_t) + size);
+        if (frameSize > capacity / 2) {
+            return false;
+        }
+        uint64_t position = mLayout->Committed.load(std::memory_order_relaxed);
+        uint64_t offset = position % capacity;
+        unsigned char * buffer = mLayout->Data();
+        // not enough room at the end of the ring, mark and wrap
+        const bool wrap = (offset + frameSize > capacity);
+        const uint64_t end = position + (wrap ? (capacity - offset) : 0) + frameSize;
+        // readers check this after reading a frame
+        mLayout->Reserved.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        if (wrap) {
+            const uint32_t padding = mtsIGTLSharedMemoryLayout::PADDING;
+            memcpy(buffer + offset, &padding, sizeof(uint32_t));
+            position += capacity - offset;
+            offset = 0;
+        }
+        const uint32_t length = static_cast<uint32_t>(size);
+        memcpy(buffer + offset, &length, sizeof(uint32_t));
+        memcpy(buffer + offset + sizeof(uint32_t), data, size);
+        mLayout->Committed.store(end, std::memory_order_release);
+        // wake up readers only if needed.  Sequentially consistent
+        // with Waiters in Wait: either we see the reader waiting or
+        // the futex sees the new sequence and doesn't sleep.
+        mLayout->Sequence.fetch_add(1, std::memory_order_seq_cst);
+#if defined(__linux__)
+        if (mLayout->Waiters.load(std::memory_order_seq_cst) > 0) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&(mLayout->Sequence)),
+                    FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+#endif
+        return true;
+    }
+};
+
+/*! Reader used by clients, only frames published after Open are read */
+class mtsIGTLSharedMemoryReader: public mtsIGTLSharedMemoryBase
+{
+public:
+    inline mtsIGTLSharedMemoryReader(void):
+        mPosition(0),
+        mLost(0) {}
+
+    inline bool Open(const std::string & name) {
+        Unmap();
+        const int descriptor = shm_open(name.c_str(), O_RDWR, 0);
+        if (descriptor < 0) {
+            return false;
+        }
+        struct stat status;
+        if ((fstat(descriptor, &status) != 0)
+            || (static_cast<size_t>(status.st_size) <= mtsIGTLSharedMemoryLayout::DATA_OFFSET)
+            || !Map(descriptor, static_cast<size_t>(status.st_size))) {
+            return false;
+        }
+        if ((mLayout->Magic.load(std::memory_order_acquire) != mtsIGTLSharedMemoryLayout::MAGIC)
+            || (mLayout->Version != mtsIGTLSharedMemoryLayout::VERSION)) {
+            Unmap();
+            return false;
+        }
+        mName = name;
+        mPosition = mLayout->Committed.load(std::memory_order_acquire);
+        return true;
+    }
+
+    inline void Close(void) {
+        Unmap();
+    }
+
+    //! Number of frames overwritten before they could be read
+    inline size_t GetLost(void) const {
+        return mLost;
+    }
+
+    /*! Read next frame (full OpenIGTLink message), wait up to timeout
+      in milliseconds for a new frame if none is available.  Returns
+      false on timeout. */
+    inline bool Read(std::vector<unsigned char> & frame, const int timeout) {
+        if (!IsOpen()) {
+            return false;
+        }
+        const uint64_t capacity = mLayout->Capacity;
+        const unsigned char * buffer = mLayout->Data();
+        while (true) {
+            const uint32_t sequence = mLayout->Sequence.load(std::memory_order_acquire);
+            const uint64_t committed = mLayout->Committed.load(std::memory_order_acquire);
+            if (mPosition == committed) {
+                if (!Wait(sequence, timeout)) {
+                    return false;
+                }
+                continue;
+            }
+            // writer lapped us, skip all frames published so far
+            if (committed - mPosition > capacity) {
+                ++mLost;
+                mPosition = committed;
+                continue;
+            }
+            const uint64_t offset = mPosition % capacity;
+            uint32_t length;
+            memcpy(&length, buffer + offset, sizeof(uint32_t));
+            if (length == mtsIGTLSharedMemoryLayout::PADDING) {
+                if (!Valid()) {
+                    continue;
+                }
+                mPosition += capacity - offset;
+                continue;
+            }
+            if (length > capacity / 2) {
+                // overwritten while reading the length
+                ++mLost;
+                mPosition = committed;
+                continue;
+            }
+            frame.resize(length);
+            memcpy(frame.data(), buffer + offset + sizeof(uint32_t), length);
+            if (!Valid()) {
+                continue;
+            }
+            mPosition += mtsIGTLSharedMemoryLayout::Align(sizeof(uint32_t) + length);
+            return true;
+        }
+    }
+
+protected:
+    //! Check that the frame just read has not been overwritten
+    inline bool Valid(void) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t reserved = mLayout->Reserved.load(std::memory_order_relaxed);
+        if (reserved > mPosition + mLayout->Capacity) {
+            ++mLost;
+            mPosition = mLayout->Committed.load(std::memory_order_acquire);
+            return false;
+        }
+        return true;
+    }
+
+    //! Wait for sequence to change, returns false on timeout
+    inline bool Wait(const uint32_t sequence, const int timeout) {
+        if (timeout <= 0) {
+            return false;
+        }
+#if defined(__linux__)
+        struct timespec ts;
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000L;
+        // see Write, the futex checks the sequence after Waiters is set
+        mLayout->Waiters.fetch_add(1, std::memory_order_seq_cst);
+        const long result = syscall(SYS_futex, reinterpret_cast<uint32_t *>(&(mLayout->Sequence)),
+                                    FUTEX_WAIT, sequence, &ts, nullptr, 0);
+        const bool timedOut = (result != 0) && (errno == ETIMEDOUT);
+        mLayout->Waiters.fetch_sub(1, std::memory_order_seq_cst);
+        return !timedOut;
+#else
+        // no futex, poll
+        for (int elapsed = 0; elapsed < timeout; ++elapsed) {
+            if (mLayout->Sequence.load(std::memory_order_acquire) != sequence) {
+                return true;
+            }
+            usleep(1000);
+        }
+        return false;
+#endif
+    }
+
+    uint64_t mPosition;
+    size_t mLost;
+};
+
+#endif // _mtsIGTLSharedMemory_h
@@ -20,14 +20,18 @@ http://www.cisst.org/cisst/license.txt.
 #define _mtsITGLToCISST_h
 
 #include <igtlTransformMessage.h>
+#include <igtlPositionMessage.h>
 #include <igtlStringMessage.h>
 #include <igtlSensorMessage.h>
 #include <igtlPointMessage.h>
+#include <igtlNDArrayMessage.h>
 #include <cisstMultiTask/mtsParameterTypes.h>
 #include <cisstParameterTypes/prmPositionJointSet.h>
 #include <cisstParameterTypes/prmPositionCartesianSet.h>
 #include <cisstParameterTypes/prmForceCartesianSet.h>
 #include <cisstParameterTypes/prmStateJoint.h>
+#include <cisstVector/vctDynamicMatrixTypes.h>
+#include <cisstVector/vctDynamicVectorTypes.h>
 
 bool mtsIGTLToCISST(const igtl::StringMessage::Pointer igtlData,
                     std::string & cisstData);
@@ -41,13 +45,39 @@ bool mtsIGTLToCISST(const igtl::Matrix4x4 & igtlData,
 bool mtsIGTLToCISST(const igtl::TransformMessage::Pointer igtlData,
                     prmPositionCartesianSet & cisstData);
 
+/*! Only the quaternion is normalized, this is cheaper than
+  normalizing the rotation matrix of a TRANSFORM message. */
+bool mtsIGTLToCISST(const igtl::PositionMessage::Pointer igtlData,
+                    prmPositionCartesianSet & cisstData);
+
 bool mtsIGTLToCISST(const igtl::SensorMessage::Pointer igtlData,
                     prmForceCartesianSet & cisstData);
 
 bool mtsIGTLToCISST(const igtl::SensorMessage::Pointer igtlData,
                     prmStateJoint & cisstData);
 
+/*! NDARRAY conversions accept both float32 and float64 arrays.  For
+  prmPositionJointSet, all elements are used as goal. */
+bool mtsIGTLToCISST(const igtl::NDArrayMessage::Pointer igtlData,
+                    prmPositionJointSet & cisstData);
+
+/*! Expects the 6 rows layout used by mtsCISSTToIGTL,
+  i.e. pos_flag/pos/vel_flag/vel/effort_flag/effort. */
+bool mtsIGTLToCISST(const igtl::NDArrayMessage::Pointer igtlData,
+                    prmStateJoint & cisstData);
+
 bool mtsIGTLToCISST(const igtl::PointMessage::Pointer igtlData,
                     vct3 & cisstData);
 
+//! Decode all point elements, container is resized as needed
+bool mtsIGTLToCISST(const igtl::PointMessage::Pointer igtlData,
+                    std::vector<vct3> & cisstData);
+
+bool mtsIGTLToCISST(const igtl::PointMessage::Pointer igtlData,
+                    vctDynamicVector<vct3> & cisstData);
+
+//! Decode all point elements in a N x 3 matrix, one point per row
+bool mtsIGTLToCISST(const igtl::PointMessage::Pointer igtlData,
+                    vctDoubleMat & cisstData);
+
 #endif  // _mtsITGLToCISST_h
@@ -0,0 +1,112 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIGTLTrace_h
+#define _mtsIGTLTrace_h
+
+#include <string>
+#include <vector>
+
+#include <cisstOSAbstraction/osaGetTime.h>
+
+// Always include last!
+#include <sawOpenIGTLink/sawOpenIGTLinkExport.h>
+
+/*!
+  \brief Low overhead tracing for the IGTL bridge
+
+  Events are stored in a fixed size ring buffer, the oldest events are
+  overwritten.  Tracing is disabled until SetSize is called with a non
+  zero size.  Events can be saved using the Chrome trace JSON format
+  (see chrome://tracing or https://ui.perfetto.dev).
+
+  Typical use, each call to Add returns the current time so it can be
+  used as start time for the next phase:
+  \code
+  double start = trace.Time();
+  ...
+  start = trace.Add("pull", name, start);
+  ...
+  start = trace.Add("convert", name, start);
+  \endcode
+*/
+class CISST_EXPORT mtsIGTLTrace
+{
+public:
+    enum {DETAIL_SIZE = 32};
+
+    class Event {
+    public:
+        //! Must be a string literal or have a longer lifetime than the trace
+        const char * Name;
+        //! Device name or client address, truncated
+        char Detail[DETAIL_SIZE];
+        double Start;
+        double Duration;
+    };
+
+    mtsIGTLTrace(void);
+
+    //! Allocate ring buffer, 0 disables tracing
+    void SetSize(const size_t nbEvents);
+
+    inline bool Enabled(void) const {
+        return mEnabled;
+    }
+
+    //! Current time if enabled, 0 otherwise
+    inline double Time(void) const {
+        return mEnabled ? osaGetTime() : 0.0;
+    }
+
+    /*! Add event from start to now and return now so it can be used
+      as start time for next event. */
+    inline double Add(const char * name, const std::string & detail,
+                      const double & start) {
+        if (!mEnabled) {
+            return 0.0;
+        }
+        const double now = osaGetTime();
+        AddEvent(name, detail.c_str(), start, now);
+        return now;
+    }
+
+    inline double Add(const char * name, const double & start) {
+        if (!mEnabled) {
+            return 0.0;
+        }
+        const double now = osaGetTime();
+        AddEvent(name, "", start, now);
+        return now;
+    }
+
+    //! Save all events in ring buffer, oldest first
+    bool SaveChromeTrace(const std::string & fileName,
+                         const std::string & processName) const;
+
+protected:
+    void AddEvent(const char * name, const char * detail,
+                  const double & start, const double & end);
+
+    bool mEnabled;
+    std::vector<Event> mEvents;
+    size_t mNext;
+    size_t mCount;
+};
+
+#endif // _mtsIGTLTrace_h
@@ -0,0 +1,324 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIGTLTransport_h
+#define _mtsIGTLTransport_h
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+// Always include last!
+#include <sawOpenIGTLink/sawOpenIGTLinkExport.h>
+
+/*!
+  \brief Connection between the bridge and one client
+
+  All operations are non blocking.  Connections based on a file
+  descriptor (sockets) return it so the bridge can wait for data
+  using select or io_uring.  Other connections either signal the
+  bridge wakeup when data arrives (see SetWakeup) or are polled.
+*/
+class mtsIGTLWakeup;
+
+class CISST_EXPORT mtsIGTLConnection
+{
+public:
+    inline mtsIGTLConnection(const std::string & name):
+        mName(name) {}
+
+    virtual ~mtsIGTLConnection() {}
+
+    //! Used for logs, traces and quotas, e.g. address:port
+    inline const std::string & GetName(void) const {
+        return mName;
+    }
+
+    //! Descriptor to wait for data, -1 if the connection must be polled
+    virtual int GetDescriptor(void) const {
+        return -1;
+    }
+
+    /*! True if the descriptor can be used with select.  On POSIX
+      systems, descriptors past FD_SETSIZE can't be added to an
+      fd_set, these connections are polled. */
+    static bool Selectable(const int descriptor);
+
+    /*! For connections without descriptor, signal wakeup when data
+      is received or the connection is closed so the bridge doesn't
+      have to poll.  Returns false if not supported. */
+    virtual bool SetWakeup(mtsIGTLWakeup *) {
+        return false;
+    }
+
+    /*! Receive available data, returns number of bytes received, 0
+      if no data is available and -1 if the connection is lost. */
+    virtual long long Receive(unsigned char * data, const size_t size) = 0;
+
+    /*! Send as much as possible, returns number of bytes sent, 0 if
+      the connection would block and -1 if the connection is lost. */
+    virtual long long Send(const unsigned char * data, const size_t size) = 0;
+
+    //! Stop all I/O without releasing resources, e.g. before io_uring releases requests
+    virtual void Shutdown(void) {}
+
+protected:
+    std::string mName;
+};
+
+/*! \brief Accepts new connections, see mtsIGTLBridge::AddListener */
+class CISST_EXPORT mtsIGTLListener
+{
+public:
+    virtual ~mtsIGTLListener() {}
+
+    //! Returns new connection (owned by caller) or nullptr if none is pending
+    virtual mtsIGTLConnection * Accept(void) = 0;
+};
+
+/*! \brief TCP or Unix domain socket connection */
+class CISST_EXPORT mtsIGTLSocketConnection: public mtsIGTLConnection
+{
+public:
+    //! Takes ownership of the connected descriptor
+    mtsIGTLSocketConnection(const int descriptor,
+                            const std::string & name);
+    ~mtsIGTLSocketConnection();
+
+    int GetDescriptor(void) const override;
+    long long Receive(unsigned char * data, const size_t size) override;
+    long long Send(const unsigned char * data, const size_t size) override;
+    void Shutdown(void) override;
+
+protected:
+    int mDescriptor;
+};
+
+/*! \brief TCP server, IPv4 on all interfaces */
+class CISST_EXPORT mtsIGTLTCPListener: public mtsIGTLListener
+{
+public:
+    mtsIGTLTCPListener(void);
+    ~mtsIGTLTCPListener();
+
+    bool Create(const int port);
+    //! Never blocks, returns nullptr if no connection is pending
+    mtsIGTLConnection * Accept(void) override;
+
+protected:
+    int mDescriptor;
+};
+
+/*! \brief Unix domain socket server, POSIX only (see mtsIGTLUnixSocket.h) */
+class CISST_EXPORT mtsIGTLUnixListener: public mtsIGTLListener
+{
+public:
+    mtsIGTLUnixListener(void);
+    //! Closes the listening socket and removes the socket file if still ours
+    ~mtsIGTLUnixListener();
+
+    /*! Fails if path exists and is not a socket or if another
+      process listens on it, see mtsIGTLUnixSocket::Listen */
+    bool Create(const std::string & path);
+
+    /*! Connections are named unix:<path>:<n>, n is incremented for
+      each connection so clients can be told apart in logs and client
+      profiles (e.g. "unix:/tmp/arm.sock:*"). */
+    mtsIGTLConnection * Accept(void) override;
+
+protected:
+    int mDescriptor;
+    std::string mPath;
+    //! Socket file created, see mtsIGTLUnixSocket::Close
+    unsigned long long mDevice = 0;
+    unsigned long long mInode = 0;
+    size_t mConnections;
+};
+
+/*!
+  \brief Outgoing TCP connection, the bridge is then a client of
+  another OpenIGTLink server
+
+  Accept never blocks.  It starts a non blocking connect and checks
+  for completion on the following calls, the connection is returned
+  once established.  The connector then waits for the bridge to
+  close that connection (e.g. server stopped) and reconnects.  Failed
+  attempts are retried after a delay doubled after each failure, up
+  to the maximum delay.  An attempt without answer from the server is
+  abandoned after the connect timeout.  The host is resolved again
+  before each attempt so a server with a new address is found, if it
+  resolves to more than one address, they are used in turn.  Use a
+  numeric address to avoid DNS lookups in the periodic task.
+*/
+class CISST_EXPORT mtsIGTLTCPConnector: public mtsIGTLListener
+{
+public:
+    mtsIGTLTCPConnector(void);
+    ~mtsIGTLTCPConnector();
+
+    /*! Split "host:port", IPv6 addresses must be enclosed in brackets
+      (e.g. "[::1]:18944").  Returns false if the address is not valid. */
+    static bool ParseAddress(const std::string & address,
+                             std::string & host, int & port);
+
+    /*! Host and port to connect to, returns false if the host can't
+      be resolved now.  The connector still tries to resolve it
+      before each attempt. */
+    bool Create(const std::string & host, const int port);
+
+    //! Delays in seconds before first retry and between retries
+    inline void SetBackoff(const double & initialDelay, const double & maximumDelay) {
+        mInitialDelay = initialDelay;
+        mMaximumDelay = maximumDelay;
+        mDelay = initialDelay;
+    }
+
+    //! Seconds before an attempt in progress is abandoned, 0 to wait forever
+    inline void SetConnectTimeout(const double & timeout) {
+        mConnectTimeout = timeout;
+    }
+
+    mtsIGTLConnection * Accept(void) override;
+
+protected:
+    //! Resolve host into mAddress, next address after each failed attempt
+    bool Resolve(void);
+
+    //! Close socket and schedule next attempt
+    void Retry(void);
+
+    std::string mHost;
+    int mPort = 0;
+    std::string mName;
+    //! Resolved address, sockaddr_in or sockaddr_in6
+    std::vector<unsigned char> mAddress;
+    //! Failed attempts, used to pick one of the addresses
+    size_t mAttempts = 0;
+    int mDescriptor;
+    //! Time the attempt in progress started
+    double mAttemptStart = 0.0;
+    double mConnectTimeout = 2.0;
+    //! Reset by the connection when the bridge deletes it
+    std::shared_ptr<bool> mConnected;
+    double mNextAttempt;
+    double mInitialDelay = 0.1;
+    double mMaximumDelay = 5.0;
+    double mDelay = 0.1;
+};
+
+/*!
+  \brief In process transport
+
+  Each connection is a pair of byte pipes protected by a mutex, the
+  client end can be used from any thread.  There is no descriptor so
+  the bridge polls these connections, this is meant for benchmarks
+  and tests driving the full bridge without kernel noise.
+
+  \code
+  mtsIGTLMemoryListener * listener = new mtsIGTLMemoryListener;
+  bridge->AddListener(listener); // bridge owns listener
+  std::unique_ptr<mtsIGTLConnection> client(listener->Connect("benchmark"));
+  client->Send(packedMessage, size);
+  \endcode
+*/
+class CISST_EXPORT mtsIGTLMemoryListener: public mtsIGTLListener
+{
+public:
+    //! Capacity of each pipe in bytes, sends would block past it
+    mtsIGTLMemoryListener(const size_t capacity = 16 * 1024 * 1024);
+    //! Deletes connections not accepted, client ends are then closed
+    ~mtsIGTLMemoryListener();
+
+    /*! Create connection, returns client end (owned by caller), the
+      bridge end is returned by the next Accept. */
+    mtsIGTLConnection * Connect(const std::string & name);
+
+    mtsIGTLConnection * Accept(void) override;
+
+protected:
+    size_t mCapacity;
+    std::mutex mMutex;
+    std::list<mtsIGTLConnection *> mPending;
+};
+
+/*! \brief One end of an in process connection, see mtsIGTLMemoryListener */
+class CISST_EXPORT mtsIGTLMemoryConnection: public mtsIGTLConnection
+{
+public:
+    class Pipe {
+    public:
+        std::mutex Mutex;
+        std::vector<unsigned char> Data;
+        //! Bytes before Start have been read
+        size_t Start = 0;
+        size_t Capacity = 0;
+        bool Closed = false;
+        //! Signaled for the reader, see SetWakeup
+        mtsIGTLWakeup * Wakeup = nullptr;
+    };
+    typedef std::shared_ptr<Pipe> PipePointer;
+
+    mtsIGTLMemoryConnection(const std::string & name,
+                            PipePointer in, PipePointer out);
+    //! Closes both pipes, the other end then gets -1
+    ~mtsIGTLMemoryConnection();
+
+    long long Receive(unsigned char * data, const size_t size) override;
+    long long Send(const unsigned char * data, const size_t size) override;
+    void Shutdown(void) override;
+    bool SetWakeup(mtsIGTLWakeup * wakeup) override;
+
+protected:
+    PipePointer mIn, mOut;
+};
+
+/*!
+  \brief Wakes up the bridge while it waits for data
+
+  Pair of connected sockets, the bridge waits on the read end along
+  with its connections.  Signal can be called from any thread, e.g. by
+  a trigger event handler.  Not available on Windows, GetDescriptor
+  returns -1 and the bridge has to poll instead.
+*/
+class CISST_EXPORT mtsIGTLWakeup
+{
+public:
+    mtsIGTLWakeup(void);
+    ~mtsIGTLWakeup();
+
+    //! Descriptor to wait on, -1 if not available
+    inline int GetDescriptor(void) const {
+        return mDescriptors[0];
+    }
+
+    //! Thread safe, only the first signal until Clear writes to the socket
+    void Signal(void);
+
+    //! Drain pending signals, called after waiting
+    void Clear(void);
+
+protected:
+    int mDescriptors[2];
+    std::atomic<bool> mSignaled;
+};
+
+#endif // _mtsIGTLTransport_h
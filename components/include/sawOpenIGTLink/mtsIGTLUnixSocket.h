@@ -0,0 +1,193 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIGTLUnixSocket_h
+#define _mtsIGTLUnixSocket_h
+
+/*!
+  \file
+  \brief Unix domain sockets for clients on the same host (POSIX only)
+
+  Header only, without cisst dependencies, so it can be used by
+  clients (see utilities) as well as by mtsIGTLBridge.  Client
+  connections are wrapped in igtl::ClientSocket so the regular
+  OpenIGTLink framing and socket API can be used.
+*/
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <igtlClientSocket.h>
+
+/*! igtl::ClientSocket using a descriptor connected by
+  mtsIGTLUnixSocket, igtl::ClientSocket can only connect to TCP
+  servers. */
+class mtsIGTLUnixClientSocket: public igtl::ClientSocket
+{
+public:
+    typedef mtsIGTLUnixClientSocket Self;
+    typedef igtl::ClientSocket Superclass;
+    typedef igtl::SmartPointer<Self> Pointer;
+    typedef igtl::SmartPointer<const Self> ConstPointer;
+
+    igtlTypeMacro(mtsIGTLUnixClientSocket, igtl::ClientSocket);
+    igtlNewMacro(mtsIGTLUnixClientSocket);
+
+    //! Take ownership of connected descriptor, closed with the socket
+    inline void SetDescriptor(const int descriptor) {
+        m_SocketDescriptor = descriptor;
+    }
+
+protected:
+    mtsIGTLUnixClientSocket(void) {}
+    ~mtsIGTLUnixClientSocket() {}
+};
+
+//! Static helpers for Unix domain sockets
+class mtsIGTLUnixSocket
+{
+public:
+    /*! Create non blocking listening socket.  An existing socket file
+      with the same path is only removed if it is stale, i.e. no
+      process accepts connections on it, otherwise fails with errno
+      set to EADDRINUSE.  Fails with EEXIST if the path exists and is
+      not a socket, regular files are never removed.  The device and
+      inode of the socket file created are used by Close.  Returns
+      descriptor or -1. */
+    static inline int Listen(const std::string & path,
+                             unsigned long long & device,
+                             unsigned long long & inode) {
+        struct sockaddr_un address;
+        if (!Address(path, address)) {
+            return -1;
+        }
+        struct stat status;
+        if (lstat(path.c_str(), &status) == 0) {
+            if (!S_ISSOCK(status.st_mode)) {
+                errno = EEXIST;
+                return -1;
+            }
+            if (InUse(address)) {
+                errno = EADDRINUSE;
+                return -1;
+            }
+            unlink(path.c_str());
+        }
+        const int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (descriptor < 0) {
+            return -1;
+        }
+        if ((bind(descriptor, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0)
+            || (listen(descriptor, SOMAXCONN) != 0)
+            || (fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL, 0) | O_NONBLOCK) != 0)
+            || (lstat(path.c_str(), &status) != 0)) {
+            const int error = errno;
+            close(descriptor);
+            errno = error;
+            return -1;
+        }
+        device = static_cast<unsigned long long>(status.st_dev);
+        inode = static_cast<unsigned long long>(status.st_ino);
+        return descriptor;
+    }
+
+    /*! Close listening socket and remove socket file, only if the
+      file is still the one created by Listen.  Another process might
+      have replaced it since. */
+    static inline void Close(const int descriptor, const std::string & path,
+                             const unsigned long long device,
+                             const unsigned long long inode) {
+        if (descriptor < 0) {
+            return;
+        }
+        close(descriptor);
+        struct stat status;
+        if ((lstat(path.c_str(), &status) == 0)
+            && S_ISSOCK(status.st_mode)
+            && (static_cast<unsigned long long>(status.st_dev) == device)
+            && (static_cast<unsigned long long>(status.st_ino) == inode)) {
+            unlink(path.c_str());
+        }
+    }
+
+    /*! Accept pending connection without blocking, returns the
+      connected descriptor (blocking) or -1 if there is none. */
+    static inline int Accept(const int listener) {
+        const int descriptor = accept(listener, nullptr, nullptr);
+        if (descriptor < 0) {
+            return -1;
+        }
+        // some systems inherit O_NONBLOCK from the listening socket
+        fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL, 0) & ~O_NONBLOCK);
+        return descriptor;
+    }
+
+    //! Connect to a listening socket, returns a null pointer on failure
+    static inline igtl::ClientSocket::Pointer Connect(const std::string & path) {
+        struct sockaddr_un address;
+        if (!Address(path, address)) {
+            return igtl::ClientSocket::Pointer();
+        }
+        const int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (descriptor < 0) {
+            return igtl::ClientSocket::Pointer();
+        }
+        if (connect(descriptor, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0) {
+            close(descriptor);
+            return igtl::ClientSocket::Pointer();
+        }
+        mtsIGTLUnixClientSocket::Pointer socket = mtsIGTLUnixClientSocket::New();
+        socket->SetDescriptor(descriptor);
+        return socket.GetPointer();
+    }
+
+protected:
+    /*! True unless connecting to the socket file is refused, a file
+      left by a process that exited refuses connections.  A running
+      listener accepts the probe as a connection closed right away. */
+    static inline bool InUse(const struct sockaddr_un & address) {
+        const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe < 0) {
+            return true;
+        }
+        const int result = connect(probe, reinterpret_cast<const struct sockaddr *>(&address),
+                                   sizeof(address));
+        const int error = errno;
+        close(probe);
+        return (result == 0) || ((error != ECONNREFUSED) && (error != ENOENT));
+    }
+
+    static inline bool Address(const std::string & path, struct sockaddr_un & address) {
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.empty() || (path.size() >= sizeof(address.sun_path))) {
+            return false;
+        }
+        strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        return true;
+    }
+};
+
+#endif // _mtsIGTLUnixSocket_h
@@ -0,0 +1,151 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// Compares the array kernels used to pack NDARRAY messages with the
+// OpenIGTLink messages used as baseline, not run by ctest:
+// mtsIGTLArrayKernelBenchmark [number of doubles] [iterations]
+
+#include <sawOpenIGTLink/mtsIGTLPackedMessage.h>
+
+#include <igtlNDArrayMessage.h>
+#include <igtlSensorMessage.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// time per iteration in microseconds
+template <typename _function>
+static double TimeIterations(const size_t iterations, _function function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t iteration = 0; iteration < iterations; ++iteration) {
+        function();
+    }
+    const std::chrono::duration<double, std::micro> duration
+        = std::chrono::steady_clock::now() - start;
+    return duration.count() / static_cast<double>(iterations);
+}
+
+// igtl::NDArrayMessage filled the same way as mtsCISSTToIGTL, message
+// re-used and a new array for each pack
+template <typename _elementType>
+static void PackNDArray(igtl::NDArrayMessage::Pointer message, const int type,
+                        const std::vector<double> & values)
+{
+    igtl::Array<_elementType> * array = new igtl::Array<_elementType>;
+    igtl::ArrayBase::IndexType size(1, static_cast<igtlUint16>(values.size()));
+    array->SetSize(size);
+    _elementType * raw = static_cast<_elementType *>(array->GetRawArray());
+    for (size_t index = 0; index < values.size(); ++index) {
+        raw[index] = static_cast<_elementType>(values[index]);
+    }
+    message->SetArray(type, array);
+    message->Pack();
+}
+
+int main(int argc, char * argv[])
+{
+    typedef mtsIGTLPackedMessage Message;
+    const size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 6000;
+    const size_t iterations = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 10000;
+
+    std::vector<double> values(count);
+    for (size_t index = 0; index < count; ++index) {
+        values[index] = 0.001 * static_cast<double>(index);
+    }
+    std::vector<unsigned char> buffer(8 * count);
+    std::vector<double> read(count);
+
+    std::cout << count << " doubles, " << iterations << " iterations, selected kernel: "
+              << Message::ArrayKernelName(Message::GetArrayKernel()) << std::endl
+              << "kernel    float64 write   float32 write   float32 read (us per array)" << std::endl;
+
+    const Message::ArrayKernelType kernels[] = {Message::ARRAY_KERNEL_SCALAR,
+                                                Message::ARRAY_KERNEL_SSSE3,
+                                                Message::ARRAY_KERNEL_AVX2};
+    for (auto kernel : kernels) {
+        if (!Message::ArrayKernelAvailable(kernel)) {
+            std::cout << std::setw(8) << std::left << Message::ArrayKernelName(kernel)
+                      << "  not available" << std::endl;
+            continue;
+        }
+        double times[3];
+        for (size_t function = 0; function < 3; ++function) {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t iteration = 0; iteration < iterations; ++iteration) {
+                switch (function) {
+                case 0:
+                    Message::WriteFloat64Array(kernel, buffer.data(), values.data(), count);
+                    break;
+                case 1:
+                    Message::WriteFloat32Array(kernel, buffer.data(), values.data(), count);
+                    break;
+                default:
+                    Message::ReadFloat32Array(kernel, buffer.data(), read.data(), count);
+                    break;
+                }
+            }
+            const std::chrono::duration<double, std::micro> duration
+                = std::chrono::steady_clock::now() - start;
+            times[function] = duration.count() / static_cast<double>(iterations);
+        }
+        std::cout << std::setw(8) << std::left << Message::ArrayKernelName(kernel) << std::right
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(16) << times[0]
+                  << std::setw(16) << times[1]
+                  << std::setw(16) << times[2] << std::endl;
+    }
+
+    // OpenIGTLink baseline, NDARRAY sizes are 16 bits and SENSOR
+    // messages have at most 255 values
+    std::vector<double> igtlValues(values.begin(),
+                                   values.begin() + std::min(count, static_cast<size_t>(65535)));
+    igtl::NDArrayMessage::Pointer ndArray = igtl::NDArrayMessage::New();
+    ndArray->SetDeviceName("benchmark");
+    const double ndArray64 = TimeIterations(iterations, [&] {
+        PackNDArray<igtl_float64>(ndArray, igtl::NDArrayMessage::TYPE_FLOAT64, igtlValues);
+    });
+    const double ndArray32 = TimeIterations(iterations, [&] {
+        PackNDArray<igtl_float32>(ndArray, igtl::NDArrayMessage::TYPE_FLOAT32, igtlValues);
+    });
+    std::cout << std::setw(8) << std::left << "igtl" << std::right
+              << std::fixed << std::setprecision(3)
+              << std::setw(16) << ndArray64
+              << std::setw(16) << ndArray32
+              << std::setw(16) << "-"
+              << "   NDARRAY SetArray and Pack, " << igtlValues.size() << " values" << std::endl;
+
+    const unsigned int sensorLength = static_cast<unsigned int>(std::min(count, static_cast<size_t>(255)));
+    igtl::SensorMessage::Pointer sensor = igtl::SensorMessage::New();
+    sensor->SetDeviceName("benchmark");
+    const double sensor64 = TimeIterations(iterations, [&] {
+        sensor->SetLength(sensorLength);
+        sensor->SetValue(values.data());
+        sensor->Pack();
+    });
+    std::cout << std::setw(8) << std::left << "igtl" << std::right
+              << std::setw(16) << sensor64
+              << std::setw(16) << "-"
+              << std::setw(16) << "-"
+              << "   SENSOR SetValue and Pack, " << sensorLength << " values" << std::endl;
+    return 0;
+}
@@ -0,0 +1,90 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLPackedMessage.h>
+
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "sawOpenIGTLinkTests.h"
+
+// values covering rounding, special values and float 32 overflow
+static std::vector<double> Values(const size_t count)
+{
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+    std::vector<double> values(count);
+    const double specials[] = {0.0, -0.0, 1.0 / 3.0, 1.0e-40, 1.0e300, -1.0e300,
+                               std::numeric_limits<double>::quiet_NaN(),
+                               std::numeric_limits<double>::infinity(),
+                               -std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::denorm_min()};
+    const size_t nbSpecials = sizeof(specials) / sizeof(double);
+    for (size_t index = 0; index < count; ++index) {
+        values[index] = (index % 3 == 0) ? specials[(index / 3) % nbSpecials] : distribution(generator);
+    }
+    return values;
+}
+
+int main(void)
+{
+    typedef mtsIGTLPackedMessage Message;
+    const Message::ArrayKernelType kernels[] = {Message::ARRAY_KERNEL_SCALAR,
+                                                Message::ARRAY_KERNEL_SSSE3,
+                                                Message::ARRAY_KERNEL_AVX2};
+    SAW_IGTL_CHECK(Message::ArrayKernelAvailable(Message::ARRAY_KERNEL_SCALAR));
+    SAW_IGTL_CHECK(Message::ArrayKernelAvailable(Message::GetArrayKernel()));
+
+    // all counts up to a few vectors to cover the scalar tails
+    for (size_t count = 0; count < 70; ++count) {
+        const std::vector<double> values = Values(count);
+        std::vector<unsigned char> expected64(8 * count), expected32(4 * count);
+        Message::WriteFloat64Array(Message::ARRAY_KERNEL_SCALAR, expected64.data(), values.data(), count);
+        Message::WriteFloat32Array(Message::ARRAY_KERNEL_SCALAR, expected32.data(), values.data(), count);
+        std::vector<double> expectedRead(count);
+        Message::ReadFloat32Array(Message::ARRAY_KERNEL_SCALAR, expected32.data(), expectedRead.data(), count);
+
+        // scalar is the reference, one element at a time
+        for (size_t index = 0; index < count; ++index) {
+            unsigned char element[8];
+            Message::WriteFloat64(element, values[index]);
+            SAW_IGTL_CHECK(memcmp(element, expected64.data() + 8 * index, 8) == 0);
+        }
+
+        for (auto kernel : kernels) {
+            if (!Message::ArrayKernelAvailable(kernel)) {
+                continue;
+            }
+            std::vector<unsigned char> buffer64(8 * count), buffer32(4 * count);
+            std::vector<double> read(count);
+            SAW_IGTL_CHECK(Message::WriteFloat64Array(kernel, buffer64.data(), values.data(), count)
+                           == buffer64.data() + 8 * count);
+            SAW_IGTL_CHECK(Message::WriteFloat32Array(kernel, buffer32.data(), values.data(), count)
+                           == buffer32.data() + 4 * count);
+            SAW_IGTL_CHECK(Message::ReadFloat32Array(kernel, expected32.data(), read.data(), count)
+                           == expected32.data() + 4 * count);
+            SAW_IGTL_CHECK(buffer64 == expected64);
+            SAW_IGTL_CHECK(buffer32 == expected32);
+            SAW_IGTL_CHECK(memcmp(read.data(), expectedRead.data(), count * sizeof(double)) == 0);
+        }
+    }
+
+    return SAW_IGTL_TEST_RESULT();
+}
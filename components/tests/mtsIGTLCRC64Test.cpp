@@ -0,0 +1,146 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+#include <sawOpenIGTLink/mtsIGTLCRC64.h>
+#include <sawOpenIGTLink/mtsIGTLReceiveBuffer.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "sawOpenIGTLinkTests.h"
+
+// bit by bit ECMA-182, same as crc64 in igtl_util.c
+static unsigned long long ReferenceCRC64(const unsigned char * data, const size_t size)
+{
+    const unsigned long long polynomial = 0x42F0E1EBA9EA3693ULL;
+    unsigned long long crc = 0;
+    for (size_t index = 0; index < size; ++index) {
+        crc ^= static_cast<unsigned long long>(data[index]) << 56;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & (1ULL << 63)) ? ((crc << 1) ^ polynomial) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static const size_t BodySize = 16;
+
+class mtsIGTLCRC64TestReceiver: public mtsIGTLReceiverBase
+{
+public:
+    mtsIGTLCRC64TestReceiver(mtsIGTLBridge * bridge, size_t & received):
+        mtsIGTLReceiverBase("a", bridge),
+        mReceived(received) {}
+
+    bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase *,
+                 const bool) override {
+        buffer.Skip(BodySize);
+        ++mReceived;
+        return true;
+    }
+
+    bool ExecutePending(void) override {
+        return false;
+    }
+
+protected:
+    size_t & mReceived;
+};
+
+class mtsIGTLCRC64TestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLCRC64TestBridge(size_t & received):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mReceivers["a"] = new mtsIGTLCRC64TestReceiver(this, received);
+    }
+};
+
+int main(void)
+{
+    // standard check value
+    const unsigned char check[] = "123456789";
+    SAW_IGTL_CHECK(mtsIGTLCRC64(check, 9) == 0x6C40DF5F0B497347ULL);
+    SAW_IGTL_CHECK(mtsIGTLCRC64(check, 0) == 0);
+
+    // all lengths and alignments around the 8 bytes slices
+    std::mt19937 generator(42);
+    std::vector<unsigned char> data(300);
+    for (auto & byte : data) {
+        byte = static_cast<unsigned char>(generator());
+    }
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t size = 0; size + offset <= data.size(); size += 7) {
+            SAW_IGTL_CHECK(mtsIGTLCRC64(data.data() + offset, size)
+                           == ReferenceCRC64(data.data() + offset, size));
+        }
+    }
+
+    // continued over non contiguous parts
+    const unsigned long long full = mtsIGTLCRC64(data.data(), data.size());
+    for (size_t split = 0; split <= data.size(); split += 13) {
+        const unsigned long long first = mtsIGTLCRC64(data.data(), split);
+        SAW_IGTL_CHECK(mtsIGTLCRC64(data.data() + split, data.size() - split, first) == full);
+    }
+
+    // receive buffer computes the CRC when data wraps around
+    mtsIGTLReceiveBuffer buffer(256);
+    buffer.Write(data.data(), 200);
+    buffer.Skip(200);
+    buffer.Write(data.data(), 150);
+    SAW_IGTL_CHECK(buffer.CRC64(150) == ReferenceCRC64(data.data(), 150));
+    SAW_IGTL_CHECK(buffer.Size() == 150);
+
+    // policy names
+    mtsIGTLCRCPolicy policy;
+    SAW_IGTL_CHECK(mtsIGTLCRCPolicyFromString("skip", policy) && (policy == MTS_IGTL_CRC_SKIP));
+    SAW_IGTL_CHECK(mtsIGTLCRCPolicyFromString("verify-on-control-only", policy)
+                   && (policy == MTS_IGTL_CRC_VERIFY_CONTROL));
+    SAW_IGTL_CHECK(!mtsIGTLCRCPolicyFromString("never", policy));
+
+    // messages with an invalid CRC are dropped unless the policy skips verification
+    size_t received = 0;
+    mtsIGTLCRC64TestBridge bridge(received);
+    mtsIGTLMemoryListener listener;
+    std::unique_ptr<mtsIGTLConnection> client(listener.Connect("client"));
+    bridge.AddClient(listener.Accept());
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType("STRING");
+    message.SetDeviceName("a");
+    memcpy(message.AllocateBody(BodySize), data.data(), BodySize);
+    message.Pack();
+    const unsigned char * packed = static_cast<const unsigned char *>(message.GetPackPointer());
+    std::vector<unsigned char> corrupted(packed, packed + message.GetPackSize());
+    corrupted.back() ^= 0x01;
+
+    client->Send(packed, message.GetPackSize());
+    client->Send(corrupted.data(), corrupted.size());
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(received == 1);
+
+    bridge.SetCRCPolicy(MTS_IGTL_CRC_SKIP);
+    client->Send(corrupted.data(), corrupted.size());
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(received == 2);
+
+    return SAW_IGTL_TEST_RESULT();
+}
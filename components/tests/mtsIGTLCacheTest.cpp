@@ -0,0 +1,124 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+
+#include <memory>
+
+#include "sawOpenIGTLinkTests.h"
+
+// sends two message types for the same device
+class mtsIGTLCacheTestSender: public mtsIGTLSenderBase
+{
+public:
+    mtsIGTLCacheTestSender(mtsIGTLBridge * bridge):
+        mtsIGTLSenderBase("device", bridge) {}
+
+    bool Execute(void) override {
+        Send("STRING", 4);
+        Send("SENSOR", 8);
+        return true;
+    }
+
+protected:
+    void Send(const std::string & deviceType, const size_t bodySize) {
+        mtsIGTLPackedMessage message;
+        message.SetDeviceType(deviceType);
+        message.SetDeviceName(mName);
+        memset(message.AllocateBody(bodySize), 0, bodySize);
+        message.Pack();
+        mBridge->Send(&message);
+    }
+};
+
+class mtsIGTLCacheTestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLCacheTestBridge(void):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mSenders.push_back(new mtsIGTLCacheTestSender(this));
+        mSendersByPriorityValid = false;
+    }
+};
+
+// read all messages available, returns device types
+static std::vector<std::string> ReceiveTypes(mtsIGTLConnection * connection)
+{
+    std::vector<std::string> types;
+    std::vector<unsigned char> data;
+    unsigned char buffer[1024];
+    long long nbBytes;
+    while ((nbBytes = connection->Receive(buffer, sizeof(buffer))) > 0) {
+        data.insert(data.end(), buffer, buffer + nbBytes);
+    }
+    size_t offset = 0;
+    while (offset + mtsIGTLPackedMessage::HEADER_SIZE <= data.size()) {
+        const char * type = reinterpret_cast<const char *>(data.data() + offset + 2);
+        types.push_back(std::string(type, strnlen(type, mtsIGTLPackedMessage::TYPE_SIZE)));
+        offset += mtsIGTLPackedMessage::HEADER_SIZE
+            + mtsIGTLPackedMessage::ReadUint64(data.data() + offset
+                                               + mtsIGTLPackedMessage::BODY_SIZE_OFFSET);
+    }
+    return types;
+}
+
+static void SendGet(mtsIGTLConnection * connection, const std::string & deviceType)
+{
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType("GET_" + deviceType);
+    message.SetDeviceName("device");
+    message.AllocateBody(0);
+    message.Pack();
+    connection->Send(static_cast<const unsigned char *>(message.GetPackPointer()),
+                     message.GetPackSize());
+}
+
+int main(void)
+{
+    // cache is filled without clients
+    mtsIGTLCacheTestBridge bridge;
+    bridge.SetCache(true, false);
+    bridge.SendAll();
+
+    mtsIGTLMemoryListener listener;
+    std::unique_ptr<mtsIGTLConnection> client(listener.Connect("client"));
+    bridge.AddClient(listener.Accept());
+
+    // both types are cached for the same device
+    SendGet(client.get(), "STRING");
+    bridge.ReceiveAll();
+    std::vector<std::string> types = ReceiveTypes(client.get());
+    SAW_IGTL_CHECK(types.size() == 1);
+    SAW_IGTL_CHECK(!types.empty() && (types[0] == "STRING"));
+
+    SendGet(client.get(), "SENSOR");
+    bridge.ReceiveAll();
+    types = ReceiveTypes(client.get());
+    SAW_IGTL_CHECK(types.size() == 1);
+    SAW_IGTL_CHECK(!types.empty() && (types[0] == "SENSOR"));
+
+    // empty type returns all
+    SendGet(client.get(), "");
+    bridge.ReceiveAll();
+    types = ReceiveTypes(client.get());
+    SAW_IGTL_CHECK(types.size() == 2);
+
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,77 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+#include <cisstOSAbstraction/osaSleep.h>
+
+#include <vector>
+
+#include "sawOpenIGTLinkTests.h"
+
+// slow connection, records which client sent each chunk
+class mtsIGTLChunkTestConnection: public mtsIGTLConnection
+{
+public:
+    mtsIGTLChunkTestConnection(const std::string & name, std::vector<std::string> & sent):
+        mtsIGTLConnection(name),
+        mSent(sent) {}
+
+    long long Receive(unsigned char *, const size_t) override {
+        return 0;
+    }
+
+    long long Send(const unsigned char *, const size_t size) override {
+        osaSleep(0.002);
+        mSent.push_back(mName);
+        return static_cast<long long>(size);
+    }
+
+protected:
+    std::vector<std::string> & mSent;
+};
+
+int main(void)
+{
+    std::vector<std::string> sent;
+    mtsIGTLBridge bridge("bridge", 1.0);
+    bridge.AddClient(new mtsIGTLChunkTestConnection("a", sent));
+    bridge.AddClient(new mtsIGTLChunkTestConnection("b", sent));
+
+    // time slice shorter than a chunk, one chunk per call
+    bridge.SetSendChunking(1000, 0.001, 1000000);
+    std::vector<unsigned char> data(10000, 0);
+    bridge.SendBytes(data.data(), data.size(), "large");
+    SAW_IGTL_CHECK(sent.size() == 2);
+
+    // clients take turns across calls
+    sent.clear();
+    size_t calls = 0;
+    while (bridge.SendQueued() && (calls < 100)) {
+        ++calls;
+    }
+    SAW_IGTL_CHECK(sent.size() == 18);
+    size_t count = 0;
+    for (size_t index = 1; index < sent.size(); ++index) {
+        if (sent[index] != sent[index - 1]) {
+            ++count;
+        }
+    }
+    SAW_IGTL_CHECK(count == sent.size() - 1);
+
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,143 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sawOpenIGTLinkTests.h"
+
+class mtsIGTLClientProfileTestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLClientProfileTestBridge(void):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mSocketTimeout = 1;
+    }
+
+    void SendDevice(const std::string & deviceName) {
+        mtsIGTLPackedMessage message;
+        message.SetDeviceType("STRING");
+        message.SetDeviceName(deviceName);
+        memset(message.AllocateBody(4), 0, 4);
+        message.Pack();
+        SendBytes(static_cast<const unsigned char *>(message.GetPackPointer()),
+                  message.GetPackSize(), deviceName);
+    }
+};
+
+// device names of all messages received so far
+static std::vector<std::string> Received(mtsIGTLConnection * connection)
+{
+    std::vector<unsigned char> data(4096);
+    long long size = connection->Receive(data.data(), data.size());
+    data.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    std::vector<std::string> devices;
+    size_t offset = 0;
+    while (offset + mtsIGTLPackedMessage::HEADER_SIZE <= data.size()) {
+        const char * name = reinterpret_cast<const char *>(data.data() + offset + 14);
+        devices.push_back(std::string(name, strnlen(name, 20)));
+        unsigned long long bodySize = 0;
+        for (size_t byte = 0; byte < 8; ++byte) {
+            bodySize = (bodySize << 8)
+                | data[offset + mtsIGTLPackedMessage::BODY_SIZE_OFFSET + byte];
+        }
+        offset += mtsIGTLPackedMessage::HEADER_SIZE + bodySize;
+    }
+    return devices;
+}
+
+static std::vector<std::string> Devices(const char * first, const char * second = nullptr)
+{
+    std::vector<std::string> devices(1, first);
+    if (second) {
+        devices.push_back(second);
+    }
+    return devices;
+}
+
+int main(void)
+{
+    // glob patterns
+    SAW_IGTL_CHECK(mtsIGTLBridge::MatchPattern("*", ""));
+    SAW_IGTL_CHECK(mtsIGTLBridge::MatchPattern("PSM*", "PSM1"));
+    SAW_IGTL_CHECK(mtsIGTLBridge::MatchPattern("PSM?/measured_cp", "PSM2/measured_cp"));
+    SAW_IGTL_CHECK(mtsIGTLBridge::MatchPattern("*_cp", "PSM1/measured_cp"));
+    SAW_IGTL_CHECK(mtsIGTLBridge::MatchPattern("a*b*c", "aXbYbZc"));
+    SAW_IGTL_CHECK(!mtsIGTLBridge::MatchPattern("PSM?", "PSM"));
+    SAW_IGTL_CHECK(!mtsIGTLBridge::MatchPattern("PSM*", "ECM"));
+    SAW_IGTL_CHECK(!mtsIGTLBridge::MatchPattern("", "a"));
+
+    mtsIGTLClientProfileTestBridge bridge;
+    bridge.AddClientProfile("tool", "memory:tool*", std::list<std::string>(1, "pose*"));
+    bridge.AddClientProfile("display", "", std::list<std::string>(1, "status"));
+    mtsIGTLMemoryListener listener;
+
+    // profile selected by address when the client connects
+    std::unique_ptr<mtsIGTLConnection> tool(listener.Connect("tool1"));
+    bridge.AddClient(listener.Accept());
+    // no profile, all devices
+    std::unique_ptr<mtsIGTLConnection> viewer(listener.Connect("viewer"));
+    bridge.AddClient(listener.Accept());
+    // profile selected by name, encoding (16 bits), length (16 bits), string
+    std::unique_ptr<mtsIGTLConnection> display(listener.Connect("display"));
+    bridge.AddClient(listener.Accept());
+    const std::string profile = "display";
+    mtsIGTLPackedMessage select;
+    select.SetDeviceType("STRING");
+    select.SetDeviceName("CLIENT");
+    unsigned char * body = select.AllocateBody(4 + profile.size());
+    body[0] = 0;
+    body[1] = 3;
+    body[2] = 0;
+    body[3] = static_cast<unsigned char>(profile.size());
+    memcpy(body + 4, profile.data(), profile.size());
+    select.Pack();
+    display->Send(static_cast<const unsigned char *>(select.GetPackPointer()), select.GetPackSize());
+    bridge.ReceiveAll();
+
+    bridge.SendDevice("pose1");
+    bridge.SendDevice("status");
+    bridge.SendDevice("other");
+    SAW_IGTL_CHECK(Received(tool.get()) == Devices("pose1"));
+    SAW_IGTL_CHECK(Received(display.get()) == Devices("status"));
+    std::vector<std::string> all = Devices("pose1", "status");
+    all.push_back("other");
+    SAW_IGTL_CHECK(Received(viewer.get()) == all);
+
+    // unknown profile is ignored, client keeps its profile
+    const std::string unknown = "nothing";
+    body = select.AllocateBody(4 + unknown.size());
+    body[0] = 0;
+    body[1] = 3;
+    body[2] = 0;
+    body[3] = static_cast<unsigned char>(unknown.size());
+    memcpy(body + 4, unknown.data(), unknown.size());
+    select.Pack();
+    tool->Send(static_cast<const unsigned char *>(select.GetPackPointer()), select.GetPackSize());
+    bridge.ReceiveAll();
+    bridge.SendDevice("pose2");
+    bridge.SendDevice("status");
+    SAW_IGTL_CHECK(Received(tool.get()) == Devices("pose2"));
+
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,187 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLTransport.h>
+#include <cisstOSAbstraction/osaGetTime.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "sawOpenIGTLinkTests.h"
+
+class mtsIGTLConnectorTestConnector: public mtsIGTLTCPConnector
+{
+public:
+    size_t Attempts(void) const {
+        return mAttempts;
+    }
+    bool InProgress(void) const {
+        return (mDescriptor >= 0);
+    }
+};
+
+// stand-in server on the loopback interface, port 0 picks a free port
+static int Listen(int & port, const int backlog)
+{
+    const int descriptor = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<unsigned short>(port));
+    if ((bind(descriptor, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0)
+        || (listen(descriptor, backlog) != 0)) {
+        close(descriptor);
+        return -1;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(descriptor, reinterpret_cast<struct sockaddr *>(&address), &length);
+    port = ntohs(address.sin_port);
+    return descriptor;
+}
+
+static mtsIGTLConnection * WaitForConnection(mtsIGTLTCPConnector & connector)
+{
+    const double start = osaGetTime();
+    while ((osaGetTime() - start) < 5.0) {
+        mtsIGTLConnection * connection = connector.Accept();
+        if (connection) {
+            return connection;
+        }
+        usleep(1000);
+    }
+    return nullptr;
+}
+
+int main(void)
+{
+    // addresses
+    std::string host;
+    int port = 0;
+    SAW_IGTL_CHECK(mtsIGTLTCPConnector::ParseAddress("localhost:18944", host, port)
+                   && (host == "localhost") && (port == 18944));
+    SAW_IGTL_CHECK(mtsIGTLTCPConnector::ParseAddress("[::1]:18945", host, port)
+                   && (host == "::1") && (port == 18945));
+    SAW_IGTL_CHECK(!mtsIGTLTCPConnector::ParseAddress("::1:18944", host, port));
+    SAW_IGTL_CHECK(!mtsIGTLTCPConnector::ParseAddress("[::1]18944", host, port));
+    SAW_IGTL_CHECK(!mtsIGTLTCPConnector::ParseAddress("localhost", host, port));
+    SAW_IGTL_CHECK(!mtsIGTLTCPConnector::ParseAddress("localhost:", host, port));
+    SAW_IGTL_CHECK(!mtsIGTLTCPConnector::ParseAddress("localhost:port", host, port));
+    SAW_IGTL_CHECK(!mtsIGTLTCPConnector::ParseAddress("localhost:70000", host, port));
+    SAW_IGTL_CHECK(!mtsIGTLTCPConnector::ParseAddress(":18944", host, port));
+
+    // free port, nothing listening yet
+    port = 0;
+    int server = Listen(port, 1);
+    SAW_IGTL_CHECK(server >= 0);
+    close(server);
+
+    mtsIGTLConnectorTestConnector connector;
+    connector.SetBackoff(0.01, 0.02);
+    SAW_IGTL_CHECK(connector.Create("127.0.0.1", port));
+
+    // refused attempts are abandoned and retried after the backoff
+    const double start = osaGetTime();
+    while ((connector.Attempts() < 3) && ((osaGetTime() - start) < 5.0)) {
+        SAW_IGTL_CHECK(connector.Accept() == nullptr);
+        usleep(5000);
+    }
+    SAW_IGTL_CHECK(connector.Attempts() >= 3);
+
+    // connected once the server starts, data in both directions
+    server = Listen(port, 1);
+    SAW_IGTL_CHECK(server >= 0);
+    std::unique_ptr<mtsIGTLConnection> connection(WaitForConnection(connector));
+    SAW_IGTL_CHECK(connection != nullptr);
+    if (!connection) {
+        return SAW_IGTL_TEST_RESULT();
+    }
+    const int peer = accept(server, nullptr, nullptr);
+    SAW_IGTL_CHECK(peer >= 0);
+    const unsigned char data[4] = {1, 2, 3, 4};
+    SAW_IGTL_CHECK(connection->Send(data, 4) == 4);
+    unsigned char buffer[4] = {0, 0, 0, 0};
+    SAW_IGTL_CHECK(recv(peer, buffer, 4, MSG_WAITALL) == 4);
+    SAW_IGTL_CHECK(memcmp(buffer, data, 4) == 0);
+    SAW_IGTL_CHECK(send(peer, data, 4, 0) == 4);
+    long long received = 0;
+    while (received == 0) {
+        received = connection->Receive(buffer, 4);
+    }
+    SAW_IGTL_CHECK(received == 4);
+
+    // no new connection until the bridge closes this one
+    SAW_IGTL_CHECK(connector.Accept() == nullptr);
+    close(peer);
+    while (connection->Receive(buffer, 4) >= 0) {
+        usleep(1000);
+    }
+    connection.reset();
+    connection.reset(WaitForConnection(connector));
+    SAW_IGTL_CHECK(connection != nullptr);
+    connection.reset();
+    close(server);
+
+    // server not answering, the attempt is abandoned after the timeout
+    int silentPort = 0;
+    const int silent = Listen(silentPort, 0);
+    SAW_IGTL_CHECK(silent >= 0);
+    // fill the accept queue, later SYN are dropped by the kernel
+    std::vector<int> fillers;
+    for (size_t index = 0; index < 4; ++index) {
+        const int filler = socket(AF_INET, SOCK_STREAM, 0);
+        fcntl(filler, F_SETFL, O_NONBLOCK);
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<unsigned short>(silentPort));
+        connect(filler, reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+        fillers.push_back(filler);
+    }
+    usleep(10000);
+    mtsIGTLConnectorTestConnector timeout;
+    timeout.SetBackoff(0.01, 0.01);
+    timeout.SetConnectTimeout(0.05);
+    SAW_IGTL_CHECK(timeout.Create("127.0.0.1", silentPort));
+    SAW_IGTL_CHECK(timeout.Accept() == nullptr);
+    SAW_IGTL_CHECK(timeout.InProgress());
+    const double timeoutStart = osaGetTime();
+    while ((timeout.Attempts() == 0) && ((osaGetTime() - timeoutStart) < 2.0)) {
+        SAW_IGTL_CHECK(timeout.Accept() == nullptr);
+        usleep(1000);
+    }
+    // the kernel would keep trying much longer than the loop deadline
+    SAW_IGTL_CHECK(timeout.Attempts() == 1);
+    SAW_IGTL_CHECK(!timeout.InProgress());
+    for (auto filler : fillers) {
+        close(filler);
+    }
+    close(silent);
+
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,179 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsCISSTToIGTL.h>
+#include <sawOpenIGTLink/mtsIGTLToCISST.h>
+
+#include "sawOpenIGTLinkTests.h"
+
+// float32 and float64 NDARRAY encodings for joint states
+
+static void TestEncodingFromString(void)
+{
+    mtsIGTLEncoding encoding = MTS_IGTL_FLOAT64;
+    SAW_IGTL_CHECK(mtsIGTLEncodingFromString("float32", encoding));
+    SAW_IGTL_CHECK(encoding == MTS_IGTL_FLOAT32);
+    SAW_IGTL_CHECK(mtsIGTLEncodingFromString("float64", encoding));
+    SAW_IGTL_CHECK(encoding == MTS_IGTL_FLOAT64);
+    // unknown names leave the encoding unchanged
+    SAW_IGTL_CHECK(!mtsIGTLEncodingFromString("double", encoding));
+    SAW_IGTL_CHECK(encoding == MTS_IGTL_FLOAT64);
+}
+
+static void TestStateJoint(const mtsIGTLEncoding encoding)
+{
+    const bool float32 = (encoding == MTS_IGTL_FLOAT32);
+    const size_t elementSize = float32 ? 4 : 8;
+    prmStateJoint state;
+    state.Name().resize(2);
+    state.Position().SetSize(2);
+    state.Position().Element(0) = 0.5;
+    state.Position().Element(1) = -1.25;
+    // velocity is empty, effort has the wrong size
+    state.Effort().SetSize(1);
+    state.SetValid(true);
+
+    mtsIGTLPackedMessage message;
+    message.SetDeviceName("measured_js");
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(state, message, encoding));
+    SAW_IGTL_CHECK(message.GetDeviceType() == "NDARRAY");
+    // type, dimension, 2 sizes and 6 rows of 2 joints
+    SAW_IGTL_CHECK(message.GetPackBodySize() == 6 + 6 * 2 * elementSize);
+
+    const unsigned char * body = message.GetPackBodyPointer();
+    SAW_IGTL_CHECK(body[0] == (float32 ? 10 : 11));
+    SAW_IGTL_CHECK(body[1] == 2);
+    SAW_IGTL_CHECK(((body[2] << 8) | body[3]) == 6);
+    SAW_IGTL_CHECK(((body[4] << 8) | body[5]) == 2);
+
+    // rows are flag and values for position, velocity and effort
+    const double expected[6][2] = {{1.0, 1.0}, {0.5, -1.25},
+                                   {0.0, 0.0}, {0.0, 0.0},
+                                   {0.0, 0.0}, {0.0, 0.0}};
+    const unsigned char * element = body + 6;
+    for (size_t row = 0; row < 6; ++row) {
+        for (size_t col = 0; col < 2; ++col, element += elementSize) {
+            double value;
+            if (float32) {
+                value = mtsIGTLPackedMessage::ReadFloat32(element);
+            } else {
+                const unsigned long long raw = mtsIGTLPackedMessage::ReadUint64(element);
+                memcpy(&value, &raw, 8);
+            }
+            SAW_IGTL_CHECK(value == expected[row][col]);
+        }
+    }
+}
+
+// joint states sent with either encoding are read back by the bridge
+static void TestStateJointRoundTrip(const mtsIGTLEncoding encoding)
+{
+    prmStateJoint state;
+    state.Name().resize(3);
+    state.Position().SetSize(3);
+    state.Position().Element(0) = 0.5;
+    state.Position().Element(1) = -1.25;
+    state.Position().Element(2) = 2.0;
+    state.Velocity().SetSize(3);
+    state.Velocity().Element(0) = 0.1;
+    state.Velocity().Element(1) = 0.2;
+    state.Velocity().Element(2) = -0.3;
+    state.SetValid(true);
+
+    igtl::NDArrayMessage::Pointer message = igtl::NDArrayMessage::New();
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(state, message, encoding));
+    SAW_IGTL_CHECK(message->GetType() == ((encoding == MTS_IGTL_FLOAT32)
+                                          ? igtl::NDArrayMessage::TYPE_FLOAT32
+                                          : igtl::NDArrayMessage::TYPE_FLOAT64));
+
+    prmStateJoint received;
+    SAW_IGTL_CHECK(mtsIGTLToCISST(message, received));
+    SAW_IGTL_CHECK(received.Valid());
+    SAW_IGTL_CHECK(received.Position().size() == 3);
+    SAW_IGTL_CHECK(received.Velocity().size() == 3);
+    SAW_IGTL_CHECK(received.Effort().size() == 0);
+    if ((received.Position().size() == 3) && (received.Velocity().size() == 3)) {
+        for (size_t joint = 0; joint < 3; ++joint) {
+            SAW_IGTL_CHECK(received.Position().Element(joint) == state.Position().Element(joint));
+            SAW_IGTL_CHECK_CLOSE(received.Velocity().Element(joint),
+                                 state.Velocity().Element(joint), 1e-6);
+        }
+    }
+
+    // invalid states are not sent
+    state.SetValid(false);
+    SAW_IGTL_CHECK(!mtsCISSTToIGTL(state, message, encoding));
+}
+
+// float32 NDARRAY from clients, e.g. Python or Unity
+static void TestFloat32Commands(void)
+{
+    const igtl_float32 values[3] = {0.5f, -1.25f, 2.0f};
+    igtl::Array<igtl_float32> * array = new igtl::Array<igtl_float32>;
+    igtl::ArrayBase::IndexType size(1, 3);
+    array->SetSize(size);
+    memcpy(array->GetRawArray(), values, sizeof(values));
+    igtl::NDArrayMessage::Pointer message = igtl::NDArrayMessage::New();
+    message->SetArray(igtl::NDArrayMessage::TYPE_FLOAT32, array);
+
+    prmPositionJointSet goal;
+    SAW_IGTL_CHECK(mtsIGTLToCISST(message, goal));
+    SAW_IGTL_CHECK(goal.Goal().size() == 3);
+    if (goal.Goal().size() == 3) {
+        for (size_t joint = 0; joint < 3; ++joint) {
+            SAW_IGTL_CHECK(goal.Goal().Element(joint) == values[joint]);
+        }
+    }
+
+    // joint states need 6 rows
+    prmStateJoint state;
+    SAW_IGTL_CHECK(!mtsIGTLToCISST(message, state));
+
+    // rows are flag and values for position, velocity and effort
+    const igtl_float32 rows[6][2] = {{1.0f, 1.0f}, {0.5f, -1.25f},
+                                     {0.0f, 0.0f}, {0.0f, 0.0f},
+                                     {1.0f, 1.0f}, {2.0f, -4.0f}};
+    igtl::Array<igtl_float32> * stateArray = new igtl::Array<igtl_float32>;
+    igtl::ArrayBase::IndexType stateSize(2);
+    stateSize[0] = 6;
+    stateSize[1] = 2;
+    stateArray->SetSize(stateSize);
+    memcpy(stateArray->GetRawArray(), rows, sizeof(rows));
+    igtl::NDArrayMessage::Pointer stateMessage = igtl::NDArrayMessage::New();
+    stateMessage->SetArray(igtl::NDArrayMessage::TYPE_FLOAT32, stateArray);
+    SAW_IGTL_CHECK(mtsIGTLToCISST(stateMessage, state));
+    SAW_IGTL_CHECK(state.Position().size() == 2);
+    SAW_IGTL_CHECK(state.Velocity().size() == 0);
+    SAW_IGTL_CHECK(state.Effort().size() == 2);
+    if ((state.Position().size() == 2) && (state.Effort().size() == 2)) {
+        SAW_IGTL_CHECK(state.Position().Element(1) == -1.25);
+        SAW_IGTL_CHECK(state.Effort().Element(0) == 2.0);
+        SAW_IGTL_CHECK(state.Effort().Element(1) == -4.0);
+    }
+}
+
+int main(void)
+{
+    TestEncodingFromString();
+    TestStateJoint(MTS_IGTL_FLOAT64);
+    TestStateJoint(MTS_IGTL_FLOAT32);
+    TestStateJointRoundTrip(MTS_IGTL_FLOAT64);
+    TestStateJointRoundTrip(MTS_IGTL_FLOAT32);
+    TestFloat32Commands();
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,133 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+#include <sawOpenIGTLink/mtsIGTLReceiveBuffer.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "sawOpenIGTLinkTests.h"
+
+static const size_t BodySize = 8;
+
+// records the device of each message received
+class mtsIGTLFairnessTestReceiver: public mtsIGTLReceiverBase
+{
+public:
+    mtsIGTLFairnessTestReceiver(const std::string & name, mtsIGTLBridge * bridge,
+                                std::vector<std::string> & received):
+        mtsIGTLReceiverBase(name, bridge),
+        mReceived(received) {}
+
+    bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase *,
+                 const bool) override {
+        buffer.Skip(BodySize);
+        mReceived.push_back(mName);
+        return true;
+    }
+
+    bool ExecutePending(void) override {
+        return false;
+    }
+
+protected:
+    std::vector<std::string> & mReceived;
+};
+
+class mtsIGTLFairnessTestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLFairnessTestBridge(std::vector<std::string> & received):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mReceivers["a"] = new mtsIGTLFairnessTestReceiver("a", this, received);
+        mReceivers["b"] = new mtsIGTLFairnessTestReceiver("b", this, received);
+    }
+};
+
+static void SendMessages(mtsIGTLConnection * client, const std::string & deviceName,
+                         const size_t nbMessages)
+{
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType("STRING");
+    message.SetDeviceName(deviceName);
+    memset(message.AllocateBody(BodySize), 0, BodySize);
+    message.Pack();
+    for (size_t index = 0; index < nbMessages; ++index) {
+        client->Send(static_cast<const unsigned char *>(message.GetPackPointer()),
+                     message.GetPackSize());
+    }
+}
+
+static size_t Count(const std::vector<std::string> & received, const std::string & name)
+{
+    return std::count(received.begin(), received.end(), name);
+}
+
+int main(void)
+{
+    std::vector<std::string> received;
+    mtsIGTLFairnessTestBridge bridge(received);
+    mtsIGTLMemoryListener listener;
+    std::unique_ptr<mtsIGTLConnection> flooding(listener.Connect("flooding"));
+    std::unique_ptr<mtsIGTLConnection> console(listener.Connect("console"));
+    bridge.AddClient(listener.Accept());
+    bridge.AddClient(listener.Accept());
+
+    // without budget, the flooding client doesn't get drained first
+    SendMessages(flooding.get(), "a", 100);
+    SendMessages(console.get(), "b", 2);
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(Count(received, "b") == 2);
+    SAW_IGTL_CHECK(Count(received, "a") < 100);
+    SAW_IGTL_CHECK(Count(received, "a") > 0);
+
+    // remaining messages on following passes
+    for (size_t pass = 0; pass < 100; ++pass) {
+        bridge.ReceiveAll();
+    }
+    SAW_IGTL_CHECK(Count(received, "a") == 100);
+
+    // next pass starts with the other client
+    received.clear();
+    SendMessages(flooding.get(), "a", 1);
+    SendMessages(console.get(), "b", 1);
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(received.size() == 2);
+    const std::string first = received[0];
+    received.clear();
+    SendMessages(flooding.get(), "a", 1);
+    SendMessages(console.get(), "b", 1);
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(received.size() == 2);
+    SAW_IGTL_CHECK(received[0] != first);
+
+    // budget per cycle
+    received.clear();
+    bridge.SetReceiveBudget(5, 0);
+    SendMessages(console.get(), "b", 10);
+    for (size_t pass = 0; pass < 10; ++pass) {
+        bridge.ReceiveAll();
+    }
+    SAW_IGTL_CHECK(Count(received, "b") > 0);
+    SAW_IGTL_CHECK(Count(received, "b") <= 5);
+
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,208 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+#include <sawOpenIGTLink/mtsCISSTToIGTL.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "sawOpenIGTLinkTests.h"
+
+// count all allocations, including the ones made by the library.  A
+// Windows DLL wouldn't use these, this test is only built on POSIX
+// systems.
+static std::atomic<size_t> Allocations(0);
+
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void * operator new(std::size_t size)
+{
+    ++Allocations;
+    void * pointer = std::malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void * pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+// kernel buffer full until unblocked, keeps what was sent
+class mtsIGTLFramePoolTestConnection: public mtsIGTLConnection
+{
+public:
+    mtsIGTLFramePoolTestConnection(const std::string & name, bool & blocked):
+        mtsIGTLConnection(name),
+        mBlocked(blocked) {
+        mSent.reserve(1024 * 1024);
+    }
+
+    int GetDescriptor(void) const override {
+        return -1;
+    }
+
+    long long Receive(unsigned char *, const size_t) override {
+        return 0;
+    }
+
+    long long Send(const unsigned char * data, const size_t size) override {
+        if (mBlocked) {
+            return 0;
+        }
+        if (mSent.size() + size <= mSent.capacity()) {
+            mSent.insert(mSent.end(), data, data + size);
+        }
+        mTotal += size;
+        return static_cast<long long>(size);
+    }
+
+    std::vector<unsigned char> mSent;
+    size_t mTotal = 0;
+
+protected:
+    bool & mBlocked;
+};
+
+class mtsIGTLFramePoolTestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLFramePoolTestBridge(const size_t maxQueueSize):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mServer = false;
+        SetSendChunking(64 * 1024, 0.0, maxQueueSize);
+        Startup();
+    }
+
+    // queued while the connections are blocked, sent once unblocked
+    void Cycle(const unsigned char * data, const size_t size, bool & blocked) {
+        blocked = true;
+        SendBytes(data, size, "a");
+        blocked = false;
+        SendQueued();
+    }
+};
+
+int main(void)
+{
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType("STRING");
+    message.SetDeviceName("a");
+    unsigned char * body = message.AllocateBody(1000);
+    for (size_t index = 0; index < 1000; ++index) {
+        body[index] = static_cast<unsigned char>(index);
+    }
+    message.Pack();
+    const unsigned char * data = static_cast<const unsigned char *>(message.GetPackPointer());
+    const size_t size = message.GetPackSize();
+
+    // frames fully sent go back to the pool and are re-used
+    {
+        bool blocked = false;
+        mtsIGTLFramePoolTestBridge bridge(10 * size);
+        mtsIGTLFramePoolTestConnection * connection
+            = new mtsIGTLFramePoolTestConnection("pooled", blocked);
+        bridge.AddClient(connection);
+        bridge.Cycle(data, size, blocked);
+        bridge.Cycle(data, size, blocked);
+        const size_t allocations = Allocations;
+        for (size_t cycle = 0; cycle < 100; ++cycle) {
+            bridge.Cycle(data, size, blocked);
+        }
+        SAW_IGTL_CHECK(Allocations == allocations);
+        SAW_IGTL_CHECK(connection->mTotal == 102 * size);
+        SAW_IGTL_CHECK(memcmp(connection->mSent.data() + 101 * size, data, size) == 0);
+        bridge.Cleanup();
+    }
+
+    // pool is bounded by the maximum queue size, frames past it are freed
+    {
+        bool blocked = false;
+        mtsIGTLFramePoolTestBridge bridge(size);
+        bridge.AddClient(new mtsIGTLFramePoolTestConnection("first", blocked));
+        bridge.AddClient(new mtsIGTLFramePoolTestConnection("second", blocked));
+        bridge.Cycle(data, size, blocked);
+        bridge.Cycle(data, size, blocked);
+        const size_t allocations = Allocations;
+        bridge.Cycle(data, size, blocked);
+        SAW_IGTL_CHECK(Allocations > allocations);
+        bridge.Cleanup();
+    }
+
+    // queued state is replaced by the latest, events are all sent in order
+    {
+        bool blocked = true;
+        mtsIGTLFramePoolTestBridge bridge(100 * size);
+        mtsIGTLFramePoolTestConnection * connection
+            = new mtsIGTLFramePoolTestConnection("queued", blocked);
+        bridge.AddClient(connection);
+        mtsIGTLPackedMessage queued;
+        queued.SetDeviceName("a");
+        std::vector<unsigned char> expected;
+        for (const std::string type : {"STRING", "SENSOR"}) {
+            queued.SetDeviceType(type);
+            for (unsigned char index = 0; index < 3; ++index) {
+                memset(queued.AllocateBody(10), index, 10);
+                queued.Pack();
+                const unsigned char * queuedData
+                    = static_cast<const unsigned char *>(queued.GetPackPointer());
+                bridge.SendBytes(queuedData, queued.GetPackSize(), "a", true);
+                if ((type == "STRING") || (index == 2)) {
+                    expected.insert(expected.end(), queuedData, queuedData + queued.GetPackSize());
+                }
+            }
+        }
+        blocked = false;
+        bridge.SendQueued();
+        SAW_IGTL_CHECK(connection->mSent == expected);
+        bridge.Cleanup();
+    }
+
+    // re-used POINT message keeps a single element
+    igtl::PointMessage::Pointer point = igtl::PointMessage::New();
+    vct3 position;
+    position.Assign(1.0, 2.0, 3.0);
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(position, point));
+    igtl::PointElement::Pointer first;
+    point->GetPointElement(0, first);
+    position.Assign(4.0, 5.0, 6.0);
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(position, point));
+    SAW_IGTL_CHECK(point->GetNumberOfPointElement() == 1);
+    igtl::PointElement::Pointer element;
+    point->GetPointElement(0, element);
+    SAW_IGTL_CHECK(element.GetPointer() == first.GetPointer());
+    igtlFloat32 sent[3];
+    element->GetPosition(sent);
+    SAW_IGTL_CHECK(sent[0] == 4.0f);
+
+    return SAW_IGTL_TEST_RESULT();
+}
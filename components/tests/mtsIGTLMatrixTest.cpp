@@ -0,0 +1,93 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsCISSTToIGTL.h>
+
+#include "sawOpenIGTLinkTests.h"
+
+// matrices (e.g. CRTK jacobian) packed as 2D NDARRAY, row major
+
+static void TestMatrix(const bool rowMajor, const mtsIGTLEncoding encoding)
+{
+    const bool float32 = (encoding == MTS_IGTL_FLOAT32);
+    const size_t elementSize = float32 ? 4 : 8;
+    vctDoubleMat matrix(2, 3, rowMajor ? VCT_ROW_MAJOR : VCT_COL_MAJOR);
+    for (size_t row = 0; row < 2; ++row) {
+        for (size_t col = 0; col < 3; ++col) {
+            matrix.Element(row, col) = 10.0 * row + col + 0.5;
+        }
+    }
+
+    mtsIGTLPackedMessage message;
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(matrix, message, encoding));
+    SAW_IGTL_CHECK(message.GetDeviceType() == "NDARRAY");
+    SAW_IGTL_CHECK(message.GetPackBodySize() == 6 + 6 * elementSize);
+
+    const unsigned char * body = message.GetPackBodyPointer();
+    SAW_IGTL_CHECK(body[0] == (float32 ? 10 : 11));
+    SAW_IGTL_CHECK(body[1] == 2);
+    SAW_IGTL_CHECK(((body[2] << 8) | body[3]) == 2);
+    SAW_IGTL_CHECK(((body[4] << 8) | body[5]) == 3);
+    // row major regardless of the matrix storage order
+    const unsigned char * element = body + 6;
+    for (size_t row = 0; row < 2; ++row) {
+        for (size_t col = 0; col < 3; ++col, element += elementSize) {
+            double value;
+            if (float32) {
+                value = mtsIGTLPackedMessage::ReadFloat32(element);
+            } else {
+                const unsigned long long raw = mtsIGTLPackedMessage::ReadUint64(element);
+                memcpy(&value, &raw, 8);
+            }
+            SAW_IGTL_CHECK(value == matrix.Element(row, col));
+        }
+    }
+}
+
+// first rows of a larger matrix, e.g. block of state table samples
+static void TestRows(void)
+{
+    vctDoubleMat block(4, 3);
+    vctDoubleMat rows(2, 3);
+    for (size_t row = 0; row < 4; ++row) {
+        for (size_t col = 0; col < 3; ++col) {
+            block.Element(row, col) = 10.0 * row + col + 0.5;
+            if (row < 2) {
+                rows.Element(row, col) = block.Element(row, col);
+            }
+        }
+    }
+    mtsIGTLPackedMessage expected;
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(rows, expected, MTS_IGTL_FLOAT64));
+    mtsIGTLPackedMessage message;
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(vctDynamicConstMatrixRef<double>(block, 0, 0, 2, 3),
+                                  message, MTS_IGTL_FLOAT64));
+    SAW_IGTL_CHECK(message.GetPackBodySize() == expected.GetPackBodySize());
+    SAW_IGTL_CHECK(memcmp(message.GetPackBodyPointer(), expected.GetPackBodyPointer(),
+                          expected.GetPackBodySize()) == 0);
+}
+
+int main(void)
+{
+    TestMatrix(true, MTS_IGTL_FLOAT64);
+    TestMatrix(true, MTS_IGTL_FLOAT32);
+    TestMatrix(false, MTS_IGTL_FLOAT64);
+    TestMatrix(false, MTS_IGTL_FLOAT32);
+    TestRows();
+    return SAW_IGTL_TEST_RESULT();
+}
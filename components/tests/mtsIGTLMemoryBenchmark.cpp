@@ -0,0 +1,107 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// Throughput of the full bridge receive path using the memory
+// transport, no kernel involved, not run by ctest:
+// mtsIGTLMemoryBenchmark [number of messages]
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+#include <sawOpenIGTLink/mtsIGTLReceiveBuffer.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+static const size_t BodySize = 8;
+
+class mtsIGTLMemoryBenchmarkReceiver: public mtsIGTLReceiverBase
+{
+public:
+    mtsIGTLMemoryBenchmarkReceiver(mtsIGTLBridge * bridge, size_t & received):
+        mtsIGTLReceiverBase("a", bridge),
+        mReceived(received) {}
+
+    bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase *,
+                 const bool) override {
+        buffer.Skip(BodySize);
+        ++mReceived;
+        return true;
+    }
+
+    bool ExecutePending(void) override {
+        return false;
+    }
+
+protected:
+    size_t & mReceived;
+};
+
+class mtsIGTLMemoryBenchmarkBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLMemoryBenchmarkBridge(size_t & received):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mSocketTimeout = 50;
+        mReceivers["a"] = new mtsIGTLMemoryBenchmarkReceiver(this, received);
+    }
+};
+
+int main(int argc, char * argv[])
+{
+    const size_t batchSize = 100;
+    const size_t nbBatches = ((argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000) / batchSize;
+
+    size_t received = 0;
+    mtsIGTLMemoryBenchmarkBridge bridge(received);
+    bridge.SetReceiveBudget(0, 0);
+    mtsIGTLMemoryListener listener;
+    std::unique_ptr<mtsIGTLConnection> client(listener.Connect("client"));
+    bridge.AddClient(listener.Accept());
+
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType("STRING");
+    message.SetDeviceName("a");
+    memset(message.AllocateBody(BodySize), 0, BodySize);
+    message.Pack();
+    const unsigned char * data = static_cast<const unsigned char *>(message.GetPackPointer());
+    const size_t size = message.GetPackSize();
+    std::vector<unsigned char> batch;
+    for (size_t index = 0; index < batchSize; ++index) {
+        batch.insert(batch.end(), data, data + size);
+    }
+
+    const double start = osaGetTime();
+    for (size_t index = 0; index < nbBatches; ++index) {
+        if (client->Send(batch.data(), batch.size()) != static_cast<long long>(batch.size())) {
+            std::cerr << "failed to send batch " << index << std::endl;
+            return 1;
+        }
+        while (received < (index + 1) * batchSize) {
+            bridge.ReceiveAll();
+        }
+    }
+    const double duration = osaGetTime() - start;
+    std::cout << "memory transport: " << received << " messages, "
+              << static_cast<size_t>(received / duration)
+              << " messages/s received" << std::endl;
+    return 0;
+}
@@ -0,0 +1,149 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+#include <sawOpenIGTLink/mtsIGTLReceiveBuffer.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "sawOpenIGTLinkTests.h"
+
+static const size_t BodySize = 8;
+
+class mtsIGTLMemoryTestReceiver: public mtsIGTLReceiverBase
+{
+public:
+    mtsIGTLMemoryTestReceiver(mtsIGTLBridge * bridge, size_t & received):
+        mtsIGTLReceiverBase("a", bridge),
+        mReceived(received) {}
+
+    bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase *,
+                 const bool) override {
+        buffer.Skip(BodySize);
+        ++mReceived;
+        return true;
+    }
+
+    bool ExecutePending(void) override {
+        return false;
+    }
+
+protected:
+    size_t & mReceived;
+};
+
+class mtsIGTLMemoryTestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLMemoryTestBridge(size_t & received):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mSocketTimeout = 50;
+        mReceivers["a"] = new mtsIGTLMemoryTestReceiver(this, received);
+    }
+};
+
+// receive until the expected number of messages, bounded by a deadline
+static bool WaitForMessages(mtsIGTLBridge & bridge, const size_t & received,
+                            const size_t expected)
+{
+    const double start = osaGetTime();
+    while ((received < expected) && ((osaGetTime() - start) < 5.0)) {
+        bridge.ReceiveAll();
+    }
+    return (received == expected);
+}
+
+int main(void)
+{
+    // data in both directions, limited by capacity
+    {
+        mtsIGTLMemoryListener listener(10);
+        std::unique_ptr<mtsIGTLConnection> client(listener.Connect("client"));
+        std::unique_ptr<mtsIGTLConnection> server(listener.Accept());
+        SAW_IGTL_CHECK(server && (listener.Accept() == nullptr));
+        const unsigned char data[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+        unsigned char buffer[16];
+        SAW_IGTL_CHECK(client->Send(data, 16) == 10);
+        SAW_IGTL_CHECK(client->Send(data, 16) == 0);
+        SAW_IGTL_CHECK(server->Receive(buffer, 16) == 10);
+        SAW_IGTL_CHECK(memcmp(buffer, data, 10) == 0);
+        SAW_IGTL_CHECK(server->Receive(buffer, 16) == 0);
+        SAW_IGTL_CHECK(server->Send(data, 4) == 4);
+        SAW_IGTL_CHECK(client->Receive(buffer, 16) == 4);
+        server.reset();
+        SAW_IGTL_CHECK(client->Receive(buffer, 16) == -1);
+        SAW_IGTL_CHECK(client->Send(data, 4) == -1);
+    }
+
+    // connections not accepted are deleted with the listener
+    {
+        std::unique_ptr<mtsIGTLConnection> client;
+        {
+            mtsIGTLMemoryListener listener;
+            client.reset(listener.Connect("client"));
+        }
+        const unsigned char data[4] = {0, 0, 0, 0};
+        SAW_IGTL_CHECK(client->Send(data, 4) == -1);
+    }
+
+    size_t received = 0;
+    mtsIGTLMemoryTestBridge bridge(received);
+    mtsIGTLMemoryListener listener;
+    std::unique_ptr<mtsIGTLConnection> client(listener.Connect("client"));
+    bridge.AddClient(listener.Accept());
+
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType("STRING");
+    message.SetDeviceName("a");
+    memset(message.AllocateBody(BodySize), 0, BodySize);
+    message.Pack();
+    const unsigned char * data = static_cast<const unsigned char *>(message.GetPackPointer());
+    const size_t size = message.GetPackSize();
+
+    // no data, nothing received
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(received == 0);
+
+    // woken up by data sent from another thread
+    std::thread sender([&client, data, size] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        client->Send(data, size);
+    });
+    SAW_IGTL_CHECK(WaitForMessages(bridge, received, 1));
+    sender.join();
+
+    // batches of messages through the full receive path, all received
+    std::vector<unsigned char> batch;
+    for (size_t index = 0; index < 100; ++index) {
+        batch.insert(batch.end(), data, data + size);
+    }
+    received = 0;
+    bridge.SetReceiveBudget(0, 0);
+    for (size_t index = 0; index < 10; ++index) {
+        SAW_IGTL_CHECK(client->Send(batch.data(), batch.size())
+                       == static_cast<long long>(batch.size()));
+        SAW_IGTL_CHECK(WaitForMessages(bridge, received, (index + 1) * 100));
+    }
+    SAW_IGTL_CHECK(received == 1000);
+
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,82 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <limits>
+
+#include <sawOpenIGTLink/mtsIGTLPackedMessage.h>
+#include <sawOpenIGTLink/mtsIGTLCRC64.h>
+
+#include "sawOpenIGTLinkTests.h"
+
+// header written by mtsIGTLPackedMessage::Pack
+
+static const size_t TIMESTAMP_OFFSET = 2 + mtsIGTLPackedMessage::TYPE_SIZE + mtsIGTLPackedMessage::NAME_SIZE;
+
+static unsigned long long PackedTimeStamp(const double & time)
+{
+    mtsIGTLPackedMessage message;
+    message.SetTimeStamp(time);
+    message.Pack();
+    return mtsIGTLPackedMessage::ReadUint64(static_cast<unsigned char *>(message.GetPackPointer())
+                                            + TIMESTAMP_OFFSET);
+}
+
+static void TestHeader(void)
+{
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType("NDARRAY");
+    // longer than the 20 characters of the header, truncated
+    message.SetDeviceName("a_device_name_longer_than_20");
+    unsigned char * body = message.AllocateBody(3);
+    body[0] = 1; body[1] = 2; body[2] = 3;
+    message.Pack();
+
+    const unsigned char * header = static_cast<unsigned char *>(message.GetPackPointer());
+    SAW_IGTL_CHECK(message.GetPackSize() == mtsIGTLPackedMessage::HEADER_SIZE + 3);
+    SAW_IGTL_CHECK((header[0] == 0) && (header[1] == 1));
+    SAW_IGTL_CHECK(std::string(reinterpret_cast<const char *>(header + 2)) == "NDARRAY");
+    SAW_IGTL_CHECK(header[2 + 7] == 0);
+    SAW_IGTL_CHECK(std::string(reinterpret_cast<const char *>(header + 14), 20) == "a_device_name_longer");
+    SAW_IGTL_CHECK(mtsIGTLPackedMessage::ReadUint64(header + TIMESTAMP_OFFSET) == 0);
+    SAW_IGTL_CHECK(mtsIGTLPackedMessage::ReadUint64(header + TIMESTAMP_OFFSET + 8) == 3);
+    SAW_IGTL_CHECK(mtsIGTLPackedMessage::ReadUint64(header + mtsIGTLPackedMessage::CRC_OFFSET)
+                   == mtsIGTLCRC64(message.GetPackBodyPointer(), 3));
+}
+
+static void TestTimeStamp(void)
+{
+    const unsigned long long maxUint32 = 0xFFFFFFFFULL;
+    SAW_IGTL_CHECK(PackedTimeStamp(0.0) == 0);
+    SAW_IGTL_CHECK(PackedTimeStamp(-1.0) == 0);
+    SAW_IGTL_CHECK(PackedTimeStamp(1.5) == ((1ULL << 32) | 0x80000000ULL));
+    // fraction rounds up to 2^32, carried into seconds
+    SAW_IGTL_CHECK(PackedTimeStamp(2.0 - std::ldexp(1.0, -40)) == (2ULL << 32));
+    SAW_IGTL_CHECK(PackedTimeStamp(static_cast<double>(maxUint32) + 0.99999999999)
+                   == ((maxUint32 << 32) | maxUint32));
+    // seconds past 32 bits are clamped
+    SAW_IGTL_CHECK(PackedTimeStamp(5.0e9) == ((maxUint32 << 32) | maxUint32));
+    SAW_IGTL_CHECK(PackedTimeStamp(std::numeric_limits<double>::infinity())
+                   == ((maxUint32 << 32) | maxUint32));
+}
+
+int main(void)
+{
+    TestHeader();
+    TestTimeStamp();
+    return SAW_IGTL_TEST_RESULT();
+}
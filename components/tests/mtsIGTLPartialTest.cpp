@@ -0,0 +1,117 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+#include <sawOpenIGTLink/mtsIGTLReceiveBuffer.h>
+
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+#include "sawOpenIGTLinkTests.h"
+
+static const size_t BodySize = 64;
+
+class mtsIGTLPartialTestReceiver: public mtsIGTLReceiverBase
+{
+public:
+    mtsIGTLPartialTestReceiver(mtsIGTLBridge * bridge, size_t & received):
+        mtsIGTLReceiverBase("a", bridge),
+        mReceived(received) {}
+
+    bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase *,
+                 const bool) override {
+        buffer.Skip(BodySize);
+        ++mReceived;
+        return true;
+    }
+
+    bool ExecutePending(void) override {
+        return false;
+    }
+
+protected:
+    size_t & mReceived;
+};
+
+class mtsIGTLPartialTestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLPartialTestBridge(size_t & received):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mSocketTimeout = 50;
+        mReceivers["a"] = new mtsIGTLPartialTestReceiver(this, received);
+    }
+};
+
+static double TimeReceiveAll(mtsIGTLBridge & bridge)
+{
+    const double start = osaGetTime();
+    bridge.ReceiveAll();
+    return osaGetTime() - start;
+}
+
+int main(void)
+{
+    SAW_IGTL_CHECK(mtsIGTLConnection::Selectable(0));
+    SAW_IGTL_CHECK(!mtsIGTLConnection::Selectable(-1));
+    SAW_IGTL_CHECK(!mtsIGTLConnection::Selectable(FD_SETSIZE));
+
+    int descriptors[2];
+    SAW_IGTL_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, descriptors) == 0);
+    size_t received = 0;
+    mtsIGTLPartialTestBridge bridge(received);
+    bridge.AddClient(new mtsIGTLSocketConnection(descriptors[0], "pair"));
+
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType("STRING");
+    message.SetDeviceName("a");
+    memset(message.AllocateBody(BodySize), 0, BodySize);
+    message.Pack();
+    const char * data = static_cast<const char *>(message.GetPackPointer());
+    const size_t size = message.GetPackSize();
+
+    // header and part of the body, next pass waits for more data
+    // instead of spinning
+    SAW_IGTL_CHECK(write(descriptors[1], data, size - 10) == static_cast<ssize_t>(size - 10));
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(received == 0);
+    SAW_IGTL_CHECK(TimeReceiveAll(bridge) > 0.03);
+    SAW_IGTL_CHECK(received == 0);
+
+    // rest of the body
+    SAW_IGTL_CHECK(write(descriptors[1], data + size - 10, 10) == 10);
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(received == 1);
+
+    // complete messages left over the per pass limit, next pass
+    // doesn't wait
+    for (size_t index = 0; index < 40; ++index) {
+        SAW_IGTL_CHECK(write(descriptors[1], data, size) == static_cast<ssize_t>(size));
+    }
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(received < 41);
+    SAW_IGTL_CHECK(TimeReceiveAll(bridge) < 0.03);
+    while (TimeReceiveAll(bridge) < 0.03) {}
+    SAW_IGTL_CHECK(received == 41);
+
+    close(descriptors[1]);
+    return SAW_IGTL_TEST_RESULT();
+}
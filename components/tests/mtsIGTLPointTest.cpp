@@ -0,0 +1,107 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsCISSTToIGTL.h>
+#include <sawOpenIGTLink/mtsIGTLToCISST.h>
+
+#include "sawOpenIGTLinkTests.h"
+
+// packed POINT body: 136 bytes per element, rgba at 96, float32
+// position at 100
+static void TestPackedPoints(void)
+{
+    std::vector<vct3> points(2);
+    points[0].Assign(1.0, 2.0, 3.0);
+    points[1].Assign(-4.0, 5.5, 6.25);
+
+    mtsIGTLPackedMessage message;
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(points, message, MTS_IGTL_FLOAT64));
+    SAW_IGTL_CHECK(message.GetDeviceType() == "POINT");
+    SAW_IGTL_CHECK(message.GetPackBodySize() == 2 * 136);
+
+    unsigned char * body = message.GetPackBodyPointer();
+    for (size_t index = 0; index < 2; ++index) {
+        const unsigned char * element = body + index * 136;
+        SAW_IGTL_CHECK(element[0] == 0);
+        for (size_t byte = 96; byte < 100; ++byte) {
+            SAW_IGTL_CHECK(element[byte] == 0xFF);
+        }
+        for (size_t axis = 0; axis < 3; ++axis) {
+            SAW_IGTL_CHECK(mtsIGTLPackedMessage::ReadFloat32(element + 100 + 4 * axis)
+                           == points[index][axis]);
+        }
+    }
+
+    // same number of points, elements are re-used, only positions change
+    body[0] = 'p';
+    points[1].Assign(7.0, 8.0, 9.0);
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(points, message, MTS_IGTL_FLOAT64));
+    body = message.GetPackBodyPointer();
+    SAW_IGTL_CHECK(body[0] == 'p');
+    SAW_IGTL_CHECK(mtsIGTLPackedMessage::ReadFloat32(body + 136 + 100) == 7.0f);
+
+    // different number of points, elements are re-initialized
+    points.resize(1);
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(points, message, MTS_IGTL_FLOAT64));
+    SAW_IGTL_CHECK(message.GetPackBodySize() == 136);
+    SAW_IGTL_CHECK(message.GetPackBodyPointer()[0] == 0);
+}
+
+// N x 3 matrix, one point per row
+static void TestMatrixPoints(void)
+{
+    vctDoubleMat points(3, 3);
+    for (size_t row = 0; row < 3; ++row) {
+        points.Element(row, 0) = row;
+        points.Element(row, 1) = 10.0 * row;
+        points.Element(row, 2) = -1.0 * row;
+    }
+    igtl::PointMessage::Pointer message = igtl::PointMessage::New();
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(points, message));
+    SAW_IGTL_CHECK(message->GetNumberOfPointElement() == 3);
+    igtl::PointElement::Pointer first;
+    message->GetPointElement(0, first);
+
+    // same size, same elements
+    points.Element(2, 1) = 42.0;
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(points, message));
+    igtl::PointElement::Pointer element;
+    message->GetPointElement(0, element);
+    SAW_IGTL_CHECK(element.GetPointer() == first.GetPointer());
+
+    vctDoubleMat result;
+    SAW_IGTL_CHECK(mtsIGTLToCISST(message, result));
+    SAW_IGTL_CHECK(result.rows() == 3);
+    SAW_IGTL_CHECK(result.cols() == 3);
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t col = 0; col < 3; ++col) {
+            SAW_IGTL_CHECK(result.Element(row, col) == points.Element(row, col));
+        }
+    }
+
+    // not a list of points
+    vctDoubleMat wrong(3, 2);
+    SAW_IGTL_CHECK(!mtsCISSTToIGTL(wrong, message));
+}
+
+int main(void)
+{
+    TestPackedPoints();
+    TestMatrixPoints();
+    return SAW_IGTL_TEST_RESULT();
+}
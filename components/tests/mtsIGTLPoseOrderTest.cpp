@@ -0,0 +1,121 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+#include <sawOpenIGTLink/mtsIGTLPoseBatch.h>
+#include <sawOpenIGTLink/mtsIGTLReceiveBuffer.h>
+
+#include <memory>
+#include <vector>
+
+#include "sawOpenIGTLinkTests.h"
+
+static const size_t CommandSize = 8;
+
+class mtsIGTLPoseOrderTestBridge;
+
+// records the number of poses still waiting for the batch conversion
+class mtsIGTLPoseOrderTestReceiver: public mtsIGTLReceiverBase
+{
+public:
+    mtsIGTLPoseOrderTestReceiver(mtsIGTLPoseOrderTestBridge * bridge,
+                                 std::vector<size_t> & pending);
+
+    bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase *,
+                 const bool) override;
+
+    bool ExecutePending(void) override {
+        return false;
+    }
+
+protected:
+    mtsIGTLPoseOrderTestBridge * mTestBridge;
+    std::vector<size_t> & mPending;
+};
+
+class mtsIGTLPoseOrderTestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLPoseOrderTestBridge(std::vector<size_t> & pending):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mReceivers["pose"] = new mtsIGTLPoseReceiver("pose", this);
+        mReceivers["command"] = new mtsIGTLPoseOrderTestReceiver(this, pending);
+    }
+
+    size_t PendingPoses(void) const {
+        return mPoseReceivers.size();
+    }
+};
+
+mtsIGTLPoseOrderTestReceiver::mtsIGTLPoseOrderTestReceiver(mtsIGTLPoseOrderTestBridge * bridge,
+                                                           std::vector<size_t> & pending):
+    mtsIGTLReceiverBase("command", bridge),
+    mTestBridge(bridge),
+    mPending(pending)
+{
+}
+
+bool mtsIGTLPoseOrderTestReceiver::Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase *,
+                                           const bool)
+{
+    buffer.Skip(CommandSize);
+    mPending.push_back(mTestBridge->PendingPoses());
+    return true;
+}
+
+static void Send(mtsIGTLConnection * client, const char * type, const char * name,
+                 const size_t bodySize)
+{
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType(type);
+    message.SetDeviceName(name);
+    memset(message.AllocateBody(bodySize), 0, bodySize);
+    message.Pack();
+    client->Send(static_cast<const unsigned char *>(message.GetPackPointer()),
+                 message.GetPackSize());
+}
+
+int main(void)
+{
+    std::vector<size_t> pending;
+    mtsIGTLPoseOrderTestBridge bridge(pending);
+    mtsIGTLMemoryListener listener;
+    std::unique_ptr<mtsIGTLConnection> client(listener.Connect("client"));
+    bridge.AddClient(listener.Accept());
+
+    // poses received before a command are executed before it
+    Send(client.get(), "TRANSFORM", "pose", mtsIGTLPoseBatch::BODY_SIZE);
+    Send(client.get(), "TRANSFORM", "pose", mtsIGTLPoseBatch::BODY_SIZE);
+    Send(client.get(), "STRING", "command", CommandSize);
+    Send(client.get(), "TRANSFORM", "pose", mtsIGTLPoseBatch::BODY_SIZE);
+    Send(client.get(), "STRING", "command", CommandSize);
+    Send(client.get(), "STRING", "command", CommandSize);
+    Send(client.get(), "TRANSFORM", "pose", mtsIGTLPoseBatch::BODY_SIZE);
+    bridge.ReceiveAll();
+
+    SAW_IGTL_CHECK(pending.size() == 3);
+    for (const auto & count : pending) {
+        SAW_IGTL_CHECK(count == 0);
+    }
+    // trailing poses are converted at the end of the pass
+    SAW_IGTL_CHECK(bridge.PendingPoses() == 0);
+
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,68 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsCISSTToIGTL.h>
+#include <sawOpenIGTLink/mtsIGTLToCISST.h>
+
+#include "sawOpenIGTLinkTests.h"
+
+// POSITION messages for Cartesian poses, position and quaternion
+
+int main(void)
+{
+    // 90 degrees around z
+    prmPositionCartesianGet pose;
+    vctMatRot3 & rotation = pose.Position().Rotation();
+    rotation.Element(0, 0) = 0.0; rotation.Element(0, 1) = -1.0; rotation.Element(0, 2) = 0.0;
+    rotation.Element(1, 0) = 1.0; rotation.Element(1, 1) = 0.0; rotation.Element(1, 2) = 0.0;
+    rotation.Element(2, 0) = 0.0; rotation.Element(2, 1) = 0.0; rotation.Element(2, 2) = 1.0;
+    pose.Position().Translation().Element(0) = 0.1;
+    pose.Position().Translation().Element(1) = -0.2;
+    pose.Position().Translation().Element(2) = 0.3;
+    pose.SetValid(true);
+
+    igtl::PositionMessage::Pointer message = igtl::PositionMessage::New();
+    SAW_IGTL_CHECK(mtsCISSTToIGTL(pose, message));
+    SAW_IGTL_CHECK(message->GetPackType() == igtl::PositionMessage::ALL);
+
+    // quaternion is x, y, z, w
+    float quaternion[4];
+    message->GetQuaternion(quaternion);
+    SAW_IGTL_CHECK_CLOSE(quaternion[0], 0.0, 1e-6);
+    SAW_IGTL_CHECK_CLOSE(quaternion[1], 0.0, 1e-6);
+    SAW_IGTL_CHECK_CLOSE(std::fabs(quaternion[2]), std::sqrt(0.5), 1e-6);
+    SAW_IGTL_CHECK_CLOSE(std::fabs(quaternion[3]), std::sqrt(0.5), 1e-6);
+
+    // back to cisst, float precision
+    prmPositionCartesianSet goal;
+    SAW_IGTL_CHECK(mtsIGTLToCISST(message, goal));
+    for (size_t row = 0; row < 3; ++row) {
+        SAW_IGTL_CHECK_CLOSE(goal.Goal().Translation().Element(row),
+                             pose.Position().Translation().Element(row), 1e-6);
+        for (size_t col = 0; col < 3; ++col) {
+            SAW_IGTL_CHECK_CLOSE(goal.Goal().Rotation().Element(row, col),
+                                 rotation.Element(row, col), 1e-6);
+        }
+    }
+
+    // invalid poses are not sent
+    pose.SetValid(false);
+    SAW_IGTL_CHECK(!mtsCISSTToIGTL(pose, message));
+
+    return SAW_IGTL_TEST_RESULT();
+}
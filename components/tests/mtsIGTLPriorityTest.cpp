@@ -0,0 +1,216 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+#include <sawOpenIGTLink/mtsIGTLPackedMessage.h>
+#include <sawOpenIGTLink/mtsIGTLReceiveBuffer.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "sawOpenIGTLinkTests.h"
+
+// records the order in which senders are executed
+class mtsIGTLPriorityTestSender: public mtsIGTLSenderBase
+{
+public:
+    mtsIGTLPriorityTestSender(const std::string & name, mtsIGTLBridge * bridge,
+                              std::vector<std::string> & executed,
+                              const double & duration = 0.0):
+        mtsIGTLSenderBase(name, bridge),
+        mExecuted(executed),
+        mDuration(duration) {}
+
+    bool Execute(void) override {
+        mExecuted.push_back(mName);
+        if (mDuration > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(mDuration));
+        }
+        return true;
+    }
+
+protected:
+    std::vector<std::string> & mExecuted;
+    double mDuration;
+};
+
+// records the sequence number of commands executed, deferred
+// messages are kept the same way as mtsIGTLReceiver: only the latest
+class mtsIGTLPriorityTestReceiver: public mtsIGTLReceiverBase
+{
+public:
+    mtsIGTLPriorityTestReceiver(const std::string & name, mtsIGTLBridge * bridge,
+                                std::vector<uint32_t> & executed):
+        mtsIGTLReceiverBase(name, bridge),
+        mExecuted(executed) {}
+
+    bool Execute(mtsIGTLReceiveBuffer & buffer, igtl::MessageBase *,
+                 const bool deferred) override {
+        buffer.Read(&mLatest, sizeof(mLatest));
+        mPending = deferred;
+        if (!deferred) {
+            mExecuted.push_back(mLatest);
+        }
+        return true;
+    }
+
+    bool ExecutePending(void) override {
+        if (!mPending) {
+            return false;
+        }
+        mPending = false;
+        mExecuted.push_back(mLatest);
+        return true;
+    }
+
+protected:
+    std::vector<uint32_t> & mExecuted;
+    uint32_t mLatest = 0;
+};
+
+// access to senders and cycle start
+class mtsIGTLPriorityTestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLPriorityTestBridge(void):
+        mtsIGTLBridge("bridge", 0.01) {}
+
+    void AddTestSender(const std::string & name,
+                       std::vector<std::string> & executed,
+                       const double & duration = 0.0) {
+        mSenders.push_back(new mtsIGTLPriorityTestSender(name, this, executed, duration));
+        mSendersByPriorityValid = false;
+    }
+
+    mtsIGTLReceiverBase * AddTestReceiver(const std::string & name,
+                                          std::vector<uint32_t> & executed) {
+        mtsIGTLReceiverBase * receiver = new mtsIGTLPriorityTestReceiver(name, this, executed);
+        mReceivers.insert({name, receiver});
+        return receiver;
+    }
+
+    void StartCycle(void) {
+        mCycleStart = osaGetTime();
+    }
+
+    //! Cycle started long ago, budget is used
+    void StartCycleOverBudget(void) {
+        Period = 1.0;
+        mCycleStart = osaGetTime() - 0.5;
+    }
+};
+
+static void SendCommand(mtsIGTLConnection * client, const char * type, const char * name,
+                        const uint32_t sequence)
+{
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType(type);
+    message.SetDeviceName(name);
+    memcpy(message.AllocateBody(sizeof(sequence)), &sequence, sizeof(sequence));
+    message.Pack();
+    client->Send(static_cast<const unsigned char *>(message.GetPackPointer()),
+                 message.GetPackSize());
+}
+
+int main(void)
+{
+    std::vector<std::string> executed;
+    mtsIGTLPriorityTestBridge bridge;
+    mtsIGTLMemoryListener listener;
+    std::unique_ptr<mtsIGTLConnection> client(listener.Connect("test"));
+    bridge.AddClient(listener.Accept());
+
+    mtsIGTLPriority priority;
+    SAW_IGTL_CHECK(mtsIGTLPriorityFromString("high", priority) && (priority == MTS_IGTL_PRIORITY_HIGH));
+    SAW_IGTL_CHECK(mtsIGTLPriorityFromString("low", priority) && (priority == MTS_IGTL_PRIORITY_LOW));
+    SAW_IGTL_CHECK(!mtsIGTLPriorityFromString("urgent", priority));
+
+    // high priority first, then normal and low
+    bridge.AddTestSender("arm/measured_js", executed);
+    bridge.AddTestSender("arm/servo_cp", executed);
+    bridge.AddTestSender("arm/measured_cp", executed);
+    SAW_IGTL_CHECK(bridge.SetPriority("*/servo_*", MTS_IGTL_PRIORITY_HIGH));
+    SAW_IGTL_CHECK(bridge.SetPriority("*/measured_js", MTS_IGTL_PRIORITY_LOW));
+    SAW_IGTL_CHECK(!bridge.SetPriority("none/*", MTS_IGTL_PRIORITY_LOW));
+    bridge.StartCycle();
+    bridge.SendAll();
+    SAW_IGTL_CHECK(executed.size() == 3);
+    SAW_IGTL_CHECK(executed[0] == "arm/servo_cp");
+    SAW_IGTL_CHECK(executed[1] == "arm/measured_cp");
+    SAW_IGTL_CHECK(executed[2] == "arm/measured_js");
+
+    // over budget, high priority still executed, lower priorities
+    // deferred and resumed where they stopped
+    mtsIGTLPriorityTestBridge budgetBridge;
+    mtsIGTLMemoryListener budgetListener;
+    std::unique_ptr<mtsIGTLConnection> budgetClient(budgetListener.Connect("test"));
+    budgetBridge.AddClient(budgetListener.Accept());
+    budgetBridge.AddTestSender("servo", executed, 0.01);
+    budgetBridge.AddTestSender("a", executed, 0.01);
+    budgetBridge.AddTestSender("b", executed, 0.01);
+    budgetBridge.SetPriority("servo", MTS_IGTL_PRIORITY_HIGH);
+    budgetBridge.SetCycleBudget(0.015);
+    executed.clear();
+    budgetBridge.StartCycle();
+    budgetBridge.SendAll();
+    SAW_IGTL_CHECK(executed.size() == 2);
+    SAW_IGTL_CHECK(executed[0] == "servo");
+    SAW_IGTL_CHECK(executed[1] == "a");
+    executed.clear();
+    budgetBridge.StartCycle();
+    budgetBridge.SendAll();
+    SAW_IGTL_CHECK(executed.size() == 2);
+    SAW_IGTL_CHECK(executed[0] == "servo");
+    SAW_IGTL_CHECK(executed[1] == "b");
+
+    // over budget, commands are all executed in order while state
+    // only keeps the latest message until next cycle
+    const uint32_t count = 20;
+    std::vector<uint32_t> commands, states;
+    mtsIGTLPriorityTestBridge receiveBridge;
+    mtsIGTLMemoryListener receiveListener;
+    std::unique_ptr<mtsIGTLConnection> receiveClient(receiveListener.Connect("test"));
+    receiveBridge.AddClient(receiveListener.Accept());
+    mtsIGTLReceiverBase * command = receiveBridge.AddTestReceiver("arm/command", commands);
+    mtsIGTLReceiverBase * state = receiveBridge.AddTestReceiver("tracker/pose", states);
+    SAW_IGTL_CHECK(receiveBridge.SetCoalesced("tracker/*"));
+    SAW_IGTL_CHECK(!receiveBridge.SetCoalesced("none/*"));
+    SAW_IGTL_CHECK(!command->GetCoalesced() && state->GetCoalesced());
+    receiveBridge.SetCycleBudget(0.001);
+    for (uint32_t sequence = 0; sequence < count; ++sequence) {
+        SendCommand(receiveClient.get(), "STRING", "arm/command", sequence);
+        SendCommand(receiveClient.get(), "STRING", "tracker/pose", sequence);
+    }
+    // messages are parsed in a few passes, see ReceiveAll
+    for (size_t pass = 0; (pass < 2 * count) && (commands.size() < count); ++pass) {
+        receiveBridge.StartCycleOverBudget();
+        receiveBridge.ReceiveAll();
+    }
+    SAW_IGTL_CHECK(commands.size() == count);
+    for (uint32_t sequence = 0; sequence < commands.size(); ++sequence) {
+        SAW_IGTL_CHECK(commands[sequence] == sequence);
+    }
+    SAW_IGTL_CHECK(states.empty());
+    SAW_IGTL_CHECK(!command->ExecutePending());
+    SAW_IGTL_CHECK(state->ExecutePending());
+    SAW_IGTL_CHECK((states.size() == 1) && (states[0] == count - 1));
+
+    return SAW_IGTL_TEST_RESULT();
+}
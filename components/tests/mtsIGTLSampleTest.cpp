@@ -0,0 +1,66 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsCISSTToIGTL.h>
+
+#include <cmath>
+
+#include "sawOpenIGTLinkTests.h"
+
+// state table history rows must have a fixed number of columns
+static void TestStateJoint(void)
+{
+    prmStateJoint state;
+    state.SetValid(true);
+    state.Name().resize(3);
+    state.Position().SetSize(3);
+    state.Position().SetAll(1.0);
+    state.Effort().SetSize(2);
+    state.Effort().SetAll(3.0);
+
+    std::vector<double> values;
+    SAW_IGTL_CHECK(mtsCISSTToIGTLSample(state, values));
+    SAW_IGTL_CHECK(values.size() == 9);
+    for (size_t index = 0; index < 3; ++index) {
+        SAW_IGTL_CHECK(values[index] == 1.0);
+        // no velocity
+        SAW_IGTL_CHECK(std::isnan(values[3 + index]));
+    }
+    SAW_IGTL_CHECK(values[6] == 3.0);
+    SAW_IGTL_CHECK(values[7] == 3.0);
+    SAW_IGTL_CHECK(std::isnan(values[8]));
+
+    // no names, use largest vector
+    state.Name().clear();
+    state.Velocity().SetSize(4);
+    state.Velocity().SetAll(2.0);
+    SAW_IGTL_CHECK(mtsCISSTToIGTLSample(state, values));
+    SAW_IGTL_CHECK(values.size() == 12);
+    SAW_IGTL_CHECK(std::isnan(values[3]));
+    SAW_IGTL_CHECK(values[7] == 2.0);
+    SAW_IGTL_CHECK(std::isnan(values[11]));
+
+    state.SetValid(false);
+    SAW_IGTL_CHECK(!mtsCISSTToIGTLSample(state, values));
+}
+
+int main(void)
+{
+    TestStateJoint();
+    return SAW_IGTL_TEST_RESULT();
+}
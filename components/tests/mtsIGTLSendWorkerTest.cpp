@@ -0,0 +1,166 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "sawOpenIGTLinkTests.h"
+
+// blocks in Send until released, like a socket with a slow peer
+class mtsIGTLSendWorkerTestConnection: public mtsIGTLConnection
+{
+public:
+    mtsIGTLSendWorkerTestConnection(std::atomic<bool> & entered,
+                                    std::atomic<bool> & released):
+        mtsIGTLConnection("slow"),
+        mEntered(entered),
+        mReleased(released) {}
+
+    int GetDescriptor(void) const override {
+        return -1;
+    }
+
+    long long Receive(unsigned char *, const size_t) override {
+        return 0;
+    }
+
+    long long Send(const unsigned char *, const size_t size) override {
+        mEntered = true;
+        while (!mReleased) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return static_cast<long long>(size);
+    }
+
+protected:
+    std::atomic<bool> & mEntered;
+    std::atomic<bool> & mReleased;
+};
+
+class mtsIGTLSendWorkerTestBridge: public mtsIGTLBridge
+{
+public:
+    mtsIGTLSendWorkerTestBridge(void):
+        mtsIGTLBridge("bridge", 1.0) {
+        Period = 1.0;
+        mCycleStart = osaGetTime();
+        mSocketTimeout = 1;
+        mServer = false;
+        SetSendWorker(true);
+    }
+
+    void SendFrame(const unsigned char * data, const size_t size) {
+        SendBytes(data, size, "a");
+        PublishSendFrame();
+    }
+
+    void Publish(void) {
+        PublishSendFrame();
+    }
+};
+
+static bool WaitFor(const std::atomic<bool> & flag)
+{
+    const double start = osaGetTime();
+    while (!flag && ((osaGetTime() - start) < 5.0)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return flag;
+}
+
+int main(void)
+{
+    std::atomic<bool> entered(false);
+    std::atomic<bool> released(false);
+    mtsIGTLSendWorkerTestBridge bridge;
+    bridge.Startup();
+    mtsIGTLMemoryListener listener;
+    bridge.AddClient(new mtsIGTLSendWorkerTestConnection(entered, released));
+    std::unique_ptr<mtsIGTLConnection> client(listener.Connect("client"));
+    bridge.AddClient(listener.Accept());
+
+    mtsIGTLPackedMessage message;
+    message.SetDeviceType("STRING");
+    message.SetDeviceName("a");
+    memset(message.AllocateBody(8), 0, 8);
+    message.Pack();
+    const unsigned char * data = static_cast<const unsigned char *>(message.GetPackPointer());
+    const size_t size = message.GetPackSize();
+
+    // the bridge thread isn't blocked while the worker writes to a slow client
+    bridge.SendFrame(data, size);
+    SAW_IGTL_CHECK(WaitFor(entered));
+    std::unique_ptr<mtsIGTLConnection> other(listener.Connect("other"));
+    bridge.AddClient(listener.Accept());
+    bridge.ReceiveAll();
+    SAW_IGTL_CHECK(!released);
+
+    // the worker continues with the other clients once released
+    released = true;
+    unsigned char buffer[256];
+    long long received = 0;
+    const double start = osaGetTime();
+    while ((received == 0) && ((osaGetTime() - start) < 5.0)) {
+        received = client->Receive(buffer, sizeof(buffer));
+    }
+    SAW_IGTL_CHECK(received == static_cast<long long>(size));
+
+    // clients added while the worker was busy get the next frame
+    bridge.SendFrame(data, size);
+    received = 0;
+    while ((received == 0) && ((osaGetTime() - start) < 5.0)) {
+        received = other->Receive(buffer, sizeof(buffer));
+    }
+    SAW_IGTL_CHECK(received == static_cast<long long>(size));
+
+    // state in a frame is replaced by the latest, events are all sent
+    std::vector<unsigned char> expected;
+    for (const std::string type : {"STRING", "SENSOR"}) {
+        message.SetDeviceType(type);
+        for (unsigned char index = 0; index < 3; ++index) {
+            memset(message.AllocateBody(8), index, 8);
+            message.Pack();
+            bridge.SendBytes(data, size, "a", true);
+            if ((type == "STRING") || (index == 2)) {
+                expected.insert(expected.end(), data, data + size);
+            }
+        }
+    }
+    bridge.Publish();
+    std::vector<unsigned char> frame;
+    while ((frame.size() < expected.size()) && ((osaGetTime() - start) < 5.0)) {
+        received = other->Receive(buffer, sizeof(buffer));
+        if (received > 0) {
+            frame.insert(frame.end(), buffer, buffer + received);
+        }
+    }
+    SAW_IGTL_CHECK(frame == expected);
+
+    // client lost by the worker, removed with the others
+    client.reset();
+    bridge.SendFrame(data, size);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    bridge.Cleanup();
+
+    return SAW_IGTL_TEST_RESULT();
+}
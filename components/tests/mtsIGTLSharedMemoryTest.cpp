@@ -0,0 +1,99 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLSharedMemory.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "sawOpenIGTLinkTests.h"
+
+static std::vector<unsigned char> Frame(const size_t size, const unsigned char value)
+{
+    return std::vector<unsigned char>(size, value);
+}
+
+int main(void)
+{
+    const std::string name = "/sawIGTL-test-" + std::to_string(getpid());
+    mtsIGTLSharedMemoryWriter writer;
+    SAW_IGTL_CHECK(writer.Open(name, 1024));
+
+    // private by default
+    const int descriptor = shm_open(name.c_str(), O_RDONLY, 0);
+    struct stat status;
+    SAW_IGTL_CHECK((descriptor >= 0) && (fstat(descriptor, &status) == 0));
+    SAW_IGTL_CHECK((status.st_mode & 0777) == 0600);
+    close(descriptor);
+
+    mtsIGTLSharedMemoryReader reader;
+    SAW_IGTL_CHECK(reader.Open(name));
+
+    // nothing published yet
+    std::vector<unsigned char> frame;
+    SAW_IGTL_CHECK(!reader.Read(frame, 0));
+
+    // frames in order, including a wrap around the end of the ring
+    for (unsigned char index = 0; index < 20; ++index) {
+        const std::vector<unsigned char> data = Frame(100 + index, index);
+        SAW_IGTL_CHECK(writer.Write(data.data(), data.size()));
+        SAW_IGTL_CHECK(reader.Read(frame, 0));
+        SAW_IGTL_CHECK(frame == data);
+    }
+    SAW_IGTL_CHECK(reader.GetLost() == 0);
+
+    // too large
+    const std::vector<unsigned char> large = Frame(600, 0);
+    SAW_IGTL_CHECK(!writer.Write(large.data(), large.size()));
+
+    // lapped reader skips frames published so far, then continues
+    for (unsigned char index = 0; index < 20; ++index) {
+        const std::vector<unsigned char> data = Frame(100, index);
+        writer.Write(data.data(), data.size());
+    }
+    SAW_IGTL_CHECK(!reader.Read(frame, 0));
+    SAW_IGTL_CHECK(reader.GetLost() > 0);
+    const std::vector<unsigned char> next = Frame(50, 42);
+    writer.Write(next.data(), next.size());
+    SAW_IGTL_CHECK(reader.Read(frame, 0));
+    SAW_IGTL_CHECK(frame == next);
+
+    // waiting reader is woken up by the writer
+    const std::vector<unsigned char> late = Frame(10, 7);
+    std::thread thread([&writer, &late] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        writer.Write(late.data(), late.size());
+    });
+    const auto start = std::chrono::steady_clock::now();
+    SAW_IGTL_CHECK(reader.Read(frame, 2000));
+    SAW_IGTL_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000));
+    SAW_IGTL_CHECK(frame == late);
+    thread.join();
+
+    // timeout
+    SAW_IGTL_CHECK(!reader.Read(frame, 10));
+
+    // segment removed by the writer
+    reader.Close();
+    writer.Close();
+    mtsIGTLSharedMemoryReader closed;
+    SAW_IGTL_CHECK(!closed.Open(name));
+
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,65 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLTrace.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "sawOpenIGTLinkTests.h"
+
+static std::string ReadFile(const std::string & fileName)
+{
+    std::ifstream input(fileName.c_str());
+    std::stringstream content;
+    content << input.rdbuf();
+    return content.str();
+}
+
+int main(void)
+{
+    const std::string fileName = "mtsIGTLTraceTest.json";
+    mtsIGTLTrace trace;
+    SAW_IGTL_CHECK(!trace.Enabled());
+    SAW_IGTL_CHECK(trace.Add("send", "ignored", 0.0) == 0.0);
+
+    // ring buffer of 2, oldest event is dropped
+    trace.SetSize(2);
+    SAW_IGTL_CHECK(trace.Enabled());
+    double start = trace.Time();
+    start = trace.Add("dropped", start);
+    start = trace.Add("send", "a\"b\\c", start);
+    start = trace.Add("receive", "line\nfeed\ttab\x01", start);
+    SAW_IGTL_CHECK(trace.SaveChromeTrace(fileName, "bridge \"test\""));
+
+    const std::string json = ReadFile(fileName);
+    std::remove(fileName.c_str());
+    SAW_IGTL_CHECK(json.find("dropped") == std::string::npos);
+    SAW_IGTL_CHECK(json.find("\"args\": {\"name\": \"bridge \\\"test\\\"\"}") != std::string::npos);
+    SAW_IGTL_CHECK(json.find("\"detail\": \"a\\\"b\\\\c\"") != std::string::npos);
+    SAW_IGTL_CHECK(json.find("\"detail\": \"line\\nfeed\\ttab\\u0001\"") != std::string::npos);
+    // no raw control characters except the line breaks between events
+    for (size_t index = 0; index < json.size(); ++index) {
+        const unsigned char character = static_cast<unsigned char>(json[index]);
+        SAW_IGTL_CHECK((character >= 0x20) || (character == '\n'));
+    }
+    // events are in order, oldest first
+    SAW_IGTL_CHECK(json.find("\"send\"") < json.find("\"receive\""));
+    return SAW_IGTL_TEST_RESULT();
+}
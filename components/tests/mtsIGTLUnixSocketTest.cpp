@@ -0,0 +1,91 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLTransport.h>
+#include <sawOpenIGTLink/mtsIGTLUnixSocket.h>
+
+#include <cerrno>
+#include <fstream>
+#include <memory>
+
+#include "sawOpenIGTLinkTests.h"
+
+int main(void)
+{
+    const std::string path = "/tmp/sawIGTL-test-" + std::to_string(getpid()) + ".sock";
+    unlink(path.c_str());
+
+    // never remove a file that is not a socket
+    {
+        std::ofstream file(path.c_str());
+        file << "data";
+    }
+    mtsIGTLUnixListener listener;
+    SAW_IGTL_CHECK(!listener.Create(path));
+    struct stat status;
+    SAW_IGTL_CHECK((lstat(path.c_str(), &status) == 0) && S_ISREG(status.st_mode));
+    unlink(path.c_str());
+
+    // stale socket file, closed without removing the file, is replaced
+    unsigned long long device, inode;
+    const int stale = mtsIGTLUnixSocket::Listen(path, device, inode);
+    SAW_IGTL_CHECK(stale >= 0);
+    close(stale);
+    SAW_IGTL_CHECK(listener.Create(path));
+
+    // each connection has its own name
+    igtl::ClientSocket::Pointer first = mtsIGTLUnixSocket::Connect(path);
+    igtl::ClientSocket::Pointer second = mtsIGTLUnixSocket::Connect(path);
+    SAW_IGTL_CHECK(first.IsNotNull() && second.IsNotNull());
+    std::unique_ptr<mtsIGTLConnection> firstConnection(listener.Accept());
+    std::unique_ptr<mtsIGTLConnection> secondConnection(listener.Accept());
+    SAW_IGTL_CHECK(firstConnection && secondConnection);
+    if (firstConnection && secondConnection) {
+        SAW_IGTL_CHECK(firstConnection->GetName() == "unix:" + path + ":1");
+        SAW_IGTL_CHECK(secondConnection->GetName() == "unix:" + path + ":2");
+    }
+
+    // socket in use is never taken over nor removed by another listener
+    {
+        mtsIGTLUnixListener other;
+        errno = 0;
+        SAW_IGTL_CHECK(!other.Create(path));
+        SAW_IGTL_CHECK(errno == EADDRINUSE);
+    }
+    SAW_IGTL_CHECK((lstat(path.c_str(), &status) == 0) && S_ISSOCK(status.st_mode));
+    // the probe used to detect the listener is accepted and closed
+    std::unique_ptr<mtsIGTLConnection> probe(listener.Accept());
+    SAW_IGTL_CHECK(probe != nullptr);
+    SAW_IGTL_CHECK(listener.Accept() == nullptr);
+
+    // a listener only removes the socket file it created
+    const std::string other = path + ".other";
+    {
+        std::unique_ptr<mtsIGTLUnixListener> original(new mtsIGTLUnixListener);
+        SAW_IGTL_CHECK(original->Create(other));
+        // e.g. file removed by hand and another bridge started
+        unlink(other.c_str());
+        mtsIGTLUnixListener replacement;
+        SAW_IGTL_CHECK(replacement.Create(other));
+        original.reset();
+        SAW_IGTL_CHECK(lstat(other.c_str(), &status) == 0);
+    }
+    SAW_IGTL_CHECK(lstat(other.c_str(), &status) != 0);
+
+    return SAW_IGTL_TEST_RESULT();
+}
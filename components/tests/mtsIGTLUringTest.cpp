@@ -0,0 +1,111 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// io_uring backend is private, only built with liburing
+#include "mtsIGTLUring.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+
+#include "sawOpenIGTLinkTests.h"
+
+int main(void)
+{
+    mtsIGTLUring ring;
+    if (!ring.Init(16, 2, 4096, 1024)) {
+        // kernel without io_uring (or disabled), nothing to test
+        std::cerr << "io_uring not available, skipping" << std::endl;
+        return 0;
+    }
+
+    int descriptors[2];
+    SAW_IGTL_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, descriptors) == 0);
+    std::vector<mtsIGTLUring::Completion> completions;
+
+    // timeout without completion is not an error
+    SAW_IGTL_CHECK(ring.Receive(1, descriptors[0]));
+    const auto start = std::chrono::steady_clock::now();
+    SAW_IGTL_CHECK(ring.SubmitAndWait(20, completions) == 0);
+    SAW_IGTL_CHECK(completions.empty());
+    SAW_IGTL_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(10));
+
+    // receive
+    SAW_IGTL_CHECK(write(descriptors[1], "hello", 5) == 5);
+    SAW_IGTL_CHECK(ring.SubmitAndWait(1000, completions) == 0);
+    SAW_IGTL_CHECK(completions.size() == 1);
+    if (completions.size() == 1) {
+        SAW_IGTL_CHECK(completions[0].Operation == mtsIGTLUring::RECEIVE);
+        SAW_IGTL_CHECK(completions[0].Id == 1);
+        SAW_IGTL_CHECK(completions[0].Result == 5);
+        SAW_IGTL_CHECK(memcmp(completions[0].Data, "hello", 5) == 0);
+    }
+
+    // large send, zero copy or regular send if not supported
+    std::vector<unsigned char> data(2000);
+    for (size_t index = 0; index < data.size(); ++index) {
+        data[index] = static_cast<unsigned char>(index);
+    }
+    const std::vector<unsigned char> expected(data);
+    SAW_IGTL_CHECK(ring.Send(1, descriptors[0], data));
+    SAW_IGTL_CHECK(ring.SendInFlight(1));
+    for (size_t count = 0; (count < 100) && ring.SendInFlight(1); ++count) {
+        SAW_IGTL_CHECK(ring.SubmitAndWait(10, completions) == 0);
+        // only errors are reported for sends
+        for (auto & completion : completions) {
+            SAW_IGTL_CHECK(completion.Operation != mtsIGTLUring::SEND);
+        }
+    }
+    SAW_IGTL_CHECK(!ring.SendInFlight(1));
+    std::vector<unsigned char> received(expected.size());
+    size_t offset = 0;
+    while (offset < received.size()) {
+        const ssize_t nbBytes = read(descriptors[1], received.data() + offset, received.size() - offset);
+        SAW_IGTL_CHECK(nbBytes > 0);
+        if (nbBytes <= 0) {
+            break;
+        }
+        offset += static_cast<size_t>(nbBytes);
+    }
+    SAW_IGTL_CHECK(received == expected);
+
+    // poll only interrupts the wait
+    int wakeup[2];
+    SAW_IGTL_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, wakeup) == 0);
+    SAW_IGTL_CHECK(ring.Poll(wakeup[0]));
+    SAW_IGTL_CHECK(write(wakeup[1], "x", 1) == 1);
+    SAW_IGTL_CHECK(ring.SubmitAndWait(1000, completions) == 0);
+    SAW_IGTL_CHECK(completions.empty());
+
+    // closed connection
+    SAW_IGTL_CHECK(ring.Receive(1, descriptors[0]));
+    close(descriptors[1]);
+    SAW_IGTL_CHECK(ring.SubmitAndWait(1000, completions) == 0);
+    SAW_IGTL_CHECK(completions.size() == 1);
+    if (completions.size() == 1) {
+        SAW_IGTL_CHECK(completions[0].Result == 0);
+    }
+
+    ring.Release(1);
+    close(descriptors[0]);
+    close(wakeup[0]);
+    close(wakeup[1]);
+    return SAW_IGTL_TEST_RESULT();
+}
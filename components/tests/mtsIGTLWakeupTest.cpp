@@ -0,0 +1,71 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawOpenIGTLink/mtsIGTLBridge.h>
+
+#include <chrono>
+#include <thread>
+
+#include <sys/select.h>
+
+#include "sawOpenIGTLinkTests.h"
+
+// wait up to timeout (in ms) for the descriptor to be readable
+static bool WaitReadable(const int descriptor, const int timeout)
+{
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(descriptor, &readSet);
+    struct timeval timeoutSelect;
+    timeoutSelect.tv_sec = timeout / 1000;
+    timeoutSelect.tv_usec = (timeout % 1000) * 1000;
+    return select(descriptor + 1, &readSet, nullptr, nullptr, &timeoutSelect) > 0;
+}
+
+int main(void)
+{
+    mtsIGTLWakeup wakeup;
+    const int descriptor = wakeup.GetDescriptor();
+    SAW_IGTL_CHECK(descriptor >= 0);
+    SAW_IGTL_CHECK(!WaitReadable(descriptor, 0));
+
+    // multiple signals, a single clear
+    wakeup.Signal();
+    wakeup.Signal();
+    SAW_IGTL_CHECK(WaitReadable(descriptor, 0));
+    wakeup.Clear();
+    SAW_IGTL_CHECK(!WaitReadable(descriptor, 0));
+
+    // trigger event handler from another thread interrupts the wait
+    mtsIGTLTrigger trigger;
+    trigger.Wakeup = &wakeup;
+    std::thread component([&trigger]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            trigger.EventHandler();
+        });
+    const auto start = std::chrono::steady_clock::now();
+    SAW_IGTL_CHECK(WaitReadable(descriptor, 5000));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    component.join();
+    SAW_IGTL_CHECK(elapsed < std::chrono::seconds(1));
+    SAW_IGTL_CHECK(trigger.Check());
+    SAW_IGTL_CHECK(!trigger.Check());
+    wakeup.Clear();
+    SAW_IGTL_CHECK(!WaitReadable(descriptor, 0));
+    return SAW_IGTL_TEST_RESULT();
+}
@@ -0,0 +1,67 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _sawOpenIGTLinkTests_h
+#define _sawOpenIGTLinkTests_h
+
+/*!
+  \file
+  \brief Minimal checks for sawOpenIGTLink tests
+
+  Each test is a small executable registered with add_test (see
+  tests/CMakeLists.txt).  Failed checks are reported with file and
+  line and main returns the number of failures.
+
+  \code
+  int main(void)
+  {
+      SAW_IGTL_CHECK(1 + 1 == 2);
+      return SAW_IGTL_TEST_RESULT();
+  }
+  \endcode
+*/
+
+#include <cmath>
+#include <iostream>
+
+static int sawOpenIGTLinkTestFailures = 0;
+
+#define SAW_IGTL_CHECK(condition)                                       \
+    do {                                                                \
+        if (!(condition)) {                                             \
+            std::cerr << __FILE__ << ":" << __LINE__                    \
+                      << ": check failed: " << #condition << std::endl; \
+            ++sawOpenIGTLinkTestFailures;                               \
+        }                                                               \
+    } while (0)
+
+#define SAW_IGTL_CHECK_CLOSE(value, expected, tolerance)                \
+    do {                                                                \
+        if (!(std::fabs((value) - (expected)) <= (tolerance))) {        \
+            std::cerr << __FILE__ << ":" << __LINE__                    \
+                      << ": check failed: " << #value << " = " << (value) \
+                      << ", expected " << (expected) << std::endl;      \
+            ++sawOpenIGTLinkTestFailures;                               \
+        }                                                               \
+    } while (0)
+
+#define SAW_IGTL_TEST_RESULT()                                          \
+    ((sawOpenIGTLinkTestFailures == 0) ? 0 :                            \
+     (std::cerr << sawOpenIGTLinkTestFailures << " check(s) failed" << std::endl, 1))
+
+#endif // _sawOpenIGTLinkTests_h
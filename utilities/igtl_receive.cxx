@@ -17,6 +17,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <set>
+#include <vector>
+#include <algorithm>
 
 #include "igtlOSUtil.h"
 #include "igtlMessageHeader.h"
@@ -34,56 +36,179 @@
 #include "igtlQuaternionTrackingDataMessage.h"
 #include "igtlCapabilityMessage.h"
 
-int ReceiveTransform(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceivePosition(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceiveImage(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceiveStatus(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceiveSensor(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceiveNDArray(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceivePoint(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceiveTrajectory(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceiveString(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceiveTrackingData(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceiveQuaternionTrackingData(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header);
-int ReceiveCapability(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader * header);
+#ifndef _WIN32
+#include <sawOpenIGTLink/mtsIGTLSharedMemory.h>
+#include <sawOpenIGTLink/mtsIGTLUnixSocket.h>
+
+// Socket like reader for the bridge shared memory, each frame is a
+// full message so header and body are read from the same frame
+class SharedMemorySocket
+{
+public:
+  SharedMemorySocket() : offset(0) {}
+
+  bool Open(const char* name)
+  {
+    return reader.Open(name);
+  }
+
+  int Receive(void* data, igtlUint64 length, bool& timeout, int readFully = 1)
+  {
+    if (offset >= frame.size())
+      {
+        offset = 0;
+        frame.clear();
+        if (!reader.Read(frame, 1000))
+          {
+            timeout = true;
+            return -1;
+          }
+      }
+    size_t n = std::min(static_cast<size_t>(length), frame.size() - offset);
+    memcpy(data, frame.data() + offset, n);
+    offset += n;
+    return static_cast<int>(n);
+  }
+
+  int Skip(igtlUint64 length, int skipFully = 1)
+  {
+    size_t n = std::min(static_cast<size_t>(length), frame.size() - offset);
+    offset += n;
+    return static_cast<int>(n);
+  }
+
+  void CloseSocket()
+  {
+    if (reader.GetLost() > 0)
+      {
+        std::cerr << "Messages lost (overwritten in shared memory): " << reader.GetLost() << std::endl;
+      }
+    reader.Close();
+  }
+
+protected:
+  mtsIGTLSharedMemoryReader reader;
+  std::vector<unsigned char> frame;
+  size_t offset;
+};
+#endif
+
+template <class TSocket>
+int ReceiveTransform(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceivePosition(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceiveImage(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceiveStatus(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceiveSensor(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceiveNDArray(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceivePoint(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceiveTrajectory(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceiveString(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceiveTrackingData(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceiveQuaternionTrackingData(TSocket& socket, igtl::MessageHeader::Pointer& header);
+template <class TSocket>
+int ReceiveCapability(TSocket& socket, igtl::MessageHeader * header);
+template <class TSocket>
+void ReceiveMessages(TSocket& socket, bool filterDevice, const std::string& device,
+                     std::set<std::string>& devicesSkipped);
 
 int main(int argc, char* argv[])
 {
   //------------------------------------------------------------
   // Parse Arguments
 
-  if (!((argc == 3) || (argc == 4))) {
+#ifndef _WIN32
+  bool sharedMemory = (argc > 1) && (strncmp(argv[1], "shm:", 4) == 0);
+  bool unixSocket = (argc > 1) && (strncmp(argv[1], "unix:", 5) == 0);
+#else
+  bool sharedMemory = false;
+  bool unixSocket = false;
+#endif
+  int deviceArg = (sharedMemory || unixSocket) ? 2 : 3;
+
+  if (!((argc == deviceArg) || (argc == deviceArg + 1))) {
     // If not correct, print usage
-    std::cerr << "    <hostname> : IP or host name" << std::endl
+    std::cerr << "    <hostname> : IP or host name, unix:<path> for Unix domain socket" << std::endl
+	      << "                 or shm:<name> for bridge shared memory (no port for both)" << std::endl
 	      << "    <port>     : Port # (18944 in Slicer default)" << std::endl
 	      << "    <device>   : Device Name (optional)" << std::endl;
     exit(0);
   }
 
-  char*  hostname = argv[1];
-  int    port     = atoi(argv[2]);
   bool filterDevice = false;
   std::string device;
-  if (argc == 4) {
+  if (argc == deviceArg + 1) {
     filterDevice = true;
-    device = argv[3];
+    device = argv[deviceArg];
     std::cout << "Showing only messages with device name: " << device << std::endl;
   }
 
   std::set<std::string> devicesSkipped;
 
+#ifndef _WIN32
   //------------------------------------------------------------
-  // Establish Connection
-  igtl::ClientSocket::Pointer socket;
-  socket = igtl::ClientSocket::New();
-  int r = socket->ConnectToServer(hostname, port);
-
-  if (r != 0)
+  // Open shared memory published by the bridge
+  if (sharedMemory)
     {
-      std::cerr << "Cannot connect to the server." << std::endl;
-      exit(0);
+      SharedMemorySocket shm;
+      if (!shm.Open(argv[1] + 4))
+        {
+          std::cerr << "Cannot open shared memory " << (argv[1] + 4) << std::endl;
+          exit(0);
+        }
+      SharedMemorySocket* socket = &shm;
+      ReceiveMessages(socket, filterDevice, device, devicesSkipped);
+    }
+  else if (unixSocket)
+    {
+      igtl::ClientSocket::Pointer socket = mtsIGTLUnixSocket::Connect(argv[1] + 5);
+      if (socket.IsNull())
+        {
+          std::cerr << "Cannot connect to " << (argv[1] + 5) << std::endl;
+          exit(0);
+        }
+      ReceiveMessages(socket, filterDevice, device, devicesSkipped);
+    }
+  else
+#endif
+    {
+      char*  hostname = argv[1];
+      int    port     = atoi(argv[2]);
+
+      //------------------------------------------------------------
+      // Establish Connection
+      igtl::ClientSocket::Pointer socket;
+      socket = igtl::ClientSocket::New();
+      int r = socket->ConnectToServer(hostname, port);
+
+      if (r != 0)
+        {
+          std::cerr << "Cannot connect to the server." << std::endl;
+          exit(0);
+        }
+      ReceiveMessages(socket, filterDevice, device, devicesSkipped);
     }
 
+  std::cerr << std::endl << "Received and skipped messages from devices: " << std::endl;
+  for (auto & dev : devicesSkipped) {
+    std::cerr << dev << std::endl;
+  }
+}
+
+
+template <class TSocket>
+void ReceiveMessages(TSocket& socket, bool filterDevice, const std::string& device,
+                     std::set<std::string>& devicesSkipped)
+{
   //------------------------------------------------------------
   // Create a message buffer to receive header
   igtl::MessageHeader::Pointer headerMsg;
@@ -107,7 +232,7 @@ int main(int argc, char* argv[])
     if (r == 0)
       {
         socket->CloseSocket();
-        exit(0);
+        return;
       }
     if (r != headerMsg->GetPackSize())
       {
@@ -197,15 +322,11 @@ int main(int argc, char* argv[])
   //------------------------------------------------------------
   // Close connection
   socket->CloseSocket();
-
-  std::cerr << std::endl << "Received and skipped messages from devices: " << std::endl;
-  for (auto & dev : devicesSkipped) {
-    std::cerr << dev << std::endl;
-  }
 }
 
 
-int ReceiveTransform(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceiveTransform(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
   std::cout << "Receiving TRANSFORM data type." << std::endl;
 
@@ -235,7 +356,8 @@ int ReceiveTransform(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::P
   return 0;
 }
 
-int ReceiveSensor(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceiveSensor(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
   std::cout << "Receiving SENSOR data type." << std::endl;
 
@@ -265,7 +387,8 @@ int ReceiveSensor(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Poin
   return 0;
 }
 
-int ReceiveNDArray(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceiveNDArray(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
   std::cout << "Receiving NDARRAY data type." << std::endl;
 
@@ -317,7 +440,8 @@ int ReceiveNDArray(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Poi
   return 0;
 }
 
-int ReceivePosition(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceivePosition(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
   std::cout << "Receiving POSITION data type." << std::endl;
 
@@ -354,7 +478,8 @@ int ReceivePosition(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Po
   return 0;
 }
 
-int ReceiveImage(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceiveImage(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
   std::cout << "Receiving IMAGE data type." << std::endl;
 
@@ -408,7 +533,8 @@ int ReceiveImage(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Point
 }
 
 
-int ReceiveStatus(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceiveStatus(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
 
   std::cout << "Receiving STATUS data type." << std::endl;
@@ -441,7 +567,8 @@ int ReceiveStatus(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Poin
 
 }
 
-int ReceivePoint(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceivePoint(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
 
   std::cout << "Receiving POINT data type." << std::endl;
@@ -488,7 +615,8 @@ int ReceivePoint(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Point
   return 1;
 }
 
-int ReceiveTrajectory(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceiveTrajectory(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
 
   std::cout << "Receiving TRAJECTORY data type." << std::endl;
@@ -538,7 +666,8 @@ int ReceiveTrajectory(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::
   return 1;
 }
 
-int ReceiveString(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceiveString(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
 
   std::cout << "Receiving STRING data type." << std::endl;
@@ -566,7 +695,8 @@ int ReceiveString(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Poin
   return 1;
 }
 
-int ReceiveTrackingData(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceiveTrackingData(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
   std::cout << "Receiving TDATA data type." << std::endl;
 
@@ -608,7 +738,8 @@ int ReceiveTrackingData(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader
   return 0;
 }
 
-int ReceiveQuaternionTrackingData(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader::Pointer& header)
+template <class TSocket>
+int ReceiveQuaternionTrackingData(TSocket& socket, igtl::MessageHeader::Pointer& header)
 {
   std::cout << "Receiving QTDATA data type." << std::endl;
 
@@ -651,7 +782,8 @@ int ReceiveQuaternionTrackingData(igtl::ClientSocket::Pointer& socket, igtl::Mes
   return 0;
 }
 
-int ReceiveCapability(igtl::ClientSocket::Pointer& socket, igtl::MessageHeader * header)
+template <class TSocket>
+int ReceiveCapability(TSocket& socket, igtl::MessageHeader * header)
 {
 
   std::cout << "Receiving CAPABILITY data type." << std::endl;
@@ -0,0 +1,291 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+/*
+  Relay between one OpenIGTLink server (e.g. the cisst/SAW bridge) and
+  many clients.  The relay is the only client of the server and
+  re-serves the stream, so the server doesn't pay for the fan-out.
+  Messages are forwarded as received (no unpacking nor CRC check) and
+  shared by all clients, each client has its own send queue.
+
+  - device filters, for all clients (-d) or per client profile (-p),
+    a client selects its profile by sending a STRING message with
+    the device name CLIENT and the profile name as content (same as
+    the bridge client profiles)
+  - rate decimation (-r), at most n messages per second per device
+    and client, the latest message is sent when the period is over
+  - reverse path (-u), messages from clients for devices matching
+    these patterns are forwarded to the server, others are ignored
+  - the server connection is re-established in the background, the
+    host name is resolved before each attempt and attempts without
+    answer are abandoned after 2 seconds
+
+  POSIX only.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <csignal>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "igtl_relay.h"
+
+static bool ParseArguments(int argc, char * argv[], Options & options)
+{
+    if (argc < 4) {
+        return false;
+    }
+    options.Host = argv[1];
+    options.Port = atoi(argv[2]);
+    options.ListenPort = atoi(argv[3]);
+    for (int index = 4; index < argc; ++index) {
+        const std::string option = argv[index];
+        if (index + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++index];
+        if (option == "-d") {
+            options.Devices.push_back(value);
+        } else if (option == "-u") {
+            options.Upstream.push_back(value);
+        } else if (option == "-r") {
+            options.Rate = atof(value.c_str());
+        } else if (option == "-q") {
+            options.MaxQueueSize = strtoul(value.c_str(), nullptr, 10);
+        } else if (option == "-p") {
+            // name=pattern,pattern
+            const size_t equal = value.find('=');
+            if ((equal == std::string::npos) || (equal == 0)) {
+                return false;
+            }
+            std::list<std::string> & devices = options.Profiles[value.substr(0, equal)];
+            size_t start = equal + 1;
+            while (start <= value.size()) {
+                size_t end = value.find(',', start);
+                if (end == std::string::npos) {
+                    end = value.size();
+                }
+                if (end > start) {
+                    devices.push_back(value.substr(start, end - start));
+                }
+                start = end + 1;
+            }
+        } else {
+            return false;
+        }
+    }
+    return (options.Port > 0) && (options.ListenPort > 0);
+}
+
+static int Listen(const int port)
+{
+    const int descriptor = socket(AF_INET, SOCK_STREAM, 0);
+    if (descriptor < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if ((bind(descriptor, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0)
+        || (listen(descriptor, SOMAXCONN) != 0)
+        || !SetNonBlocking(descriptor)) {
+        close(descriptor);
+        return -1;
+    }
+    return descriptor;
+}
+
+int main(int argc, char * argv[])
+{
+    Options options;
+    if (!ParseArguments(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " <hostname> <port> <listen-port> [options]" << std::endl
+                  << "    <hostname>    : IP or host name of the server (e.g. cisst/SAW bridge)" << std::endl
+                  << "    <port>        : server port (18944 in Slicer default)" << std::endl
+                  << "    <listen-port> : port for the relay clients" << std::endl
+                  << "    -d <pattern>  : only send matching devices to all clients, can be repeated" << std::endl
+                  << "    -p <name>=<pattern>[,<pattern>...] : client profile, selected by sending" << std::endl
+                  << "                    a STRING message with device name CLIENT and the profile name" << std::endl
+                  << "    -r <rate>     : maximum messages per second per device and client" << std::endl
+                  << "    -u <pattern>  : forward matching devices from clients to the server, can be repeated" << std::endl
+                  << "    -q <bytes>    : maximum bytes queued per client (default 16 MB)" << std::endl
+                  << "Patterns support '*' and '?', e.g. arm/measured_*" << std::endl;
+        return 1;
+    }
+
+    // no SIGPIPE when a client disconnects
+    signal(SIGPIPE, SIG_IGN);
+
+    // the server doesn't need to be reachable yet, see Upstream::Connect
+    Upstream upstream;
+    upstream.Create(options.Host, options.Port);
+    if (!upstream.Resolve()) {
+        std::cerr << "Cannot resolve " << options.Host << " yet, will retry" << std::endl;
+    }
+    const int listener = Listen(options.ListenPort);
+    if (listener < 0) {
+        std::cerr << "Cannot listen on port " << options.ListenPort << std::endl;
+        return 1;
+    }
+    std::cerr << "Relaying " << upstream.Name << " on port " << options.ListenPort << std::endl;
+
+    std::list<Peer> clients;
+    std::vector<struct pollfd> descriptors;
+    Message message;
+    bool corrupted;
+    double nextRelease = 0.0;
+
+    while (true) {
+        double now = Now();
+        upstream.Connect(now);
+
+        // listener, server and clients
+        descriptors.clear();
+        descriptors.push_back({listener, POLLIN, 0});
+        if (upstream.Descriptor >= 0) {
+            short events = upstream.Connected ? POLLIN : POLLOUT;
+            if (upstream.Connected && !upstream.Queue.empty()) {
+                events |= POLLOUT;
+            }
+            descriptors.push_back({upstream.Descriptor, events, 0});
+        }
+        for (auto & client : clients) {
+            descriptors.push_back({client.Descriptor,
+                                   static_cast<short>(client.Queue.empty() ? POLLIN : (POLLIN | POLLOUT)), 0});
+        }
+        // wake up for reconnect and decimated messages
+        int timeout = 100;
+        if (nextRelease > 0.0) {
+            timeout = std::max(1, std::min(timeout, static_cast<int>((nextRelease - now) * 1000.0)));
+        }
+        if (poll(descriptors.data(), descriptors.size(), timeout) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "poll failed: " << strerror(errno) << std::endl;
+            return 1;
+        }
+        now = Now();
+        size_t index = 1;
+
+        // server
+        if (upstream.Descriptor >= 0) {
+            const short events = descriptors[index++].revents;
+            if (!upstream.Connected) {
+                if (events & (POLLOUT | POLLERR | POLLHUP)) {
+                    upstream.Connecting(now);
+                }
+            } else if (events & (POLLIN | POLLERR | POLLHUP)) {
+                bool alive = upstream.Fill();
+                while (upstream.Next(message, corrupted)) {
+                    for (auto & client : clients) {
+                        client.Offer(message, now, options);
+                    }
+                }
+                if (corrupted || !alive) {
+                    upstream.Retry(now);
+                }
+            }
+        }
+
+        // clients, forward commands to the server
+        for (auto & client : clients) {
+            const short events = descriptors[index++].revents;
+            if (!(events & (POLLIN | POLLERR | POLLHUP))) {
+                continue;
+            }
+            bool alive = client.Fill();
+            while (client.Next(message, corrupted)) {
+                if ((message.Type == "STRING") && (message.Device == "CLIENT")) {
+                    const std::string name = ProfileName(message);
+                    auto profile = options.Profiles.find(name);
+                    if (profile == options.Profiles.end()) {
+                        std::cerr << "Unknown profile \"" << name << "\" requested by " << client.Name << std::endl;
+                    } else {
+                        std::cerr << "Using profile \"" << name << "\" for " << client.Name << std::endl;
+                        client.Profile = &(profile->second);
+                        client.Accepted.clear();
+                    }
+                } else if (MatchAny(options.Upstream, message.Device)) {
+                    upstream.Forward(message, options.MaxQueueSize);
+                }
+            }
+            if (corrupted || !alive) {
+                client.Close();
+            }
+        }
+
+        // new clients, filtered by -d unless they select a profile
+        int descriptor;
+        while ((descriptor = accept(listener, nullptr, nullptr)) >= 0) {
+            SetNonBlocking(descriptor);
+            SetNoDelay(descriptor);
+            clients.emplace_back();
+            Peer & client = clients.back();
+            client.Descriptor = descriptor;
+            client.Name = "client " + std::to_string(descriptor);
+            if (!options.Devices.empty()) {
+                client.Profile = &(options.Devices);
+            }
+            std::cerr << "New " << client.Name << ", " << clients.size() << " client(s)" << std::endl;
+        }
+
+        // decimated messages due, then send
+        nextRelease = 0.0;
+        for (auto & client : clients) {
+            if (options.Rate > 0.0) {
+                const double next = client.Release(now, options);
+                if ((next > 0.0) && ((nextRelease == 0.0) || (next < nextRelease))) {
+                    nextRelease = next;
+                }
+            }
+            if ((client.Descriptor >= 0) && !client.Flush()) {
+                client.Close();
+            }
+        }
+        if (upstream.Connected && !upstream.Flush()) {
+            upstream.Retry(now);
+        }
+
+        // remove clients lost
+        for (auto client = clients.begin(); client != clients.end();) {
+            if (client->Descriptor < 0) {
+                std::cerr << "Lost " << client->Name << ", dropped " << client->Dropped
+                          << " message(s) over queue size" << std::endl;
+                client = clients.erase(client);
+            } else {
+                ++client;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,464 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _igtl_relay_h
+#define _igtl_relay_h
+
+/*
+  Connections and queues used by igtl_relay, see igtl_relay.cxx.  In
+  a header so igtl_relay_test can drive them over socket pairs.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// same device name patterns as mtsIGTLBridge
+#include <sawOpenIGTLink/mtsIGTLMatchPattern.h>
+
+// OpenIGTLink header: version (2), type (12), device name (20), time
+// stamp (8), body size (8) and CRC (8), big endian
+static const size_t HEADER_SIZE = 58;
+static const size_t TYPE_OFFSET = 2;
+static const size_t TYPE_SIZE = 12;
+static const size_t NAME_OFFSET = 14;
+static const size_t NAME_SIZE = 20;
+static const size_t BODY_SIZE_OFFSET = 42;
+// messages larger than this are considered corrupted
+static const unsigned long long MAXIMUM_BODY_SIZE = 256 * 1024 * 1024;
+
+#if defined(MSG_NOSIGNAL)
+static const int SEND_FLAGS = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = MSG_DONTWAIT;
+#endif
+
+inline double Now(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline bool MatchAny(const std::list<std::string> & patterns, const std::string & name)
+{
+    for (auto & pattern : patterns) {
+        if (mtsIGTLMatchPattern(pattern, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool SetNonBlocking(const int descriptor)
+{
+    return (fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL, 0) | O_NONBLOCK) == 0);
+}
+
+inline void SetNoDelay(const int descriptor)
+{
+    int one = 1;
+    setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+//! Full message, shared by all the queues it is in
+class Message
+{
+public:
+    std::string Type;
+    std::string Device;
+    std::shared_ptr<const std::vector<unsigned char> > Data;
+};
+
+/*! Profile name from a STRING message sent by a client, encoding (16
+  bits), length (16 bits) and string, same as mtsIGTLBridge */
+inline std::string ProfileName(const Message & message)
+{
+    const std::vector<unsigned char> & data = *(message.Data);
+    const size_t bodySize = data.size() - std::min(data.size(), HEADER_SIZE);
+    if (bodySize < 4) {
+        return std::string();
+    }
+    const unsigned char * body = data.data() + HEADER_SIZE;
+    const size_t length = (body[2] << 8) | body[3];
+    return std::string(reinterpret_cast<const char *>(body) + 4,
+                       std::min(length, bodySize - 4));
+}
+
+class Options
+{
+public:
+    std::string Host;
+    int Port = 0;
+    int ListenPort = 0;
+    //! Devices sent to all clients, all if empty
+    std::list<std::string> Devices;
+    //! Devices forwarded from clients to the server
+    std::list<std::string> Upstream;
+    //! Profile name and devices, see -p
+    std::map<std::string, std::list<std::string> > Profiles;
+    //! Messages per second per device and client, 0 for no limit
+    double Rate = 0.0;
+    //! Bytes queued per client, messages are dropped past it
+    size_t MaxQueueSize = 16 * 1024 * 1024;
+};
+
+//! Connection with the server or a client, all I/O is non blocking
+class Peer
+{
+public:
+    int Descriptor = -1;
+    std::string Name;
+
+    //! Data received, Start is the first byte not parsed yet
+    std::vector<unsigned char> Received;
+    size_t Start = 0;
+
+    class Pending {
+    public:
+        std::shared_ptr<const std::vector<unsigned char> > Data;
+        size_t Offset;
+        std::string Device;
+        bool State;
+    };
+    std::deque<Pending> Queue;
+    size_t QueueSize = 0;
+    size_t Dropped = 0;
+
+    //! Devices sent to this client, all if null, see Accepts
+    const std::list<std::string> * Profile = nullptr;
+    std::map<std::string, bool> Accepted;
+
+    //! Rate decimation state per device
+    class Device {
+    public:
+        double Next = 0.0;
+        std::shared_ptr<const std::vector<unsigned char> > Held;
+    };
+    std::map<std::string, Device> Devices;
+
+    void Close(void) {
+        if (Descriptor >= 0) {
+            close(Descriptor);
+        }
+        Descriptor = -1;
+        Received.clear();
+        Start = 0;
+        Queue.clear();
+        QueueSize = 0;
+    }
+
+    //! Read available data, returns false if the connection is lost
+    bool Fill(void) {
+        // reclaim space once more than half is parsed
+        if (Start > Received.size() / 2) {
+            Received.erase(Received.begin(), Received.begin() + Start);
+            Start = 0;
+        }
+        const size_t used = Received.size();
+        Received.resize(used + 64 * 1024);
+        const ssize_t nbBytes = recv(Descriptor, Received.data() + used, 64 * 1024, MSG_DONTWAIT);
+        Received.resize(used + ((nbBytes > 0) ? nbBytes : 0));
+        if (nbBytes == 0) {
+            return false;
+        }
+        if (nbBytes < 0) {
+            return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR);
+        }
+        return true;
+    }
+
+    /*! Extract next complete message, returns false if none.  Sets
+      corrupted if the body size is invalid. */
+    bool Next(Message & message, bool & corrupted) {
+        corrupted = false;
+        const size_t available = Received.size() - Start;
+        if (available < HEADER_SIZE) {
+            return false;
+        }
+        const unsigned char * header = Received.data() + Start;
+        unsigned long long bodySize = 0;
+        for (size_t byte = 0; byte < 8; ++byte) {
+            bodySize = (bodySize << 8) | header[BODY_SIZE_OFFSET + byte];
+        }
+        if (bodySize > MAXIMUM_BODY_SIZE) {
+            corrupted = true;
+            return false;
+        }
+        if (available < HEADER_SIZE + bodySize) {
+            return false;
+        }
+        const char * type = reinterpret_cast<const char *>(header + TYPE_OFFSET);
+        const char * name = reinterpret_cast<const char *>(header + NAME_OFFSET);
+        message.Type.assign(type, strnlen(type, TYPE_SIZE));
+        message.Device.assign(name, strnlen(name, NAME_SIZE));
+        message.Data = std::make_shared<const std::vector<unsigned char> >(header, header + HEADER_SIZE + bodySize);
+        Start += HEADER_SIZE + bodySize;
+        return true;
+    }
+
+    bool Accepts(const std::string & device) {
+        if (!Profile) {
+            return true;
+        }
+        auto accepted = Accepted.find(device);
+        if (accepted == Accepted.end()) {
+            accepted = Accepted.insert(std::make_pair(device, MatchAny(*Profile, device))).first;
+        }
+        return accepted->second;
+    }
+
+    /*! Queue state, replaces an older state for the same device not
+      started */
+    void Enqueue(const std::shared_ptr<const std::vector<unsigned char> > & data,
+                 const std::string & device, const size_t maxQueueSize) {
+        for (auto & pending : Queue) {
+            if (pending.State && (pending.Offset == 0) && (pending.Device == device)) {
+                QueueSize = QueueSize - pending.Data->size() + data->size();
+                pending.Data = data;
+                return;
+            }
+        }
+        Append(data, device, maxQueueSize, true);
+    }
+
+    /*! Queue message after all others, dropped if the queue is full.
+      Used for events (STRING) and commands forwarded to the server,
+      they are all sent in order. */
+    void Append(const std::shared_ptr<const std::vector<unsigned char> > & data,
+                const std::string & device, const size_t maxQueueSize,
+                const bool state = false) {
+        if (QueueSize + data->size() > maxQueueSize) {
+            ++Dropped;
+            return;
+        }
+        Queue.push_back({data, 0, device, state});
+        QueueSize += data->size();
+    }
+
+    /*! Queue message for a client based on profile and rate.  STRING
+      messages are events, they are neither decimated nor replaced. */
+    void Offer(const Message & message, const double & now, const Options & options) {
+        if (!Accepts(message.Device)) {
+            return;
+        }
+        if (message.Type == "STRING") {
+            Append(message.Data, message.Device, options.MaxQueueSize);
+            return;
+        }
+        if (options.Rate > 0.0) {
+            Device & device = Devices[message.Device];
+            if (now < device.Next) {
+                // keep latest, sent by Release
+                device.Held = message.Data;
+                return;
+            }
+            device.Next = now + 1.0 / options.Rate;
+            // an older held message would be sent after this one
+            device.Held.reset();
+        }
+        Enqueue(message.Data, message.Device, options.MaxQueueSize);
+    }
+
+    //! Queue messages held by decimation if due, returns time of next due message or 0
+    double Release(const double & now, const Options & options) {
+        double next = 0.0;
+        for (auto & device : Devices) {
+            if (!device.second.Held) {
+                continue;
+            }
+            if (now >= device.second.Next) {
+                Enqueue(device.second.Held, device.first, options.MaxQueueSize);
+                device.second.Held.reset();
+                device.second.Next = now + 1.0 / options.Rate;
+            } else if ((next == 0.0) || (device.second.Next < next)) {
+                next = device.second.Next;
+            }
+        }
+        return next;
+    }
+
+    //! Send as much as possible, returns false if the connection is lost
+    bool Flush(void) {
+        while (!Queue.empty()) {
+            Pending & pending = Queue.front();
+            const ssize_t sent = send(Descriptor, pending.Data->data() + pending.Offset,
+                                      pending.Data->size() - pending.Offset, SEND_FLAGS);
+            if (sent < 0) {
+                return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR);
+            }
+            pending.Offset += static_cast<size_t>(sent);
+            if (pending.Offset < pending.Data->size()) {
+                return true;
+            }
+            QueueSize -= pending.Data->size();
+            Queue.pop_front();
+        }
+        return true;
+    }
+};
+
+/*! Connection with the server, reconnects with backoff without
+  blocking.  Same rules as mtsIGTLTCPConnector: the host is resolved
+  before each attempt (e.g. server restarted with a new address),
+  addresses are used in turn and an attempt without answer is
+  abandoned after ConnectTimeout. */
+class Upstream: public Peer
+{
+public:
+    std::string Host;
+    int Port = 0;
+    //! Resolved address for the attempt in progress, sockaddr_in or sockaddr_in6
+    std::vector<unsigned char> Address;
+    //! Failed attempts, used to pick one of the addresses
+    size_t Attempts = 0;
+    bool Connected = false;
+    double AttemptStart = 0.0;
+    //! Seconds before an attempt in progress is abandoned, 0 to wait forever
+    double ConnectTimeout = 2.0;
+    double NextAttempt = 0.0;
+    double Delay = 0.1;
+    //! Commands from clients dropped while not connected, see Forward
+    size_t DroppedDisconnected = 0;
+
+    //! Host and port, resolved before each attempt
+    void Create(const std::string & host, const int port) {
+        Host = host;
+        Port = port;
+        Name = ((host.find(':') == std::string::npos) ? host : ("[" + host + "]"))
+            + ":" + std::to_string(port);
+        Attempts = 0;
+    }
+
+    //! Resolve host into Address, next address after each failed attempt
+    bool Resolve(void) {
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo * result = nullptr;
+        if ((getaddrinfo(Host.c_str(), std::to_string(Port).c_str(), &hints, &result) != 0)
+            || !result) {
+            return false;
+        }
+        // e.g. localhost resolves to ::1 and 127.0.0.1, use them in turn
+        size_t nbAddresses = 0;
+        for (const struct addrinfo * info = result; info; info = info->ai_next) {
+            ++nbAddresses;
+        }
+        const struct addrinfo * info = result;
+        for (size_t index = Attempts % nbAddresses; index > 0; --index) {
+            info = info->ai_next;
+        }
+        const unsigned char * address = reinterpret_cast<const unsigned char *>(info->ai_addr);
+        Address.assign(address, address + info->ai_addrlen);
+        freeaddrinfo(result);
+        return true;
+    }
+
+    /*! Start a connection if none and the delay is over, abandon the
+      attempt in progress after ConnectTimeout */
+    void Connect(const double & now) {
+        if (Descriptor >= 0) {
+            if (!Connected && (ConnectTimeout > 0.0)
+                && ((now - AttemptStart) >= ConnectTimeout)) {
+                // no answer, e.g. packets dropped by a firewall
+                Retry(now);
+            }
+            return;
+        }
+        if (now < NextAttempt) {
+            return;
+        }
+        // the server address might have changed since last attempt
+        if (!Resolve()) {
+            Retry(now);
+            return;
+        }
+        const struct sockaddr * address = reinterpret_cast<const struct sockaddr *>(Address.data());
+        Descriptor = socket(address->sa_family, SOCK_STREAM, 0);
+        if ((Descriptor < 0) || !SetNonBlocking(Descriptor)) {
+            Retry(now);
+            return;
+        }
+        AttemptStart = now;
+        if ((connect(Descriptor, address, static_cast<socklen_t>(Address.size())) != 0)
+            && (errno != EINPROGRESS)) {
+            Retry(now);
+        }
+    }
+
+    //! Called when writable while connecting
+    void Connecting(const double & now) {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if ((getsockopt(Descriptor, SOL_SOCKET, SO_ERROR, &error, &length) != 0) || (error != 0)) {
+            Retry(now);
+            return;
+        }
+        SetNoDelay(Descriptor);
+        Connected = true;
+        Delay = 0.1;
+        std::cerr << "Connected to server " << Name << std::endl;
+        if (DroppedDisconnected > 0) {
+            std::cerr << "Dropped " << DroppedDisconnected
+                      << " command(s) from clients while not connected" << std::endl;
+            DroppedDisconnected = 0;
+        }
+    }
+
+    /*! Queue command from a client, see Append.  Commands are not kept
+      while the server is not connected, they would be executed late
+      (e.g. robot motion), they are counted and reported instead. */
+    void Forward(const Message & message, const size_t maxQueueSize) {
+        if (!Connected) {
+            if (DroppedDisconnected == 0) {
+                std::cerr << "Server " << Name << " not connected, dropping commands from clients" << std::endl;
+            }
+            ++DroppedDisconnected;
+            return;
+        }
+        Append(message.Data, message.Device, maxQueueSize);
+    }
+
+    void Retry(const double & now) {
+        if (Connected) {
+            std::cerr << "Lost connection with server " << Name << std::endl;
+        }
+        Close();
+        Connected = false;
+        ++Attempts;
+        NextAttempt = now + Delay;
+        Delay = std::min(2.0 * Delay, 5.0);
+    }
+};
+
+#endif // _igtl_relay_h
@@ -0,0 +1,216 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+/*
+
+  Author(s):  Anton Deguet
+  Created on: 2026-10-19
+
+  (C) Copyright 2026 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// queues and rate decimation of igtl_relay, see igtl_relay.h
+
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "igtl_relay.h"
+#include "sawOpenIGTLinkTests.h"
+
+static Message MakeMessage(const std::string & device, const unsigned char value,
+                           const std::string & type = "SENSOR")
+{
+    std::vector<unsigned char> data(HEADER_SIZE + 4, 0);
+    memcpy(data.data() + TYPE_OFFSET, type.data(), type.size());
+    memcpy(data.data() + NAME_OFFSET, device.data(), device.size());
+    data[BODY_SIZE_OFFSET + 7] = 4;
+    data[HEADER_SIZE] = value;
+    Message message;
+    message.Type = type;
+    message.Device = device;
+    message.Data = std::make_shared<const std::vector<unsigned char> >(data);
+    return message;
+}
+
+// first body byte of each message queued
+static std::vector<unsigned char> Values(const Peer & peer)
+{
+    std::vector<unsigned char> values;
+    for (auto & pending : peer.Queue) {
+        values.push_back((*pending.Data)[HEADER_SIZE]);
+    }
+    return values;
+}
+
+int main(void)
+{
+    Options options;
+    options.Rate = 10.0;
+    const size_t messageSize = HEADER_SIZE + 4;
+
+    // a message held by decimation is dropped when a newer one is sent
+    {
+        Peer client;
+        client.Offer(MakeMessage("a", 1), 0.0, options);
+        client.Offer(MakeMessage("a", 2), 0.05, options);
+        SAW_IGTL_CHECK(Values(client) == std::vector<unsigned char>(1, 1));
+        client.Queue.clear();
+        client.QueueSize = 0;
+        client.Offer(MakeMessage("a", 3), 0.2, options);
+        SAW_IGTL_CHECK(client.Release(0.35, options) == 0.0);
+        SAW_IGTL_CHECK(Values(client) == std::vector<unsigned char>(1, 3));
+    }
+
+    // held message is sent once the period is over
+    {
+        Peer client;
+        client.Offer(MakeMessage("a", 1), 0.0, options);
+        client.Offer(MakeMessage("a", 2), 0.05, options);
+        client.Queue.clear();
+        client.QueueSize = 0;
+        SAW_IGTL_CHECK(client.Release(0.06, options) == 0.1);
+        SAW_IGTL_CHECK(client.Release(0.1, options) == 0.0);
+        SAW_IGTL_CHECK(Values(client) == std::vector<unsigned char>(1, 2));
+    }
+
+    // clients only keep the latest message per device not started
+    {
+        Peer client;
+        client.Enqueue(MakeMessage("a", 1).Data, "a", 10 * messageSize);
+        client.Enqueue(MakeMessage("b", 2).Data, "b", 10 * messageSize);
+        client.Enqueue(MakeMessage("a", 3).Data, "a", 10 * messageSize);
+        std::vector<unsigned char> expected = {3, 2};
+        SAW_IGTL_CHECK(Values(client) == expected);
+        SAW_IGTL_CHECK(client.QueueSize == 2 * messageSize);
+    }
+
+    // STRING messages are events, all queued in order without
+    // decimation while state is replaced
+    {
+        Peer client;
+        client.Offer(MakeMessage("a", 1), 0.0, options);
+        client.Offer(MakeMessage("e", 2, "STRING"), 0.01, options);
+        client.Offer(MakeMessage("e", 3, "STRING"), 0.02, options);
+        client.Offer(MakeMessage("a", 4), 0.03, options);
+        SAW_IGTL_CHECK(client.Release(0.1, options) == 0.0);
+        std::vector<unsigned char> expected = {4, 2, 3};
+        SAW_IGTL_CHECK(Values(client) == expected);
+    }
+
+    // commands to the server are all sent in order, dropped past the byte cap
+    {
+        Peer upstream;
+        upstream.Append(MakeMessage("a", 1).Data, "a", 3 * messageSize);
+        upstream.Append(MakeMessage("a", 2).Data, "a", 3 * messageSize);
+        upstream.Append(MakeMessage("b", 3).Data, "b", 3 * messageSize);
+        upstream.Append(MakeMessage("a", 4).Data, "a", 3 * messageSize);
+        std::vector<unsigned char> expected = {1, 2, 3};
+        SAW_IGTL_CHECK(Values(upstream) == expected);
+        SAW_IGTL_CHECK(upstream.Dropped == 1);
+
+        // sent and parsed on the other end in the same order
+        int descriptors[2];
+        SAW_IGTL_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, descriptors) == 0);
+        upstream.Descriptor = descriptors[0];
+        Peer server;
+        server.Descriptor = descriptors[1];
+        SAW_IGTL_CHECK(upstream.Flush());
+        SAW_IGTL_CHECK(upstream.Queue.empty() && (upstream.QueueSize == 0));
+        SAW_IGTL_CHECK(server.Fill());
+        Message message;
+        bool corrupted;
+        std::vector<unsigned char> received;
+        while (server.Next(message, corrupted)) {
+            SAW_IGTL_CHECK(message.Type == "SENSOR");
+            received.push_back((*message.Data)[HEADER_SIZE]);
+        }
+        SAW_IGTL_CHECK(!corrupted);
+        SAW_IGTL_CHECK(received == expected);
+        upstream.Close();
+        server.Close();
+    }
+
+    // commands from clients are counted, not queued, while the server
+    // is not connected
+    {
+        Upstream upstream;
+        upstream.Forward(MakeMessage("a", 1), 10 * messageSize);
+        upstream.Forward(MakeMessage("a", 2), 10 * messageSize);
+        SAW_IGTL_CHECK(upstream.Queue.empty());
+        SAW_IGTL_CHECK(upstream.DroppedDisconnected == 2);
+        upstream.Connected = true;
+        upstream.Forward(MakeMessage("a", 3), 10 * messageSize);
+        SAW_IGTL_CHECK(Values(upstream) == std::vector<unsigned char>(1, 3));
+    }
+
+    // profile name uses the STRING length, trailing bytes ignored
+    {
+        Message message = MakeMessage("CLIENT", 0);
+        std::vector<unsigned char> data(*(message.Data));
+        data.resize(HEADER_SIZE + 4);
+        const std::string content = "viz";
+        data[HEADER_SIZE + 3] = static_cast<unsigned char>(content.size());
+        data.insert(data.end(), content.begin(), content.end());
+        data.push_back('\0');
+        message.Data = std::make_shared<const std::vector<unsigned char> >(data);
+        SAW_IGTL_CHECK(ProfileName(message) == "viz");
+        // length past the end of the body
+        data[HEADER_SIZE + 3] = 10;
+        message.Data = std::make_shared<const std::vector<unsigned char> >(data);
+        SAW_IGTL_CHECK(ProfileName(message) == std::string("viz\0", 4));
+        data.resize(HEADER_SIZE + 2);
+        message.Data = std::make_shared<const std::vector<unsigned char> >(data);
+        SAW_IGTL_CHECK(ProfileName(message).empty());
+        SAW_IGTL_CHECK(MatchAny({"arm/measured_*"}, "arm/measured_cp"));
+        SAW_IGTL_CHECK(!MatchAny({"arm/measured_?"}, "arm/measured_cp"));
+    }
+
+    // server connection, resolved before each attempt and abandoned
+    // without answer
+    {
+        Upstream upstream;
+        upstream.Create("::1", 18944);
+        SAW_IGTL_CHECK(upstream.Name == "[::1]:18944");
+        // server listening, attempt never checked for completion
+        const int server = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        SAW_IGTL_CHECK((bind(server, reinterpret_cast<struct sockaddr *>(&address), length) == 0)
+                       && (listen(server, 1) == 0)
+                       && (getsockname(server, reinterpret_cast<struct sockaddr *>(&address), &length) == 0));
+        upstream.Create("127.0.0.1", ntohs(address.sin_port));
+        SAW_IGTL_CHECK(upstream.Resolve());
+        upstream.Connect(10.0);
+        SAW_IGTL_CHECK((upstream.Descriptor >= 0) && (upstream.Attempts == 0));
+        upstream.Connect(11.0);
+        SAW_IGTL_CHECK(upstream.Descriptor >= 0);
+        upstream.Connect(10.0 + upstream.ConnectTimeout);
+        SAW_IGTL_CHECK(upstream.Descriptor < 0);
+        SAW_IGTL_CHECK(upstream.Attempts == 1);
+        close(server);
+        // can't resolve, next attempt after the delay
+        upstream.Create("", 1);
+        const size_t attempts = upstream.Attempts;
+        upstream.Connect(upstream.NextAttempt);
+        SAW_IGTL_CHECK(upstream.Descriptor < 0);
+        SAW_IGTL_CHECK(upstream.Attempts == attempts + 1);
+        SAW_IGTL_CHECK(!upstream.Connected);
+    }
+
+    return SAW_IGTL_TEST_RESULT();
+}
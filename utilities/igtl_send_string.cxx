@@ -16,20 +16,28 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 
 #include "igtlOSUtil.h"
 #include "igtlStringMessage.h"
 #include "igtlClientSocket.h"
 
+#ifndef _WIN32
+#include <sawOpenIGTLink/mtsIGTLUnixSocket.h>
+#endif
+
 int main(int argc, char* argv[])
 {
   //------------------------------------------------------------
   // Parse Arguments
-  if (argc != 5) // check number of arguments
+  // unix:<path> for Unix domain sockets, no port
+  bool unixSocket = (argc > 1) && (strncmp(argv[1], "unix:", 5) == 0);
+  int first = unixSocket ? 2 : 3;
+  if (argc != first + 2) // check number of arguments
     {
     // If not correct, print usage
     std::cerr << "Usage: " << argv[0] << " <hostname> <port> <device-name> <string>" << std::endl
-	      << "    <hostname>    : IP or host name" << std::endl
+	      << "    <hostname>    : IP or host name, unix:<path> for Unix domain socket (no port)" << std::endl
 	      << "    <port>        : Port # (18944 in Slicer default)" << std::endl
 	      << "    <device-name> : Device Name"  << std::endl
 	      << "    <string>      : Message payload" << std::endl;
@@ -37,18 +45,29 @@ int main(int argc, char* argv[])
     }
 
   char*  hostname = argv[1];
-  int    port     = atoi(argv[2]);
-  char*  device   = argv[3];
-  char*  string   = argv[4];
+  int    port     = unixSocket ? 0 : atoi(argv[2]);
+  char*  device   = argv[first];
+  char*  string   = argv[first + 1];
 
   //------------------------------------------------------------
   // Establish Connection
   igtl::ClientSocket::Pointer socket;
-  socket = igtl::ClientSocket::New();
-
-  int r = socket->ConnectToServer(hostname, port);
+#ifndef _WIN32
+  if (unixSocket)
+    {
+    socket = mtsIGTLUnixSocket::Connect(hostname + 5);
+    }
+  else
+#endif
+    {
+    socket = igtl::ClientSocket::New();
+    if (socket->ConnectToServer(hostname, port) != 0)
+      {
+      socket = NULL;
+      }
+    }
 
-  if (r != 0)
+  if (socket.IsNull())
     {
     std::cerr << "Cannot connect to the server." << std::endl;
     exit(0);